@@ -247,6 +247,7 @@ public:
 
 	// AudioStream API
 	int readBuffer(int16 *buffer, const int numSamples);
+	virtual bool isStereo() const = 0;
 	int getRate() const;
 	bool endOfData() const { return false; }
 
@@ -123,9 +123,15 @@ public:
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Queries the information needed to compute how long the channel has
+	 * been playing.
+	 *
+	 * @param samplesConsumed number of samples mixed before the last mix call
+	 * @param mixerTimeStamp  time of the last mix call, 0 if never mixed
+	 * @param pauseStartTime  time the channel got paused, if it is paused
+	 * @param pauseTime       time spent paused since the last mix call
 	 */
-	Timestamp getElapsedTime();
+	void getTiming(uint32 &samplesConsumed, uint32 &mixerTimeStamp, uint32 &pauseStartTime, uint32 &pauseTime) const;
 
 	/**
 	 * Queries the channel's sound type.
@@ -175,15 +181,32 @@ private:
 
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _commandMutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = 0;
+
+		ChannelSnapshot &snapshot = _snapshots[i];
+		snapshot.handle = kInvalidHandle;
+		snapshot.id = -1;
+		snapshot.type = kPlainSoundType;
+		snapshot.volume = 0;
+		snapshot.balance = 0;
+		snapshot.sequence = 0;
+		snapshot.samplesConsumed = 0;
+		snapshot.mixerTimeStamp = 0;
+		snapshot.pauseStartTime = 0;
+		snapshot.pauseTime = 0;
+		snapshot.paused = false;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	// Take over channels which were never picked up by the audio thread
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -196,29 +219,100 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
-void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
-			index = i;
+int MixerImpl::findSlot(SoundHandle handle) const {
+	if (handle._val == kInvalidHandle)
+		return -1;
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (_snapshots[index].handle != handle._val)
+		return -1;
+
+	return index;
+}
+
+void MixerImpl::postCommand(const Command &cmd) {
+	if (_commands.push(cmd))
+		return;
+
+	// The queue is full, either because the audio thread is stalled or
+	// because it is not running at all (e.g. the backend paused audio
+	// output). Drain the queue ourselves, since that is guaranteed to make
+	// progress.
+	Common::StackLock lock(_mutex);
+	processCommands();
+	_commands.push(cmd);
+}
+
+void MixerImpl::processCommands() {
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		Channel *chan = _channels[cmd.index];
+
+		switch (cmd.type) {
+		case Command::kPlay:
+			assert(!chan);
+			_channels[cmd.index] = cmd.channel;
+			break;
+
+		case Command::kPause:
+			if (chan && chan->getHandle()._val == cmd.handle) {
+				chan->pause(cmd.value != 0);
+				updateSnapshot(cmd.index);
+			}
+			break;
+
+		case Command::kPauseAll:
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_channels[i]) {
+					_channels[i]->pause(cmd.value != 0);
+					updateSnapshot(i);
+				}
+			}
+			break;
+
+		case Command::kVolume:
+			if (chan && chan->getHandle()._val == cmd.handle)
+				chan->setVolume(cmd.value);
+			break;
+
+		case Command::kBalance:
+			if (chan && chan->getHandle()._val == cmd.handle)
+				chan->setBalance(cmd.value);
+			break;
+
+		case Command::kSoundTypeChanged:
+			for (int i = 0; i != NUM_CHANNELS; i++) {
+				if (_channels[i] && _channels[i]->getType() == cmd.value)
+					_channels[i]->notifyGlobalVolChange();
+			}
 			break;
 		}
 	}
-	if (index == -1) {
-		warning("MixerImpl::out of mixer slots");
-		delete chan;
-		return;
-	}
+}
 
-	_channels[index] = chan;
+void MixerImpl::deleteChannel(int index) {
+	delete _channels[index];
+	_channels[index] = 0;
 
-	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	// Only hand the slot back to playStream() once the channel is gone.
+	Common::memoryBarrier();
+	_snapshots[index].handle = kInvalidHandle;
+}
 
-	chan->setHandle(chanHandle);
-	_handleSeed++;
-	if (handle)
-		*handle = chanHandle;
+void MixerImpl::updateSnapshot(int index) {
+	ChannelSnapshot &snapshot = _snapshots[index];
+	uint32 samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	_channels[index]->getTiming(samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime);
+
+	snapshot.sequence++;
+	Common::memoryBarrier();
+	snapshot.samplesConsumed = samplesConsumed;
+	snapshot.mixerTimeStamp = mixerTimeStamp;
+	snapshot.pauseStartTime = pauseStartTime;
+	snapshot.pauseTime = pauseTime;
+	snapshot.paused = _channels[index]->isPaused();
+	Common::memoryBarrier();
+	snapshot.sequence++;
 }
 
 void MixerImpl::playStream(
@@ -229,7 +323,7 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
 	if (stream == 0) {
 		warning("stream is 0");
@@ -242,7 +336,7 @@ void MixerImpl::playStream(
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (_snapshots[i].handle != kInvalidHandle && _snapshots[i].id == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -255,6 +349,20 @@ void MixerImpl::playStream(
 			}
 	}
 
+	int index = -1;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (_snapshots[i].handle == kInvalidHandle) {
+			index = i;
+			break;
+		}
+	}
+	if (index == -1) {
+		warning("MixerImpl::out of mixer slots");
+		if (autofreeStream == DisposeAfterUse::YES)
+			delete stream;
+		return;
+	}
+
 #ifdef AUDIO_REVERSE_STEREO
 	reverseStereo = !reverseStereo;
 #endif
@@ -263,7 +371,40 @@ void MixerImpl::playStream(
 	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
-	insertChannel(handle, chan);
+
+	SoundHandle chanHandle;
+	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	chan->setHandle(chanHandle);
+	_handleSeed++;
+
+	// Fill in the snapshot before claiming the slot by setting its handle
+	ChannelSnapshot &snapshot = _snapshots[index];
+	snapshot.id = id;
+	snapshot.type = type;
+	snapshot.volume = volume;
+	snapshot.balance = balance;
+	snapshot.sequence++;
+	Common::memoryBarrier();
+	snapshot.samplesConsumed = 0;
+	snapshot.mixerTimeStamp = 0;
+	snapshot.pauseStartTime = 0;
+	snapshot.pauseTime = 0;
+	snapshot.paused = false;
+	Common::memoryBarrier();
+	snapshot.sequence++;
+	Common::memoryBarrier();
+	snapshot.handle = chanHandle._val;
+
+	Command cmd;
+	cmd.type = Command::kPlay;
+	cmd.index = index;
+	cmd.handle = chanHandle._val;
+	cmd.channel = chan;
+	cmd.value = 0;
+	postCommand(cmd);
+
+	if (handle)
+		*handle = chanHandle;
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
@@ -279,6 +420,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	// apply all state changes posted since the last block
+	processCommands();
+
 	//  zero the buf
 	memset(buf, 0, 2 * len * sizeof(int16));
 
@@ -287,10 +431,10 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
+				deleteChannel(i);
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
+				updateSnapshot(i);
 
 				if (tmp > res)
 					res = tmp;
@@ -302,44 +446,54 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && !_channels[i]->isPermanent())
+			deleteChannel(i);
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	processCommands();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
-		}
+		if (_channels[i] != 0 && _channels[i]->getId() == id)
+			deleteChannel(i);
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
+	// Simply ignore stop requests for handles of sounds that already
+	// terminated. This check avoids waiting for the audio thread when
+	// engines stop sounds which already ended.
+	if (findSlot(handle) == -1)
+		return;
+
 	Common::StackLock lock(_mutex);
+	processCommands();
 
-	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	deleteChannel(index);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_commandMutex);
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Command cmd;
+	cmd.type = Command::kSoundTypeChanged;
+	cmd.index = 0;
+	cmd.handle = kInvalidHandle;
+	cmd.channel = 0;
+	cmd.value = type;
+	postCommand(cmd);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -348,39 +502,55 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setVolume(volume);
+	_snapshots[index].volume = volume;
+
+	Command cmd;
+	cmd.type = Command::kVolume;
+	cmd.index = index;
+	cmd.handle = handle._val;
+	cmd.channel = 0;
+	cmd.value = volume;
+	postCommand(cmd);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _snapshots[index].volume;
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setBalance(balance);
+	_snapshots[index].balance = balance;
+
+	Command cmd;
+	cmd.type = Command::kBalance;
+	cmd.index = index;
+	cmd.handle = handle._val;
+	cmd.channel = 0;
+	cmd.value = balance;
+	postCommand(cmd);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _snapshots[index].balance;
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -388,81 +558,127 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	// Read a consistent copy of the timing information
+	const ChannelSnapshot &snapshot = _snapshots[index];
+	uint32 sequence, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		sequence = snapshot.sequence;
+		Common::memoryBarrier();
+		samplesConsumed = snapshot.samplesConsumed;
+		mixerTimeStamp = snapshot.mixerTimeStamp;
+		pauseStartTime = snapshot.pauseStartTime;
+		pauseTime = snapshot.pauseTime;
+		paused = snapshot.paused;
+		Common::memoryBarrier();
+	} while ((sequence & 1) || sequence != snapshot.sequence);
+
+	uint32 delta = 0;
+
+	Audio::Timestamp ts(0, _sampleRate);
+
+	if (mixerTimeStamp == 0)
+		return ts;
+
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
+	else
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
+
+	// Convert the number of samples into a time duration.
+
+	ts = ts.addFrames(samplesConsumed);
+	ts = ts.addMsecs(delta);
+
+	// In theory it would seem like a good idea to limit the approximation
+	// so that it never exceeds the theoretical upper bound set by
+	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
+	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
+	// isn't invoked at the regular intervals that I first imagined.
+
+	return ts;
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
-		}
-	}
+	Common::StackLock lock(_commandMutex);
+
+	Command cmd;
+	cmd.type = Command::kPauseAll;
+	cmd.index = 0;
+	cmd.handle = kInvalidHandle;
+	cmd.channel = 0;
+	cmd.value = paused;
+	postCommand(cmd);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		const uint32 chanHandle = _snapshots[i].handle;
+		if (chanHandle != kInvalidHandle && _snapshots[i].id == id) {
+			Command cmd;
+			cmd.type = Command::kPause;
+			cmd.index = i;
+			cmd.handle = chanHandle;
+			cmd.channel = 0;
+			cmd.value = paused;
+			postCommand(cmd);
 			return;
 		}
 	}
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findSlot(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->pause(paused);
+	Command cmd;
+	cmd.type = Command::kPause;
+	cmd.index = index;
+	cmd.handle = handle._val;
+	cmd.channel = 0;
+	cmd.value = paused;
+	postCommand(cmd);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (_snapshots[i].handle != kInvalidHandle && _snapshots[i].id == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
-	return 0;
+	const int index = findSlot(handle);
+	if (index == -1)
+		return 0;
+
+	return _snapshots[index].id;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findSlot(handle) != -1;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_snapshots[i].handle != kInvalidHandle && _snapshots[i].type == type)
 			return true;
 	return false;
 }
@@ -476,13 +692,16 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_commandMutex);
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Command cmd;
+	cmd.type = Command::kSoundTypeChanged;
+	cmd.index = 0;
+	cmd.handle = kInvalidHandle;
+	cmd.channel = 0;
+	cmd.value = type;
+	postCommand(cmd);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -576,32 +795,11 @@ void Channel::pause(bool paused) {
 	}
 }
 
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
-	uint32 delta = 0;
-
-	Audio::Timestamp ts(0, rate);
-
-	if (_mixerTimeStamp == 0)
-		return ts;
-
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
-
-	// Convert the number of samples into a time duration.
-
-	ts = ts.addFrames(_samplesConsumed);
-	ts = ts.addMsecs(delta);
-
-	// In theory it would seem like a good idea to limit the approximation
-	// so that it never exceeds the theoretical upper bound set by
-	// _samplesDecoded. Meanwhile, back in the real world, doing so makes
-	// the Broken Sword cutscenes noticeably jerkier. I guess the mixer
-	// isn't invoked at the regular intervals that I first imagined.
-
-	return ts;
+void Channel::getTiming(uint32 &samplesConsumed, uint32 &mixerTimeStamp, uint32 &pauseStartTime, uint32 &pauseTime) const {
+	samplesConsumed = _samplesConsumed;
+	mixerTimeStamp = _mixerTimeStamp;
+	pauseStartTime = _pauseStartTime;
+	pauseTime = _pauseTime;
 }
 
 int Channel::mix(int16 *data, uint len) {
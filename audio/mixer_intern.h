@@ -25,6 +25,7 @@
 
 #include "common/scummsys.h"
 #include "common/mutex.h"
+#include "common/spscqueue.h"
 #include "audio/mixer.h"
 
 namespace Audio {
@@ -42,6 +43,15 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * The audio thread owns the channels. Engine threads do not touch them
+ * directly: new sounds and state changes like volume, balance or pausing
+ * are posted to a wait-free command queue, which the audio thread applies
+ * at the start of each mixing block. Queries are answered from per-channel
+ * snapshots the two sides keep up to date, so neither polling a sound nor
+ * changing its volume has to wait for a mixing block to finish. Only
+ * stopping sounds still synchronizes with the audio thread, as callers may
+ * free the data of a stream right after stopping it.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -51,10 +61,71 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 256
+	};
+
+	enum {
+		kInvalidHandle = 0xFFFFFFFF
+	};
+
+	/**
+	 * A state change posted by an engine thread, to be applied by the
+	 * audio thread.
+	 */
+	struct Command {
+		enum Type {
+			kPlay,
+			kPause,
+			kPauseAll,
+			kVolume,
+			kBalance,
+			kSoundTypeChanged
+		};
+
+		Type type;
+		/** slot the command applies to */
+		int index;
+		/** handle the slot must still have for the command to apply */
+		uint32 handle;
+		/** the new channel for kPlay */
+		Channel *channel;
+		/** pause flag, volume, balance or sound type */
+		int value;
 	};
 
+	/**
+	 * Lock-free view of a channel slot, used to answer queries.
+	 *
+	 * The handle is set by the engine side when the slot is claimed by
+	 * playStream() and reset to kInvalidHandle by whoever deletes the
+	 * channel. The timing fields are written by the audio thread only and
+	 * are read using the sequence counter: it is odd while an update is in
+	 * progress, and readers retry when it changed while they were reading.
+	 */
+	struct ChannelSnapshot {
+		volatile uint32 handle;
+		volatile int id;
+		volatile int type;
+		volatile byte volume;
+		volatile int8 balance;
+
+		volatile uint32 sequence;
+		volatile uint32 samplesConsumed;
+		volatile uint32 mixerTimeStamp;
+		volatile uint32 pauseStartTime;
+		volatile uint32 pauseTime;
+		volatile bool paused;
+	};
+
+	/**
+	 * Held by the audio thread while mixing, and by anyone else that needs
+	 * to access the channels directly. Whoever holds it is the consumer of
+	 * the command queue.
+	 */
 	Common::Mutex _mutex;
+	/** Serializes engine side threads posting commands and claiming slots. */
+	Common::Mutex _commandMutex;
 
 	const uint _sampleRate;
 	bool _mixerReady;
@@ -63,12 +134,14 @@ private:
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
-		bool mute;
-		int volume;
+		volatile bool mute;
+		volatile int volume;
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
+	ChannelSnapshot _snapshots[NUM_CHANNELS];
+	Common::SPSCQueue<Command, COMMAND_QUEUE_SIZE> _commands;
 
 
 public:
@@ -119,7 +192,34 @@ public:
 	virtual uint getOutputRate() const;
 
 protected:
-	void insertChannel(SoundHandle *handle, Channel *chan);
+	/**
+	 * Find the slot currently used by the given handle.
+	 * @return the slot index, or -1 if the handle is not active.
+	 */
+	int findSlot(SoundHandle handle) const;
+
+	/**
+	 * Post a command for the audio thread. Must be called with
+	 * _commandMutex held.
+	 */
+	void postCommand(const Command &cmd);
+
+	/**
+	 * Apply all pending commands. Must be called with _mutex held.
+	 */
+	void processCommands();
+
+	/**
+	 * Delete the channel in the given slot and release the slot. Must be
+	 * called with _mutex held.
+	 */
+	void deleteChannel(int index);
+
+	/**
+	 * Publish the timing information of the channel in the given slot to
+	 * its snapshot. Must be called with _mutex held.
+	 */
+	void updateSnapshot(int index);
 
 public:
 	/**
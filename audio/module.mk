@@ -53,6 +53,7 @@ MODULE_OBJS := \
 	softsynth/fmtowns_pc98/towns_pc98_fmsynth.o \
 	softsynth/fmtowns_pc98/towns_pc98_plugins.o \
 	softsynth/appleiigs.o \
+	softsynth/emumidi.o \
 	softsynth/fluidsynth.o \
 	softsynth/mt32.o \
 	softsynth/eas.o \
@@ -35,6 +35,25 @@
 #include "common/textconsole.h"
 #include "common/util.h"
 
+// 32 bit x86 builds usually target CPUs without SSE2. They compile the SSE2
+// kernels through a function attribute, and only use them when the CPU
+// supports SSE2.
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#if defined(__SSE2__)
+#define AUDIO_RATE_SSE2
+#define AUDIO_RATE_SSE2_TARGET
+#include <emmintrin.h>
+#elif defined(__i386__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define AUDIO_RATE_SSE2
+#define AUDIO_RATE_SSE2_TARGET __attribute__((target("sse2")))
+#define AUDIO_RATE_SSE2_RUNTIME_CHECK
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define AUDIO_RATE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 namespace Audio {
 
 
@@ -57,6 +76,226 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Maximal number of output sample pairs the converters gather before
+ * handing them to the mixing kernels below.
+ */
+enum {
+	MIX_BLOCK_FRAMES = INTERMEDIATE_BUFFER_SIZE / 2
+};
+
+#pragma mark -
+
+#ifdef AUDIO_RATE_SSE2
+
+/**
+ * Whether the CPU supports SSE2. It is only checked on first use, and the
+ * result is the same for every caller.
+ */
+static bool haveSSE2() {
+#ifdef AUDIO_RATE_SSE2_RUNTIME_CHECK
+	static int supported = -1;
+	if (supported < 0) {
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("sse2") ? 1 : 0;
+	}
+	return supported != 0;
+#else
+	return true;
+#endif
+}
+
+/**
+ * SSE2 part of mixSamples.
+ * @return the number of sample pairs mixed, a multiple of four
+ */
+template<bool stereo, bool reverseStereo>
+AUDIO_RATE_SSE2_TARGET static st_size_t mixSamplesSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const st_size_t total = frames;
+	// kMaxMixerVolume is 256, so the volumes fit into signed 16 bit lanes.
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+	const __m128i roundMask = _mm_set1_epi32(Audio::Mixer::kMaxMixerVolume - 1);
+
+	for (; frames >= 4; frames -= 4) {
+		__m128i in;
+		if (stereo) {
+			in = _mm_loadu_si128((const __m128i *)ibuf);
+			ibuf += 8;
+		} else {
+			in = _mm_loadl_epi64((const __m128i *)ibuf);
+			in = _mm_unpacklo_epi16(in, in);
+			ibuf += 4;
+		}
+
+		// Compute the 32 bit products sample * volume
+		const __m128i lo = _mm_mullo_epi16(in, vol);
+		const __m128i hi = _mm_mulhi_epi16(in, vol);
+		__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+		// Divide by kMaxMixerVolume, rounding towards zero like the C code
+		p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), roundMask)), 8);
+		p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), roundMask)), 8);
+
+		__m128i out = _mm_packs_epi32(p0, p1);
+		if (reverseStereo) {
+			out = _mm_shufflelo_epi16(out, _MM_SHUFFLE(2, 3, 0, 1));
+			out = _mm_shufflehi_epi16(out, _MM_SHUFFLE(2, 3, 0, 1));
+		}
+
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(_mm_loadu_si128((const __m128i *)obuf), out));
+		obuf += 8;
+	}
+
+	return total - frames;
+}
+
+#endif // AUDIO_RATE_SSE2
+
+/**
+ * Scale 'frames' sample pairs from ibuf by the given volumes and mix them
+ * into obuf, saturating the result. For mono input, ibuf holds one sample
+ * per pair which is used for both output channels.
+ *
+ * This is the vectorized equivalent of calling clampedAdd for each output
+ * sample and produces exactly the same results.
+ */
+template<bool stereo, bool reverseStereo>
+static void mixSamples(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+#if defined(AUDIO_RATE_SSE2)
+	if (haveSSE2()) {
+		const st_size_t mixed = mixSamplesSSE2<stereo, reverseStereo>(obuf, ibuf, frames, vol_l, vol_r);
+		obuf += mixed * 2;
+		ibuf += mixed * (stereo ? 2 : 1);
+		frames -= mixed;
+	}
+#elif defined(AUDIO_RATE_NEON)
+	const int16 volArray[4] = { (int16)vol_l, (int16)vol_r, (int16)vol_l, (int16)vol_r };
+	const int16x4_t vol = vld1_s16(volArray);
+
+	for (; frames >= 4; frames -= 4) {
+		int16x8_t in;
+		if (stereo) {
+			in = vld1q_s16(ibuf);
+			ibuf += 8;
+		} else {
+			const int16x4_t mono = vld1_s16(ibuf);
+			const int16x4x2_t dup = vzip_s16(mono, mono);
+			in = vcombine_s16(dup.val[0], dup.val[1]);
+			ibuf += 4;
+		}
+
+		int32x4_t p0 = vmull_s16(vget_low_s16(in), vol);
+		int32x4_t p1 = vmull_s16(vget_high_s16(in), vol);
+
+		// Divide by kMaxMixerVolume, rounding towards zero like the C code
+		p0 = vshrq_n_s32(vaddq_s32(p0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p0, 31)), 24))), 8);
+		p1 = vshrq_n_s32(vaddq_s32(p1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p1, 31)), 24))), 8);
+
+		int16x8_t out = vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1));
+		if (reverseStereo)
+			out = vrev32q_s16(out);
+
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), out));
+		obuf += 8;
+	}
+#endif
+
+	for (; frames > 0; --frames) {
+		st_sample_t out0, out1;
+		out0 = *ibuf++;
+		out1 = (stereo ? *ibuf++ : out0);
+
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+	}
+}
+
+#ifdef AUDIO_RATE_SSE2
+
+/**
+ * SSE2 part of interpolateSamples.
+ * @return the number of samples interpolated, a multiple of eight
+ */
+AUDIO_RATE_SSE2_TARGET static st_size_t interpolateSamplesSSE2(st_sample_t *out, const st_sample_t *ends, const int16 *weights, st_size_t count) {
+	const st_size_t total = count;
+	const __m128i half = _mm_set1_epi32(FRAC_HALF_LOW);
+
+	for (; count >= 8; count -= 8) {
+		const __m128i e0 = _mm_loadu_si128((const __m128i *)ends);
+		const __m128i e1 = _mm_loadu_si128((const __m128i *)(ends + 8));
+		const __m128i w0 = _mm_loadu_si128((const __m128i *)weights);
+		const __m128i w1 = _mm_loadu_si128((const __m128i *)(weights + 8));
+
+		__m128i r0 = _mm_add_epi32(_mm_madd_epi16(e0, w0), _mm_slli_epi32(_mm_srai_epi32(e0, 16), FRAC_BITS_LOW));
+		__m128i r1 = _mm_add_epi32(_mm_madd_epi16(e1, w1), _mm_slli_epi32(_mm_srai_epi32(e1, 16), FRAC_BITS_LOW));
+		r0 = _mm_srai_epi32(_mm_add_epi32(r0, half), FRAC_BITS_LOW);
+		r1 = _mm_srai_epi32(_mm_add_epi32(r1, half), FRAC_BITS_LOW);
+
+		_mm_storeu_si128((__m128i *)out, _mm_packs_epi32(r0, r1));
+		ends += 16;
+		weights += 16;
+		out += 8;
+	}
+
+	return total - count;
+}
+
+#endif // AUDIO_RATE_SSE2
+
+/**
+ * Linearly interpolate 'count' samples. For every output sample, ends holds
+ * the pair (current, last) input sample and weights holds the pair
+ * (opos, -opos), opos being the fractional position between the two.
+ *
+ * The result is last + (((current - last) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW),
+ * which we compute as (last * FRAC_ONE_LOW + current * opos - last * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW
+ * so that the products can be formed with a single multiply-add.
+ */
+static void interpolateSamples(st_sample_t *out, const st_sample_t *ends, const int16 *weights, st_size_t count) {
+#if defined(AUDIO_RATE_SSE2)
+	if (haveSSE2()) {
+		const st_size_t done = interpolateSamplesSSE2(out, ends, weights, count);
+		out += done;
+		ends += done * 2;
+		weights += done * 2;
+		count -= done;
+	}
+#elif defined(AUDIO_RATE_NEON)
+	const int32x4_t half = vdupq_n_s32(FRAC_HALF_LOW);
+
+	for (; count >= 4; count -= 4) {
+		const int16x4x2_t e = vld2_s16(ends);
+		const int16x4x2_t w = vld2_s16(weights);
+
+		int32x4_t r = vshlq_n_s32(vmovl_s16(e.val[1]), FRAC_BITS_LOW);
+		r = vmlal_s16(r, e.val[0], w.val[0]);
+		r = vmlal_s16(r, e.val[1], w.val[1]);
+		r = vshrq_n_s32(vaddq_s32(r, half), FRAC_BITS_LOW);
+
+		vst1_s16(out, vmovn_s32(r));
+		ends += 8;
+		weights += 8;
+		out += 4;
+	}
+#endif
+
+	for (; count > 0; --count) {
+		const int cur = ends[0];
+		const int last = ends[1];
+		*out++ = (st_sample_t)(last + (((cur - last) * weights[0] + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+		ends += 2;
+		weights += 2;
+	}
+}
+
+#pragma mark -
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -77,6 +316,9 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	/** picked input samples waiting to be mixed into the output */
+	st_sample_t outBuf[MIX_BLOCK_FRAMES * 2];
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -119,37 +361,46 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / 2, MIX_BLOCK_FRAMES);
+		st_sample_t *outPtr = outBuf;
+		st_size_t frames;
+		bool endOfInput = false;
+
+		for (frames = 0; frames < maxFrames; ++frames) {
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (endOfInput)
+				break;
+
+			*outPtr++ = *inPtr++;
+			if (stereo)
+				*outPtr++ = *inPtr++;
 
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
-
-		// Increment output position
-		opos += opos_inc;
-
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+			// Increment output position
+			opos += opos_inc;
+		}
 
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		mixSamples<stereo, reverseStereo>(obuf, outBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
 
-		obuf += 2;
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -183,6 +434,13 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** (current, last) input sample pairs of the pending output samples */
+	st_sample_t ends[MIX_BLOCK_FRAMES * 4];
+	/** (opos, -opos) interpolation weights of the pending output samples */
+	int16 weights[MIX_BLOCK_FRAMES * 4];
+	/** interpolated samples waiting to be mixed into the output */
+	st_sample_t outBuf[MIX_BLOCK_FRAMES * 2];
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -228,47 +486,65 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	oend = obuf + osamp * 2;
 
 	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE_LOW <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+		// Gather the interpolation input for up to one block of output
+		// samples, then interpolate and mix the whole block at once.
+		const st_size_t maxFrames = MIN<st_size_t>((oend - obuf) / 2, MIX_BLOCK_FRAMES);
+		st_sample_t *endPtr = ends;
+		int16 *weightPtr = weights;
+		st_size_t frames = 0;
+		bool endOfInput = false;
+
+		while (frames < maxFrames) {
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE_LOW <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						endOfInput = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE_LOW;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			if (endOfInput)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the output block.
+			while (opos < (frac_t)FRAC_ONE_LOW && frames < maxFrames) {
+				*endPtr++ = icur0;
+				*endPtr++ = ilast0;
+				*weightPtr++ = (int16)opos;
+				*weightPtr++ = (int16)-opos;
+				if (stereo) {
+					*endPtr++ = icur1;
+					*endPtr++ = ilast1;
+					*weightPtr++ = (int16)opos;
+					*weightPtr++ = (int16)-opos;
+				}
+				++frames;
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE_LOW;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE_LOW && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
-						  out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		interpolateSamples(outBuf, ends, weights, frames * (stereo ? 2 : 1));
+		mixSamples<stereo, reverseStereo>(obuf, outBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
 
-			obuf += 2;
-
-			// Increment output position
-			opos += opos_inc;
-		}
+		if (endOfInput)
+			break;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -293,11 +569,8 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -315,21 +588,9 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+		len = stereo ? len / 2 : len;
+		mixSamples<stereo, reverseStereo>(obuf, _buffer, len, vol_l, vol_r);
+		return len;
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -0,0 +1,292 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/softsynth/emumidi.h"
+
+#include "common/array.h"
+#include "common/config-manager.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+static Common::Array<MidiDriver_Emulated *> s_renderAheadDrivers;
+
+int MidiDriver_Emulated::readBuffer(int16 *data, const int numSamples) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+	int len = numSamples / stereoFactor;
+	int step;
+
+	do {
+		step = len;
+		if (step > (_nextTick >> FIXP_SHIFT))
+			step = (_nextTick >> FIXP_SHIFT);
+
+		if (_renderAheadBlocks)
+			readRenderedAhead(data, step);
+		else
+			generateSamples(data, step);
+
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			if (_timerProc)
+				(*_timerProc)(_timerParam);
+
+			onTimer();
+
+			_nextTick += _samplesPerTick;
+		}
+
+		data += step * stereoFactor;
+		len -= step;
+	} while (len);
+
+	return numSamples;
+}
+
+void MidiDriver_Emulated::readRenderedAhead(int16 *data, int len) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+	const int blockSamples = kRenderAheadBlockFrames * stereoFactor;
+	int16 *end = data + len * stereoFactor;
+
+	while (data < end) {
+		if (_renderAheadBlock < 0) {
+			uint block;
+			if (!_renderAheadQueue.pop(block)) {
+				// Nothing was rendered in time. Render the rest ourselves,
+				// once the timer thread is done with the block it may be
+				// working on.
+				Common::StackLock lock(_renderAheadMutex);
+				if (!_renderAheadQueue.pop(block)) {
+					renderQueuedEvents(data, (end - data) / stereoFactor);
+					break;
+				}
+			}
+
+			_renderAheadBlock = block;
+			_renderAheadPos = 0;
+		}
+
+		const int count = MIN<int>(end - data, blockSamples - _renderAheadPos);
+		memcpy(data, _renderAheadBuffer + _renderAheadBlock * blockSamples + _renderAheadPos, count * sizeof(int16));
+		data += count;
+		_renderAheadPos += count;
+
+		if (_renderAheadPos == blockSamples) {
+			_renderAheadFree.push(_renderAheadBlock);
+			_renderAheadBlock = -1;
+		}
+	}
+
+	Common::StackLock lock(_renderAheadEventMutex);
+	_renderAheadPlayFrame += len;
+}
+
+void MidiDriver_Emulated::renderQueuedEvents(int16 *data, int len) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+
+	while (len > 0) {
+		int step = len;
+
+		RenderAheadEvent event;
+		while (_renderAheadEvents.peek(event)) {
+			const int32 wait = (int32)(event.frame - _renderAheadSynthFrame);
+			if (wait > 0) {
+				step = MIN<int>(step, wait);
+				break;
+			}
+			playQueuedEvent();
+		}
+
+		generateSamples(data, step);
+		_renderAheadSynthFrame += step;
+
+		data += step * stereoFactor;
+		len -= step;
+	}
+}
+
+void MidiDriver_Emulated::playQueuedEvent() {
+	RenderAheadEvent event;
+	if (!_renderAheadEvents.pop(event))
+		return;
+
+	if (!event.sysExLength) {
+		playEvent(event.message);
+		return;
+	}
+
+	byte msg[kMaxRenderAheadSysExLength];
+	for (uint16 i = 0; i < event.sysExLength; i++)
+		_renderAheadSysEx.pop(msg[i]);
+	playSysEx(msg, event.sysExLength);
+}
+
+void MidiDriver_Emulated::flushQueuedEvents() {
+	Common::StackLock lock(_renderAheadMutex);
+	while (!_renderAheadEvents.empty())
+		playQueuedEvent();
+}
+
+bool MidiDriver_Emulated::queueEvent(uint32 b) {
+	if (!_renderAheadBlocks)
+		return false;
+
+	Common::StackLock lock(_renderAheadEventMutex);
+
+	// The synthesizer is never more than the latency ahead of the mixer,
+	// so the event is not late when it gets there.
+	RenderAheadEvent event;
+	event.frame = _renderAheadPlayFrame + (_renderAheadBlocks + 1) * kRenderAheadBlockFrames;
+	event.message = b;
+	event.sysExLength = 0;
+	if (_renderAheadEvents.push(event))
+		return true;
+
+	// The queue is full, so play this event right away, after those before
+	flushQueuedEvents();
+	return false;
+}
+
+bool MidiDriver_Emulated::queueSysEx(const byte *msg, uint16 length) {
+	if (!_renderAheadBlocks)
+		return false;
+
+	Common::StackLock lock(_renderAheadEventMutex);
+
+	RenderAheadEvent event;
+	event.frame = _renderAheadPlayFrame + (_renderAheadBlocks + 1) * kRenderAheadBlockFrames;
+	event.message = 0;
+	event.sysExLength = length;
+	if (length && length <= kMaxRenderAheadSysExLength && !_renderAheadEvents.full() &&
+	    kRenderAheadSysExSize - _renderAheadSysEx.size() >= length) {
+		for (uint16 i = 0; i < length; i++)
+			_renderAheadSysEx.push(msg[i]);
+		_renderAheadEvents.push(event);
+		return true;
+	}
+
+	flushQueuedEvents();
+	return false;
+}
+
+void MidiDriver_Emulated::setRenderAhead(uint32 milliseconds) {
+	disableRenderAhead();
+
+	if (!milliseconds)
+		return;
+
+	// One block more than the target is needed for the block being played
+	const uint32 frames = (uint32)getRate() * milliseconds / 1000;
+	const uint blocks = CLIP<uint>((frames + kRenderAheadBlockFrames - 1) / kRenderAheadBlockFrames, 1, kMaxRenderAheadBlocks - 1);
+	const int blockSamples = kRenderAheadBlockFrames * (isStereo() ? 2 : 1);
+
+	_renderAheadBuffer = new int16[(blocks + 1) * blockSamples];
+	for (uint i = 0; i <= blocks; i++)
+		_renderAheadFree.push(i);
+
+	_renderAheadBlock = -1;
+	_renderAheadPos = 0;
+	_renderAheadPlayFrame = 0;
+	_renderAheadSynthFrame = 0;
+	_renderAheadBlocks = blocks;
+
+	registerRenderAhead(this, true);
+}
+
+void MidiDriver_Emulated::setRenderAheadFromConfig() {
+	setRenderAhead(MAX<int>(ConfMan.getInt("midi_render_ahead"), 0));
+}
+
+void MidiDriver_Emulated::disableRenderAhead() {
+	if (!_renderAheadBlocks)
+		return;
+
+	// Once unregistered, the timer thread does not touch us anymore. The
+	// samples and events still queued are dropped.
+	registerRenderAhead(this, false);
+
+	uint block;
+	while (_renderAheadQueue.pop(block))
+		;
+	while (_renderAheadFree.pop(block))
+		;
+	RenderAheadEvent event;
+	while (_renderAheadEvents.pop(event))
+		;
+	byte data;
+	while (_renderAheadSysEx.pop(data))
+		;
+
+	delete[] _renderAheadBuffer;
+	_renderAheadBuffer = 0;
+	_renderAheadBlocks = 0;
+	_renderAheadBlock = -1;
+}
+
+void MidiDriver_Emulated::renderAheadBlock() {
+	if (_renderAheadQueue.size() >= _renderAheadBlocks)
+		return;
+
+	uint block;
+	if (!_renderAheadFree.pop(block))
+		return;
+
+	const int blockSamples = kRenderAheadBlockFrames * (isStereo() ? 2 : 1);
+	renderQueuedEvents(_renderAheadBuffer + block * blockSamples, kRenderAheadBlockFrames);
+	_renderAheadQueue.push(block);
+}
+
+void MidiDriver_Emulated::renderAheadProc(void *refCon) {
+	// The timer manager does not allow installing the same callback more
+	// than once, so this one serves all drivers.
+	//
+	// Timer procs are called with the timer manager locked, which holds up
+	// all other timer procs. Each call therefore renders at most one block
+	// per driver; the interval is short enough for that to stay ahead of
+	// the mixer.
+	for (uint i = 0; i < s_renderAheadDrivers.size(); i++) {
+		MidiDriver_Emulated *driver = s_renderAheadDrivers[i];
+
+		Common::StackLock lock(driver->_renderAheadMutex);
+		driver->renderAheadBlock();
+	}
+}
+
+void MidiDriver_Emulated::registerRenderAhead(MidiDriver_Emulated *driver, bool enable) {
+	// Removing the timer proc waits for it to finish, after which the list
+	// can be changed safely.
+	Common::TimerManager *timerManager = g_system->getTimerManager();
+	timerManager->removeTimerProc(&renderAheadProc);
+
+	if (enable) {
+		s_renderAheadDrivers.push_back(driver);
+	} else {
+		for (uint i = 0; i < s_renderAheadDrivers.size(); i++) {
+			if (s_renderAheadDrivers[i] == driver) {
+				s_renderAheadDrivers.remove_at(i);
+				break;
+			}
+		}
+	}
+
+	if (!s_renderAheadDrivers.empty())
+		timerManager->installTimerProc(&renderAheadProc, kRenderAheadInterval, 0, "midiRenderAhead");
+}
@@ -26,6 +26,8 @@
 #include "audio/audiostream.h"
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
+#include "common/mutex.h"
+#include "common/spscqueue.h"
 
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
@@ -44,12 +46,130 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	// Render-ahead, see setRenderAhead()
+	enum {
+		/** Number of sample frames in a render-ahead block */
+		kRenderAheadBlockFrames = 256,
+		kMaxRenderAheadBlocks = 64,
+		/** Number of MIDI events which can wait for the synthesizer */
+		kMaxRenderAheadEvents = 1024,
+		/** Bytes of sysEx data which can wait for the synthesizer */
+		kRenderAheadSysExSize = 8192,
+		/** Longest sysEx which is queued rather than played right away */
+		kMaxRenderAheadSysExLength = 512,
+		/**
+		 * Microseconds between two blocks rendered ahead. One block lasts
+		 * more than 5ms up to 48kHz, so this renders faster than played.
+		 */
+		kRenderAheadInterval = 4000
+	};
+
+	/** A MIDI event waiting for the synthesizer to reach its frame */
+	struct RenderAheadEvent {
+		/** Frame of the synthesized audio at which the event is played */
+		uint32 frame;
+		/** The MIDI message, for events which are no sysEx */
+		uint32 message;
+		/** Length of the sysEx data in _renderAheadSysEx, or 0 */
+		uint16 sysExLength;
+	};
+
+	/** Number of blocks kept rendered ahead, 0 when disabled */
+	uint _renderAheadBlocks;
+	int16 *_renderAheadBuffer;
+	/** Blocks ready to be played, filled from the timer thread */
+	Common::SPSCQueue<uint, kMaxRenderAheadBlocks> _renderAheadQueue;
+	/** Blocks played by the mixer, ready to be filled again */
+	Common::SPSCQueue<uint, kMaxRenderAheadBlocks> _renderAheadFree;
+	/** Block being played by the mixer, or -1 */
+	int _renderAheadBlock;
+	/** Samples of the block being played which were already mixed */
+	int _renderAheadPos;
+	/** Serializes rendering between the timer and the mixer thread */
+	Common::Mutex _renderAheadMutex;
+
+	/** Events waiting for the synthesizer, in the order they were sent */
+	Common::SPSCQueue<RenderAheadEvent, kMaxRenderAheadEvents> _renderAheadEvents;
+	/** The data of the queued sysEx events */
+	Common::SPSCQueue<byte, kRenderAheadSysExSize> _renderAheadSysEx;
+	/** Serializes queueing events between the threads sending them */
+	Common::Mutex _renderAheadEventMutex;
+	/** Frames played by the mixer; _renderAheadEventMutex must be locked */
+	uint32 _renderAheadPlayFrame;
+	/** Frames synthesized; _renderAheadMutex must be locked */
+	uint32 _renderAheadSynthFrame;
+
+	/** Copy samples rendered ahead, or render them if none are ready */
+	void readRenderedAhead(int16 *data, int len);
+	/** Synthesize samples, playing the queued events at their frame; _renderAheadMutex must be locked */
+	void renderQueuedEvents(int16 *data, int len);
+	/** Play the first queued event; _renderAheadMutex must be locked */
+	void playQueuedEvent();
+	/** Play all queued events right away, keeping their order */
+	void flushQueuedEvents();
+	/** Render the next block ahead, if any is free; _renderAheadMutex must be locked */
+	void renderAheadBlock();
+	void disableRenderAhead();
+	static void renderAheadProc(void *refCon);
+	static void registerRenderAhead(MidiDriver_Emulated *driver, bool enable);
+
 protected:
 	int _baseFreq;
 
 	virtual void generateSamples(int16 *buf, int len) = 0;
 	virtual void onTimer() {}
 
+	/**
+	 * Render the audio ahead of time while it is playing, keeping about the
+	 * given duration rendered. The mixer then only copies the samples, so
+	 * passages that are expensive to synthesize do not cause underruns.
+	 *
+	 * The samples are rendered from the timer thread, which is a separate
+	 * thread on most backends, and generateSamples() is called from there.
+	 * When nothing is rendered in time, the mixer renders the samples itself
+	 * like without render-ahead. The timer callback and onTimer() are still
+	 * called by the mixer, as the samples are played.
+	 *
+	 * MIDI events are queued with the frame they are sent at, and played
+	 * when the synthesizer reaches that frame plus a fixed latency. Events
+	 * from the timer callback therefore keep their exact relative timing.
+	 * Drivers enabling this have to pass their events through queueEvent()
+	 * and queueSysEx(), and play them in playEvent() and playSysEx().
+	 *
+	 * Drivers enabling this must disable it again in close(), after
+	 * stopping their mixer stream and before releasing the synthesizer.
+	 *
+	 * @param milliseconds	the duration to render ahead, 0 to disable
+	 */
+	void setRenderAhead(uint32 milliseconds);
+
+	/**
+	 * Enable render-ahead with the latency from the "midi_render_ahead"
+	 * setting, in milliseconds.
+	 */
+	void setRenderAheadFromConfig();
+
+	/**
+	 * Queue a MIDI message for the audio rendered ahead. send() calls this
+	 * first, and plays the message itself only when it returns false.
+	 *
+	 * @return whether the message was queued, to be passed to playEvent()
+	 */
+	bool queueEvent(uint32 b);
+
+	/**
+	 * Queue a sysEx for the audio rendered ahead, see queueEvent().
+	 *
+	 * @return whether the sysEx was queued, to be passed to playSysEx()
+	 */
+	bool queueSysEx(const byte *msg, uint16 length);
+
+	/** Play a MIDI message on the synthesizer, see queueEvent() */
+	virtual void playEvent(uint32 b) {}
+
+	/** Play a sysEx on the synthesizer, see queueSysEx() */
+	virtual void playSysEx(const byte *msg, uint16 length) {}
+
 public:
 	MidiDriver_Emulated(Audio::Mixer *mixer) :
 		_mixer(mixer),
@@ -58,9 +178,19 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
+		_renderAheadBlocks(0),
+		_renderAheadBuffer(0),
+		_renderAheadBlock(-1),
+		_renderAheadPos(0),
+		_renderAheadPlayFrame(0),
+		_renderAheadSynthFrame(0),
 		_baseFreq(250) {
 	}
 
+	virtual ~MidiDriver_Emulated() {
+		disableRenderAhead();
+	}
+
 	// MidiDriver API
 	virtual int open() {
 		_isOpen = true;
@@ -88,34 +218,7 @@ public:
 	}
 
 	// AudioStream API
-	virtual int readBuffer(int16 *data, const int numSamples) {
-		const int stereoFactor = isStereo() ? 2 : 1;
-		int len = numSamples / stereoFactor;
-		int step;
-
-		do {
-			step = len;
-			if (step > (_nextTick >> FIXP_SHIFT))
-				step = (_nextTick >> FIXP_SHIFT);
-
-			generateSamples(data, step);
-
-			_nextTick -= step << FIXP_SHIFT;
-			if (!(_nextTick >> FIXP_SHIFT)) {
-				if (_timerProc)
-					(*_timerProc)(_timerParam);
-
-				onTimer();
-
-				_nextTick += _samplesPerTick;
-			}
-
-			data += step * stereoFactor;
-			len -= step;
-		} while (len);
-
-		return numSamples;
-	}
+	virtual int readBuffer(int16 *data, const int numSamples);
 
 	virtual bool endOfData() const {
 		return false;
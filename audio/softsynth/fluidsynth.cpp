@@ -52,6 +52,7 @@ protected:
 	void setStr(const char *name, const char *str);
 
 	void generateSamples(int16 *buf, int len);
+	void playEvent(uint32 b);
 
 public:
 	MidiDriver_FluidSynth(Audio::Mixer *mixer);
@@ -201,6 +202,7 @@ int MidiDriver_FluidSynth::open() {
 		error("Failed loading custom sound font '%s'", soundfont);
 
 	MidiDriver_Emulated::open();
+	setRenderAheadFromConfig();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 	return 0;
@@ -212,6 +214,7 @@ void MidiDriver_FluidSynth::close() {
 	_isOpen = false;
 
 	_mixer->stopHandle(_mixerSoundHandle);
+	setRenderAhead(0);
 
 	if (_soundFont != -1)
 		fluid_synth_sfunload(_synth, _soundFont, 1);
@@ -221,6 +224,11 @@ void MidiDriver_FluidSynth::close() {
 }
 
 void MidiDriver_FluidSynth::send(uint32 b) {
+	if (!queueEvent(b))
+		playEvent(b);
+}
+
+void MidiDriver_FluidSynth::playEvent(uint32 b) {
 	//byte param3 = (byte) ((b >> 24) & 0xFF);
 	uint param2 = (byte) ((b >> 16) & 0xFF);
 	uint param1 = (byte) ((b >>  8) & 0xFF);
@@ -115,6 +115,8 @@ private:
 
 protected:
 	void generateSamples(int16 *buf, int len);
+	void playEvent(uint32 b);
+	void playSysEx(const byte *msg, uint16 length);
 
 public:
 	MidiDriver_MT32(Audio::Mixer *mixer);
@@ -220,6 +222,7 @@ int MidiDriver_MT32::open() {
 	_outputRate = _service.getActualStereoOutputSamplerate();
 
 	MidiDriver_Emulated::open();
+	setRenderAheadFromConfig();
 
 	_mixer->playStream(Audio::Mixer::kPlainSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
@@ -227,6 +230,11 @@ int MidiDriver_MT32::open() {
 }
 
 void MidiDriver_MT32::send(uint32 b) {
+	if (!queueEvent(b))
+		playEvent(b);
+}
+
+void MidiDriver_MT32::playEvent(uint32 b) {
 	Common::StackLock lock(_mutex);
 	_service.playMsg(b);
 }
@@ -237,12 +245,18 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 	if (range > 24) {
 		warning("setPitchBendRange() called with range > 24: %d", range);
 	}
-	byte benderRangeSysex[4] = { 0, 0, 4, (uint8)range };
-	Common::StackLock lock(_mutex);
-	_service.writeSysex(channel, benderRangeSysex, 4);
+	// A DT1 sysEx for the bender range of the part, in the format sysEx()
+	// expects, so it is queued along with the other events
+	byte benderRangeSysex[9] = { 0x41, channel, 0x16, 0x12, 0, 0, 4, (uint8)range, 0 };
+	sysEx(benderRangeSysex, 9);
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
+	if (!queueSysEx(msg, length))
+		playSysEx(msg, length);
+}
+
+void MidiDriver_MT32::playSysEx(const byte *msg, uint16 length) {
 	if (msg[0] == 0xf0) {
 		Common::StackLock lock(_mutex);
 		_service.playSysex(msg, length);
@@ -270,6 +284,7 @@ void MidiDriver_MT32::close() {
 	setTimerCallback(NULL, NULL);
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
+	setRenderAhead(0);
 
 	Common::StackLock lock(_mutex);
 	_service.closeSynth();
@@ -35,11 +35,19 @@
 
 #ifndef DISABLE_NUKED_OPL
 
+#ifdef __SSE2__
+#define NUKED_OPL_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace OPL {
 namespace NUKED {
 
 #define RSM_FRAC    10
 
+// Whether the slots are processed in lanes; see OPL::setSIMD()
+static bool s_useSIMD = true;
+
 // Channel types
 
 enum {
@@ -1050,12 +1058,11 @@ static Bit16s OPL3_ClipSample(Bit32s sample)
     return (Bit16s)sample;
 }
 
-void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
+static void OPL3_GenerateSlots(opl3_chip *chip, Bit16s *buf)
 {
     Bit8u ii;
     Bit8u jj;
     Bit16s accm;
-    Bit8u shift = 0;
 
     buf[1] = OPL3_ClipSample(chip->mixbuff[1]);
 
@@ -1114,6 +1121,431 @@ void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
         OPL3_PhaseGenerate(&chip->slot[ii]);
         OPL3_SlotGenerate(&chip->slot[ii]);
     }
+}
+
+//
+// Lanes
+//
+// The generator runs the feedback, envelope and phase stages of all slots
+// side by side. None of them depends on the other slots of the same
+// sample. The rhythm part of the phase stage, the waveforms and the mixing
+// do, so they still run slot by slot, in the same order as
+// OPL3_GenerateSlots().
+//
+
+#ifdef NUKED_OPL_SSE2
+
+static Bit8u OPL3_LanesSignal(opl3_chip *chip, const Bit16s *signal)
+{
+    Bit8u slotnum;
+    if (signal == &chip->zeromod)
+    {
+        return OPL_LANES_ZERO;
+    }
+    slotnum = (Bit8u)(((const char *)signal - (const char *)chip->slot) / sizeof(opl3_slot));
+    if (signal == &chip->slot[slotnum].fbmod)
+    {
+        return OPL_LANES_FBMOD + slotnum;
+    }
+    return OPL_LANES_OUT + slotnum;
+}
+
+static void OPL3_LanesUpdatePhase(opl3_chip *chip)
+{
+    opl3_lanes *lanes = &chip->lanes;
+    Bit8u ii;
+
+    // Same as in OPL3_PhaseGenerate(). The vibrato position only changes
+    // every 1024 samples, so the increments are kept until then.
+    for (ii = 0; ii < 36; ii++)
+    {
+        opl3_slot *slot = &chip->slot[ii];
+        Bit16u f_num = slot->channel->f_num;
+        Bit32u basefreq;
+        if (slot->reg_vib)
+        {
+            Bit8s range;
+            Bit8u vibpos;
+
+            range = (f_num >> 7) & 7;
+            vibpos = chip->vibpos;
+
+            if (!(vibpos & 3))
+            {
+                range = 0;
+            }
+            else if (vibpos & 1)
+            {
+                range >>= 1;
+            }
+            range >>= chip->vibshift;
+
+            if (vibpos & 4)
+            {
+                range = -range;
+            }
+            f_num += range;
+        }
+        basefreq = (f_num << slot->channel->block) >> 1;
+        lanes->pg_inc[ii] = (basefreq * mt[slot->reg_mult]) >> 1;
+    }
+    lanes->vibpos = chip->vibpos;
+}
+
+static void OPL3_LanesUpdateRegs(opl3_chip *chip)
+{
+    opl3_lanes *lanes = &chip->lanes;
+    Bit8u ii;
+    Bit8u jj;
+
+    for (ii = 0; ii < 36; ii++)
+    {
+        opl3_slot *slot = &chip->slot[ii];
+        lanes->key[ii] = slot->key;
+        lanes->reg_ar[ii] = slot->reg_ar;
+        lanes->reg_dr[ii] = slot->reg_dr;
+        lanes->reg_sl[ii] = slot->reg_sl;
+        lanes->reg_rr[ii] = slot->reg_rr;
+        lanes->reg_type[ii] = slot->reg_type ? -1 : 0;
+        lanes->ks[ii] = slot->channel->ksv >> ((slot->reg_ksr ^ 1) << 1);
+        lanes->eg_base[ii] = (slot->reg_tl << 2) + (slot->eg_ksl >> kslshift[slot->reg_ksl]);
+        lanes->trem[ii] = (slot->trem == &chip->tremolo) ? -1 : 0;
+        // x >> (9 - fb) is the high word of x << (7 + fb)
+        lanes->fbmul[ii] = slot->channel->fb ? 1 << (0x07 + slot->channel->fb) : 0;
+        lanes->reg_wf[ii] = slot->reg_wf;
+        lanes->mod[ii] = OPL3_LanesSignal(chip, slot->mod);
+    }
+    for (ii = 0; ii < 18; ii++)
+    {
+        for (jj = 0; jj < 4; jj++)
+        {
+            lanes->chout[ii][jj] = OPL3_LanesSignal(chip, chip->channel[ii].out[jj]);
+        }
+        lanes->cha[ii] = chip->channel[ii].cha;
+        lanes->chb[ii] = chip->channel[ii].chb;
+    }
+    OPL3_LanesUpdatePhase(chip);
+    lanes->dirty = 0;
+}
+
+static void OPL3_LanesImport(opl3_chip *chip)
+{
+    opl3_lanes *lanes = &chip->lanes;
+    Bit8u ii;
+
+    memset(lanes, 0, sizeof(opl3_lanes));
+    for (ii = 0; ii < 36; ii++)
+    {
+        opl3_slot *slot = &chip->slot[ii];
+        lanes->signal[OPL_LANES_OUT + ii] = slot->out;
+        lanes->signal[OPL_LANES_FBMOD + ii] = slot->fbmod;
+        lanes->prout[ii] = slot->prout;
+        lanes->eg_rout[ii] = slot->eg_rout;
+        lanes->eg_out[ii] = slot->eg_out;
+        lanes->eg_gen[ii] = slot->eg_gen;
+        lanes->pg_reset[ii] = slot->pg_reset ? -1 : 0;
+        lanes->pg_phase[ii] = slot->pg_phase;
+        lanes->pg_phase_out[ii] = slot->pg_phase_out;
+    }
+    OPL3_LanesUpdateRegs(chip);
+    lanes->active = 1;
+}
+
+static void OPL3_LanesExport(opl3_chip *chip)
+{
+    opl3_lanes *lanes = &chip->lanes;
+    Bit8u ii;
+
+    for (ii = 0; ii < 36; ii++)
+    {
+        opl3_slot *slot = &chip->slot[ii];
+        slot->out = lanes->signal[OPL_LANES_OUT + ii];
+        slot->fbmod = lanes->signal[OPL_LANES_FBMOD + ii];
+        slot->prout = lanes->prout[ii];
+        slot->eg_rout = lanes->eg_rout[ii];
+        slot->eg_out = lanes->eg_out[ii];
+        slot->eg_gen = (Bit8u)lanes->eg_gen[ii];
+        slot->pg_reset = lanes->pg_reset[ii] ? 1 : 0;
+        slot->pg_phase = lanes->pg_phase[ii];
+        slot->pg_phase_out = lanes->pg_phase_out[ii];
+    }
+    lanes->active = 0;
+}
+
+static inline __m128i OPL3_LanesSelect(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static void OPL3_LanesCalcFB(opl3_lanes *lanes)
+{
+    Bit8u ii;
+    for (ii = 0; ii < OPL_LANES; ii += 8)
+    {
+        __m128i out = _mm_loadu_si128((const __m128i *)&lanes->signal[OPL_LANES_OUT + ii]);
+        __m128i prout = _mm_loadu_si128((const __m128i *)&lanes->prout[ii]);
+        __m128i fbmul = _mm_loadu_si128((const __m128i *)&lanes->fbmul[ii]);
+        __m128i fbmod = _mm_mulhi_epi16(_mm_add_epi16(prout, out), fbmul);
+        _mm_storeu_si128((__m128i *)&lanes->signal[OPL_LANES_FBMOD + ii], fbmod);
+        _mm_storeu_si128((__m128i *)&lanes->prout[ii], out);
+    }
+}
+
+static void OPL3_LanesEnvelopeCalc(opl3_chip *chip)
+{
+    opl3_lanes *lanes = &chip->lanes;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_cmpeq_epi16(zero, zero);
+    const __m128i c1 = _mm_set1_epi16(1);
+    const __m128i c2 = _mm_set1_epi16(2);
+    const __m128i c3 = _mm_set1_epi16(3);
+    const __m128i c4 = _mm_set1_epi16(4);
+    const __m128i c12 = _mm_set1_epi16(12);
+    const __m128i c13 = _mm_set1_epi16(13);
+    const __m128i c14 = _mm_set1_epi16(14);
+    const __m128i c15 = _mm_set1_epi16(15);
+    const __m128i c1f8 = _mm_set1_epi16(0x1f8);
+    const __m128i c1ff = _mm_set1_epi16(0x1ff);
+    const __m128i tremolo = _mm_set1_epi16(chip->tremolo);
+    const __m128i eg_add = _mm_set1_epi16(chip->eg_add);
+    const __m128i eg_state = _mm_set1_epi16(chip->eg_state);
+    const __m128i eg_state_mask = chip->eg_state ? ones : zero;
+    const Bit8u timer = chip->timer & 0x03;
+    const __m128i incstep0 = _mm_set1_epi16(eg_incstep[0][timer]);
+    const __m128i incstep1 = _mm_set1_epi16(eg_incstep[1][timer]);
+    const __m128i incstep2 = _mm_set1_epi16(eg_incstep[2][timer]);
+    const __m128i incstep3 = _mm_set1_epi16(eg_incstep[3][timer]);
+    Bit8u ii;
+
+    // Same as OPL3_EnvelopeCalc(), with every branch turned into a mask
+    for (ii = 0; ii < OPL_LANES; ii += 8)
+    {
+        __m128i eg_rout = _mm_loadu_si128((const __m128i *)&lanes->eg_rout[ii]);
+        __m128i eg_gen = _mm_loadu_si128((const __m128i *)&lanes->eg_gen[ii]);
+        __m128i key = _mm_cmpgt_epi16(_mm_loadu_si128((const __m128i *)&lanes->key[ii]), zero);
+        __m128i trem = _mm_loadu_si128((const __m128i *)&lanes->trem[ii]);
+        __m128i eg_out = _mm_add_epi16(eg_rout, _mm_loadu_si128((const __m128i *)&lanes->eg_base[ii]));
+        __m128i attack, decay, sustain, release, reset;
+        __m128i reg_rate, nonzero, rate, rate_hi, rate_lo, eg_shift;
+        __m128i shift_lo, shift_hi, incstep, shift, shift_pos, mul;
+        __m128i rate_max, eg_off, rout, rout_zero, sl_hit, att_inc, dec_inc;
+
+        eg_out = _mm_add_epi16(eg_out, _mm_and_si128(tremolo, trem));
+        _mm_storeu_si128((__m128i *)&lanes->eg_out[ii], eg_out);
+
+        attack = _mm_cmpeq_epi16(eg_gen, zero);
+        decay = _mm_cmpeq_epi16(eg_gen, c1);
+        sustain = _mm_cmpeq_epi16(eg_gen, c2);
+        release = _mm_cmpeq_epi16(eg_gen, c3);
+        reset = _mm_and_si128(key, release);
+        _mm_storeu_si128((__m128i *)&lanes->pg_reset[ii], reset);
+
+        reg_rate = _mm_loadu_si128((const __m128i *)&lanes->reg_rr[ii]);
+        reg_rate = _mm_andnot_si128(_mm_and_si128(sustain, _mm_loadu_si128((const __m128i *)&lanes->reg_type[ii])), reg_rate);
+        reg_rate = OPL3_LanesSelect(decay, _mm_loadu_si128((const __m128i *)&lanes->reg_dr[ii]), reg_rate);
+        reg_rate = OPL3_LanesSelect(_mm_or_si128(attack, reset), _mm_loadu_si128((const __m128i *)&lanes->reg_ar[ii]), reg_rate);
+        nonzero = _mm_andnot_si128(_mm_cmpeq_epi16(reg_rate, zero), ones);
+
+        rate = _mm_add_epi16(_mm_loadu_si128((const __m128i *)&lanes->ks[ii]), _mm_slli_epi16(reg_rate, 2));
+        rate_hi = _mm_min_epi16(_mm_srli_epi16(rate, 2), c15);
+        rate_lo = _mm_and_si128(rate, c3);
+        eg_shift = _mm_add_epi16(rate_hi, eg_add);
+
+        shift_lo = _mm_and_si128(_mm_cmpeq_epi16(eg_shift, c12), c1);
+        shift_lo = _mm_or_si128(shift_lo, _mm_and_si128(_mm_cmpeq_epi16(eg_shift, c13), _mm_srli_epi16(rate_lo, 1)));
+        shift_lo = _mm_or_si128(shift_lo, _mm_and_si128(_mm_cmpeq_epi16(eg_shift, c14), _mm_and_si128(rate_lo, c1)));
+        shift_lo = _mm_and_si128(shift_lo, eg_state_mask);
+
+        incstep = _mm_and_si128(_mm_cmpeq_epi16(rate_lo, zero), incstep0);
+        incstep = _mm_or_si128(incstep, _mm_and_si128(_mm_cmpeq_epi16(rate_lo, c1), incstep1));
+        incstep = _mm_or_si128(incstep, _mm_and_si128(_mm_cmpeq_epi16(rate_lo, c2), incstep2));
+        incstep = _mm_or_si128(incstep, _mm_and_si128(_mm_cmpeq_epi16(rate_lo, c3), incstep3));
+        shift_hi = _mm_min_epi16(_mm_add_epi16(_mm_and_si128(rate_hi, c3), incstep), c3);
+        shift_hi = OPL3_LanesSelect(_mm_cmpeq_epi16(shift_hi, zero), eg_state, shift_hi);
+
+        shift = OPL3_LanesSelect(_mm_cmpgt_epi16(c12, rate_hi), shift_lo, shift_hi);
+        shift = _mm_and_si128(shift, nonzero);
+        shift_pos = _mm_cmpgt_epi16(shift, zero);
+        // 1 << shift
+        mul = _mm_add_epi16(c1, _mm_and_si128(shift_pos, c1));
+        mul = _mm_add_epi16(mul, _mm_and_si128(_mm_cmpgt_epi16(shift, c1), c2));
+        mul = _mm_add_epi16(mul, _mm_and_si128(_mm_cmpgt_epi16(shift, c2), c4));
+
+        rate_max = _mm_cmpeq_epi16(rate_hi, c15);
+        rout = _mm_andnot_si128(_mm_and_si128(reset, rate_max), eg_rout);
+        eg_off = _mm_cmpeq_epi16(_mm_and_si128(eg_rout, c1f8), c1f8);
+        rout = OPL3_LanesSelect(_mm_andnot_si128(_mm_or_si128(attack, reset), eg_off), c1ff, rout);
+
+        rout_zero = _mm_cmpeq_epi16(eg_rout, zero);
+        att_inc = _mm_srai_epi16(_mm_mullo_epi16(_mm_xor_si128(eg_rout, ones), mul), 4);
+        att_inc = _mm_and_si128(att_inc, _mm_andnot_si128(rout_zero, _mm_and_si128(attack, key)));
+        att_inc = _mm_and_si128(att_inc, _mm_andnot_si128(rate_max, shift_pos));
+
+        sl_hit = _mm_cmpeq_epi16(_mm_srli_epi16(eg_rout, 4), _mm_loadu_si128((const __m128i *)&lanes->reg_sl[ii]));
+        dec_inc = _mm_or_si128(_mm_andnot_si128(sl_hit, decay), _mm_or_si128(sustain, release));
+        dec_inc = _mm_andnot_si128(_mm_or_si128(eg_off, reset), _mm_and_si128(dec_inc, shift_pos));
+        dec_inc = _mm_and_si128(dec_inc, _mm_srli_epi16(mul, 1));
+
+        rout = _mm_add_epi16(rout, _mm_add_epi16(att_inc, dec_inc));
+        _mm_storeu_si128((__m128i *)&lanes->eg_rout[ii], _mm_and_si128(rout, c1ff));
+
+        eg_gen = OPL3_LanesSelect(_mm_and_si128(attack, rout_zero), c1, eg_gen);
+        eg_gen = OPL3_LanesSelect(_mm_and_si128(decay, sl_hit), c2, eg_gen);
+        eg_gen = _mm_andnot_si128(reset, eg_gen);
+        eg_gen = OPL3_LanesSelect(key, eg_gen, c3);
+        _mm_storeu_si128((__m128i *)&lanes->eg_gen[ii], eg_gen);
+    }
+}
+
+static Bit32u OPL3_LanesNoise(Bit32u noise, Bit8u steps)
+{
+    while (steps--)
+    {
+        Bit8u n_bit = ((noise >> 14) ^ noise) & 0x01;
+        noise = (noise >> 1) | (n_bit << 22);
+    }
+    return noise;
+}
+
+static void OPL3_LanesPhaseGenerate(opl3_chip *chip)
+{
+    opl3_lanes *lanes = &chip->lanes;
+    Bit32u noise;
+    Bit8u rm_xor;
+    Bit16u phase;
+    Bit8u ii;
+
+    for (ii = 0; ii < OPL_LANES; ii += 8)
+    {
+        __m128i reset = _mm_loadu_si128((const __m128i *)&lanes->pg_reset[ii]);
+        __m128i phase_lo = _mm_loadu_si128((const __m128i *)&lanes->pg_phase[ii]);
+        __m128i phase_hi = _mm_loadu_si128((const __m128i *)&lanes->pg_phase[ii + 4]);
+        // Bit16u of phase >> 9, sign extended so that the packing does not
+        // saturate it
+        __m128i out_lo = _mm_srai_epi32(_mm_slli_epi32(phase_lo, 7), 16);
+        __m128i out_hi = _mm_srai_epi32(_mm_slli_epi32(phase_hi, 7), 16);
+        _mm_storeu_si128((__m128i *)&lanes->pg_phase_out[ii], _mm_packs_epi32(out_lo, out_hi));
+        phase_lo = _mm_andnot_si128(_mm_unpacklo_epi16(reset, reset), phase_lo);
+        phase_hi = _mm_andnot_si128(_mm_unpackhi_epi16(reset, reset), phase_hi);
+        phase_lo = _mm_add_epi32(phase_lo, _mm_loadu_si128((const __m128i *)&lanes->pg_inc[ii]));
+        phase_hi = _mm_add_epi32(phase_hi, _mm_loadu_si128((const __m128i *)&lanes->pg_inc[ii + 4]));
+        _mm_storeu_si128((__m128i *)&lanes->pg_phase[ii], phase_lo);
+        _mm_storeu_si128((__m128i *)&lanes->pg_phase[ii + 4], phase_hi);
+    }
+
+    // Rhythm mode. The noise generator steps once per slot.
+    noise = OPL3_LanesNoise(chip->noise, 13);
+    phase = lanes->pg_phase_out[13];
+    chip->rm_hh_bit2 = (phase >> 2) & 1;
+    chip->rm_hh_bit3 = (phase >> 3) & 1;
+    chip->rm_hh_bit7 = (phase >> 7) & 1;
+    chip->rm_hh_bit8 = (phase >> 8) & 1;
+    if (chip->rhy & 0x20)
+    {
+        rm_xor = (chip->rm_hh_bit2 ^ chip->rm_hh_bit7)
+               | (chip->rm_hh_bit3 ^ chip->rm_tc_bit5)
+               | (chip->rm_tc_bit3 ^ chip->rm_tc_bit5);
+        lanes->pg_phase_out[13] = (rm_xor << 9) | ((rm_xor ^ (noise & 1)) ? 0xd0 : 0x34);
+        noise = OPL3_LanesNoise(noise, 3);
+        lanes->pg_phase_out[16] = (chip->rm_hh_bit8 << 9)
+                                | ((chip->rm_hh_bit8 ^ (noise & 1)) << 8);
+        phase = lanes->pg_phase_out[17];
+        chip->rm_tc_bit3 = (phase >> 3) & 1;
+        chip->rm_tc_bit5 = (phase >> 5) & 1;
+        rm_xor = (chip->rm_hh_bit2 ^ chip->rm_hh_bit7)
+               | (chip->rm_hh_bit3 ^ chip->rm_tc_bit5)
+               | (chip->rm_tc_bit3 ^ chip->rm_tc_bit5);
+        lanes->pg_phase_out[17] = (rm_xor << 9) | 0x80;
+        noise = OPL3_LanesNoise(noise, 1);
+    }
+    else
+    {
+        noise = OPL3_LanesNoise(noise, 4);
+    }
+    chip->noise = OPL3_LanesNoise(noise, 19);
+}
+
+static void OPL3_LanesSlotGenerate(opl3_lanes *lanes, Bit8u first, Bit8u last)
+{
+    Bit8u ii;
+    for (ii = first; ii < last; ii++)
+    {
+        lanes->signal[OPL_LANES_OUT + ii] = envelope_sin[lanes->reg_wf[ii]](
+            lanes->pg_phase_out[ii] + lanes->signal[lanes->mod[ii]], lanes->eg_out[ii]);
+    }
+}
+
+static Bit32s OPL3_LanesMix(const opl3_lanes *lanes, const Bit16u *mask)
+{
+    Bit32s mix = 0;
+    Bit8u ii;
+    for (ii = 0; ii < 18; ii++)
+    {
+        Bit16s accm = lanes->signal[lanes->chout[ii][0]];
+        accm += lanes->signal[lanes->chout[ii][1]];
+        accm += lanes->signal[lanes->chout[ii][2]];
+        accm += lanes->signal[lanes->chout[ii][3]];
+        mix += (Bit16s)(accm & mask[ii]);
+    }
+    return mix;
+}
+
+static void OPL3_LanesGenerate(opl3_chip *chip, Bit16s *buf)
+{
+    opl3_lanes *lanes = &chip->lanes;
+
+    if (!lanes->active)
+    {
+        OPL3_LanesImport(chip);
+    }
+    else if (lanes->dirty)
+    {
+        OPL3_LanesUpdateRegs(chip);
+    }
+    else if (lanes->vibpos != chip->vibpos)
+    {
+        OPL3_LanesUpdatePhase(chip);
+    }
+
+    buf[1] = OPL3_ClipSample(chip->mixbuff[1]);
+
+    OPL3_LanesCalcFB(lanes);
+    OPL3_LanesEnvelopeCalc(chip);
+    OPL3_LanesPhaseGenerate(chip);
+
+    OPL3_LanesSlotGenerate(lanes, 0, 15);
+    chip->mixbuff[0] = OPL3_LanesMix(lanes, lanes->cha);
+    OPL3_LanesSlotGenerate(lanes, 15, 18);
+
+    buf[0] = OPL3_ClipSample(chip->mixbuff[0]);
+
+    OPL3_LanesSlotGenerate(lanes, 18, 33);
+    chip->mixbuff[1] = OPL3_LanesMix(lanes, lanes->chb);
+    OPL3_LanesSlotGenerate(lanes, 33, 36);
+}
+
+#endif // NUKED_OPL_SSE2
+
+void OPL3_Generate(opl3_chip *chip, Bit16s *buf)
+{
+    Bit8u shift = 0;
+
+#ifdef NUKED_OPL_SSE2
+    if (s_useSIMD)
+    {
+        OPL3_LanesGenerate(chip, buf);
+    }
+    else
+    {
+        if (chip->lanes.active)
+        {
+            OPL3_LanesExport(chip);
+        }
+        OPL3_GenerateSlots(chip, buf);
+    }
+#else
+    OPL3_GenerateSlots(chip, buf);
+#endif
 
     if ((chip->timer & 0x3f) == 0x3f)
     {
@@ -1249,6 +1681,7 @@ void OPL3_WriteReg(opl3_chip *chip, Bit16u reg, Bit8u v)
 {
     Bit8u high = (reg >> 8) & 0x01;
     Bit8u regm = reg & 0xff;
+    chip->lanes.dirty = 1;
     switch (regm & 0xf0)
     {
     case 0x00:
@@ -1477,6 +1910,15 @@ byte OPL::read(int port) {
 	return 0;
 }
 
+bool OPL::setSIMD(bool enable) {
+	s_useSIMD = enable;
+#ifdef NUKED_OPL_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
 void OPL::generateSamples(int16*buffer, int length) {
 	OPL3_GenerateStream(&chip, (Bit16s*)buffer, (Bit16u)length / 2);
 }
@@ -109,6 +109,48 @@ typedef struct _opl3_writebuf {
     Bit8u data;
 } opl3_writebuf;
 
+//
+// Slot state laid out for processing all slots of the chip at once, see
+// OPL::setSIMD(). The four lanes after the 36 slots are padding.
+//
+
+#define OPL_LANES           40
+#define OPL_LANES_OUT       0
+#define OPL_LANES_FBMOD     OPL_LANES
+#define OPL_LANES_ZERO      (2 * OPL_LANES)
+
+typedef struct _opl3_lanes {
+    // Generator state, used instead of the one in opl3_slot while active
+    Bit16s signal[2 * OPL_LANES + 8];
+    Bit16s prout[OPL_LANES];
+    Bit16s eg_rout[OPL_LANES];
+    Bit16s eg_out[OPL_LANES];
+    Bit16s eg_gen[OPL_LANES];
+    Bit16s pg_reset[OPL_LANES];
+    Bit32u pg_phase[OPL_LANES];
+    Bit16u pg_phase_out[OPL_LANES];
+    // Copy of the registers, refreshed after every register write
+    Bit16s key[OPL_LANES];
+    Bit16s reg_ar[OPL_LANES];
+    Bit16s reg_dr[OPL_LANES];
+    Bit16s reg_sl[OPL_LANES];
+    Bit16s reg_rr[OPL_LANES];
+    Bit16s reg_type[OPL_LANES];
+    Bit16s ks[OPL_LANES];
+    Bit16s eg_base[OPL_LANES];
+    Bit16s trem[OPL_LANES];
+    Bit16s fbmul[OPL_LANES];
+    Bit32u pg_inc[OPL_LANES];
+    Bit8u reg_wf[36];
+    Bit8u mod[36];
+    Bit8u chout[18][4];
+    Bit16u cha[18];
+    Bit16u chb[18];
+    Bit8u vibpos;
+    Bit8u active;
+    Bit8u dirty;
+} opl3_lanes;
+
 struct _opl3_chip {
     opl3_channel channel[18];
     opl3_slot slot[36];
@@ -145,6 +187,8 @@ struct _opl3_chip {
     Bit32u writebuf_last;
     Bit64u writebuf_lasttime;
     opl3_writebuf writebuf[OPL_WRITEBUF_SIZE];
+
+    opl3_lanes lanes;
 };
 
 void OPL3_Generate(opl3_chip *chip, Bit16s *buf);
@@ -176,6 +220,15 @@ public:
 
 	bool isStereo() const { return true; }
 
+	/**
+	 * Enable or disable the use of vector instructions, which process
+	 * the slots of a chip in lanes. They are enabled by default, and
+	 * produce exactly the same samples.
+	 *
+	 * @return whether vector instructions are available at all
+	 */
+	static bool setSIMD(bool enable);
+
 protected:
 	void generateSamples(int16 *buffer, int length);
 };
@@ -173,6 +173,15 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Query the size of the file referred by this path and the time it was
+	 * last modified at, as far as the file system provides them cheaply.
+	 * The time is only meant for comparing against an earlier query.
+	 *
+	 * @return bool true if the values were retrieved, false otherwise.
+	 */
+	virtual bool getFileStatus(uint32 &size, uint32 &modificationTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
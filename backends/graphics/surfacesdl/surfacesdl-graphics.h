@@ -31,6 +31,7 @@
 #include "common/system.h"
 
 #include "backends/events/sdl/sdl-events.h"
+#include "backends/graphics/surfacesdl/surfacesdl-scalerpool.h"
 
 #include "backends/platform/sdl/sdl-sys.h"
 
@@ -285,6 +286,7 @@ protected:
 
 	ScalerProc *_scalerProc;
 	int _scalerType;
+	SdlScalerPool *_scalerPool;
 	int _transactionMode;
 
 	// Indicates whether it is needed to free _hwSurface in destructor
@@ -0,0 +1,167 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/surfacesdl/surfacesdl-scalerpool.h"
+#include "common/config-manager.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+SdlScalerPool::SdlScalerPool()
+	: _numWorkers(0), _quit(false), _mutex(nullptr), _workSem(nullptr), _doneSem(nullptr),
+	  _numBands(0), _nextBand(0) {
+
+	int numWorkers = 0;
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	// Leave the remaining cores to the engine and the audio threads
+	numWorkers = SDL_GetCPUCount() - 1;
+#endif
+	if (ConfMan.hasKey("scaler_threads"))
+		numWorkers = ConfMan.getInt("scaler_threads") - 1;
+	numWorkers = CLIP<int>(numWorkers, 0, kMaxWorkers);
+
+	if (numWorkers == 0)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_workSem = SDL_CreateSemaphore(0);
+	_doneSem = SDL_CreateSemaphore(0);
+	if (!_mutex || !_workSem || !_doneSem) {
+		warning("Could not create scaler thread synchronization objects: %s", SDL_GetError());
+		return;
+	}
+
+	for (int i = 0; i < numWorkers; ++i) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		SDL_Thread *thread = SDL_CreateThread(workerThread, "ScummVM Scaler", this);
+#else
+		SDL_Thread *thread = SDL_CreateThread(workerThread, this);
+#endif
+		if (!thread) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			break;
+		}
+
+		_workers[_numWorkers++] = thread;
+	}
+}
+
+SdlScalerPool::~SdlScalerPool() {
+	_quit = true;
+	for (int i = 0; i < _numWorkers; ++i)
+		SDL_SemPost(_workSem);
+	for (int i = 0; i < _numWorkers; ++i)
+		SDL_WaitThread(_workers[i], nullptr);
+
+	if (_doneSem)
+		SDL_DestroySemaphore(_doneSem);
+	if (_workSem)
+		SDL_DestroySemaphore(_workSem);
+	if (_mutex)
+		SDL_DestroyMutex(_mutex);
+}
+
+bool SdlScalerPool::isThreadSafe(ScalerProc *scalerProc) {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	// The assembly versions keep their temporaries in global variables
+	if (scalerProc == HQ2x || scalerProc == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
+void SdlScalerPool::scale(ScalerProc *scalerProc, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+                          uint8 *dstPtr, uint32 dstPitch, int width, int height) {
+	if (_numWorkers == 0 || !isThreadSafe(scalerProc) || width * height < kMinParallelArea || height < 2 * kMinBandHeight) {
+		scalerProc(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
+		return;
+	}
+
+	// Keep band heights a multiple of four lines, so scalers like TV2x and
+	// DotMatrix which depend on the line parity produce the same pattern as
+	// when scaling the rectangle in one go.
+	const int numBands = MIN<int>(_numWorkers + 1, height / kMinBandHeight);
+	const int bandHeight = ((height + numBands - 1) / numBands + 3) & ~3;
+
+	SDL_mutexP(_mutex);
+	_numBands = 0;
+	_nextBand = 0;
+	for (int y = 0; y < height; y += bandHeight) {
+		Band &band = _bands[_numBands++];
+		band.scalerProc = scalerProc;
+		band.srcPtr = srcPtr + y * srcPitch;
+		band.srcPitch = srcPitch;
+		band.dstPtr = dstPtr + y * scaleFactor * dstPitch;
+		band.dstPitch = dstPitch;
+		band.width = width;
+		band.height = MIN(bandHeight, height - y);
+	}
+	const int postedBands = _numBands;
+	SDL_mutexV(_mutex);
+
+	for (int i = 0; i < postedBands; ++i)
+		SDL_SemPost(_workSem);
+
+	// Help out instead of just waiting
+	int bandsDone = 0;
+	while (runBand())
+		++bandsDone;
+
+	// Wait for the bands the workers picked up
+	for (; bandsDone < postedBands; ++bandsDone)
+		SDL_SemWait(_doneSem);
+}
+
+bool SdlScalerPool::runBand() {
+	SDL_mutexP(_mutex);
+	if (_nextBand >= _numBands) {
+		SDL_mutexV(_mutex);
+		return false;
+	}
+	const Band band = _bands[_nextBand++];
+	SDL_mutexV(_mutex);
+
+	band.scalerProc(band.srcPtr, band.srcPitch, band.dstPtr, band.dstPitch, band.width, band.height);
+	return true;
+}
+
+int SDLCALL SdlScalerPool::workerThread(void *data) {
+	SdlScalerPool *pool = (SdlScalerPool *)data;
+
+	for (;;) {
+		SDL_SemWait(pool->_workSem);
+		if (pool->_quit)
+			break;
+
+		// The caller may already have taken the band this wakeup was
+		// posted for, in which case there is nothing to do.
+		if (pool->runBand())
+			SDL_SemPost(pool->_doneSem);
+	}
+
+	return 0;
+}
+
+#endif
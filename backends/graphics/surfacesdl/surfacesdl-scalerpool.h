@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCALERPOOL_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCALERPOOL_H
+
+#include "graphics/scaler.h"
+
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * Runs a scaler over large rectangles on several threads at once.
+ *
+ * A rectangle is split into horizontal bands which are scaled in parallel,
+ * the calling thread scaling one of them itself. This does not need any
+ * overlap between the bands: scalers only read the pixels around a band
+ * from the source surface, which is not modified while scaling, and each
+ * band writes to its own rows of the destination.
+ *
+ * Scalers with internal state (like the NASM versions of HQ2x and HQ3x)
+ * are always run directly on the calling thread; see isThreadSafe().
+ */
+class SdlScalerPool {
+public:
+	SdlScalerPool();
+	~SdlScalerPool();
+
+	/**
+	 * Check whether the given scaler can be run on multiple threads.
+	 */
+	static bool isThreadSafe(ScalerProc *scalerProc);
+
+	/**
+	 * Scale the given rectangle, using the same arguments as ScalerProc.
+	 * Returns once the whole rectangle has been scaled. Small rectangles
+	 * are scaled directly on the calling thread.
+	 *
+	 * @param scaleFactor	scale factor of scalerProc, used to compute
+	 *                      the destination rows of each band
+	 */
+	void scale(ScalerProc *scalerProc, int scaleFactor, const uint8 *srcPtr, uint32 srcPitch,
+	           uint8 *dstPtr, uint32 dstPitch, int width, int height);
+
+private:
+	enum {
+		/** Maximal number of worker threads, in addition to the caller */
+		kMaxWorkers = 7,
+		/** Rectangles with fewer source pixels are scaled directly */
+		kMinParallelArea = 320 * 50,
+		/** Minimal number of source lines of a band */
+		kMinBandHeight = 16
+	};
+
+	struct Band {
+		ScalerProc *scalerProc;
+		const uint8 *srcPtr;
+		uint32 srcPitch;
+		uint8 *dstPtr;
+		uint32 dstPitch;
+		int width;
+		int height;
+	};
+
+	static int SDLCALL workerThread(void *data);
+
+	/**
+	 * Take the next pending band and scale it.
+	 * @return false if there was no pending band.
+	 */
+	bool runBand();
+
+	int _numWorkers;
+	SDL_Thread *_workers[kMaxWorkers];
+	bool _quit;
+
+	/** Protects the band list */
+	SDL_mutex *_mutex;
+	/** Signalled once per posted band, and once per worker on shutdown */
+	SDL_sem *_workSem;
+	/** Signalled by the workers whenever they finished a band */
+	SDL_sem *_doneSem;
+
+	Band _bands[kMaxWorkers + 1];
+	int _numBands;
+	int _nextBand;
+};
+
+#endif
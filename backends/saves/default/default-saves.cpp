@@ -220,6 +220,25 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 }
 
+bool DefaultSaveFileManager::getSavefileStatus(const Common::String &filename, uint32 &size, uint32 &modificationTime) {
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return false;
+
+	for (Common::StringArray::const_iterator i = _lockedFiles.begin(), end = _lockedFiles.end(); i != end; ++i) {
+		if (filename == *i) {
+			return false; //file is locked, its contents may still change
+		}
+	}
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
+	if (file == _saveFileCache.end())
+		return false;
+
+	return file->_value.getFileStatus(size, modificationTime);
+}
+
 Common::String DefaultSaveFileManager::getSavePath() const {
 
 	Common::String dir;
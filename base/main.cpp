@@ -32,7 +32,9 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
 #include "engines/engine.h"
+#include "engines/filepropertiescache.h"
 #include "engines/metaengine.h"
+#include "engines/savestateindex.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
 #include "base/version.h"
@@ -616,6 +618,9 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Cloud::CloudManager::destroy();
 #endif
 #endif
+	FilePropsCache.flush(true);
+	FilePropertiesCache::destroy();
+	SaveStateIndex::destroy();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
 	GUI::GuiManager::destroy();
@@ -445,6 +445,7 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 
 // Engine plugins
 
+#include "engines/filepropertiescache.h"
 #include "engines/metaengine.h"
 
 namespace Common {
@@ -535,6 +536,9 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist) const
 		}
 	} while (PluginManager::instance().loadNextPlugin());
 
+	// When scanning many directories, this only writes every few seconds
+	FilePropsCache.flush();
+
 	return DetectionResults(candidates);
 }
 
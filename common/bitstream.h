@@ -232,6 +232,16 @@ public:
 	 * The bit order is the same as in getBits().
 	 */
 	uint32 peekBits(uint8 n) {
+		// Most of the time, the bits are all in the current value
+		if (_inValue && n <= valueBits - _inValue) {
+			if (n == 0)
+				return 0;
+			if (isMSB2LSB)
+				return _value >> (32 - n);
+			else
+				return _value & (0xFFFFFFFF >> (32 - n));
+		}
+
 		uint32 value   = _value;
 		uint8  inValue = _inValue;
 		uint32 curStreamPos  = _stream->pos();
@@ -279,6 +289,18 @@ public:
 
 	/** Skip the specified amount of bits. */
 	void skip(uint32 n) {
+		// Skip within the current value at once, if possible
+		if (_inValue && n <= (uint32)(valueBits - _inValue)) {
+			if (isMSB2LSB)
+				_value <<= n;
+			else
+				_value >>= n;
+
+			_inValue = (_inValue + n) % valueBits;
+			_pos += n;
+			return;
+		}
+
 		while (n-- > 0)
 			getBit();
 	}
@@ -299,6 +321,11 @@ public:
 		return _size;
 	}
 
+	/** Return whether the bits of each value are read from the MSB to the LSB. */
+	static bool isMSBFirst() {
+		return isMSB2LSB;
+	}
+
 	bool eos() const {
 		return _stream->eos() || (_pos >= _size);
 	}
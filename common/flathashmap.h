@@ -0,0 +1,526 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/func.h"
+
+namespace Common {
+
+/**
+ * FlatHashMap<Key,Val> has the same interface as HashMap<Key,Val>, but a
+ * different memory layout: the keys and values
+ * are stored directly in one array, instead of in separately allocated
+ * nodes referenced from the hash table. Next to it, a byte per slot holds
+ * its state and a few bits of the hash of its key, so most mismatching
+ * slots are skipped without comparing keys.
+ *
+ * This makes lookups cheaper, at the cost of copying the keys and values
+ * whenever the table is resized. It is best suited for maps with small
+ * keys and values, like sets of addresses.
+ *
+ * Like with HashMap, erasing an element does not invalidate iterators
+ * pointing to other elements, but adding one may invalidate all of them.
+ * Unlike with HashMap, references to values are invalidated by adding
+ * elements, too. So it is no replacement for maps whose users keep such
+ * references, like the configuration domains: code like
+ * setVal(key, getVal(otherKey)) would read a value the insertion moved.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+		Node(const Node &node) : _key(node._key), _value(node._value) {}
+
+	private:
+		Node &operator=(const Node &);
+	};
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up before being
+		// increased automatically. Erased slots count as filled until
+		// the storage is rebuilt.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	/** Slot states; used slots store kSlotUsed plus seven bits of the hash. */
+	enum {
+		kSlotEmpty = 0,
+		kSlotErased = 1,
+		kSlotUsed = 0x80
+	};
+
+	byte *_slots;		///< State of each slot
+	Node *_nodes;		///< Storage for the nodes, only constructed for used slots
+	size_type _mask;	///< Capacity of the HashMap minus one; must be a power of two of minus one
+	size_type _size;
+	size_type _erased;	///< Number of slots marked as kSlotErased
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Default value, returned by the const getVal. */
+	const Val _defaultVal;
+
+	static byte slotTag(size_type hash) {
+		// The low bits select the slot already, so use others
+		return kSlotUsed | (((hash >> 24) ^ (hash >> 7)) & 0x7F);
+	}
+
+	bool isUsed(size_type idx) const {
+		return (_slots[idx] & kSlotUsed) != 0;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void resizeStorage(size_type newCapacity);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->isUsed(_idx));
+			return &_hashmap->_nodes[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !_hashmap->isUsed(_idx));
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getVal(const Key &key, const Val &defaultVal) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isUsed(ctr))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isUsed(ctr))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage of the given capacity.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_slots = new byte[capacity];
+	memset(_slots, kSlotEmpty, capacity);
+	_nodes = (Node *)malloc(capacity * sizeof(Node));
+	assert(_nodes != nullptr);
+
+	_size = 0;
+	_erased = 0;
+}
+
+/**
+ * Internal method for destroying all nodes and freeing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(ctr))
+			_nodes[ctr].~Node();
+	}
+
+	delete[] _slots;
+	free(_nodes);
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Copy the nodes to the same slots, so the probe sequences stay intact.
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (map.isUsed(ctr))
+			new (&_nodes[ctr]) Node(map._nodes[ctr]);
+	}
+	memcpy(_slots, map._slots, _mask + 1);
+	_size = map._size;
+	_erased = map._erased;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(ctr))
+			_nodes[ctr].~Node();
+	}
+	memset(_slots, kSlotEmpty, _mask + 1);
+
+	_size = 0;
+	_erased = 0;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::resizeStorage(size_type newCapacity) {
+	assert(newCapacity >= _mask + 1);
+
+#ifndef NDEBUG
+	const size_type old_size = _size;
+#endif
+	const size_type old_mask = _mask;
+	byte *old_slots = _slots;
+	Node *old_nodes = _nodes;
+
+	allocStorage(newCapacity);
+
+	// rehash all the old elements
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (!(old_slots[ctr] & kSlotUsed))
+			continue;
+
+		// Insert the element from the old table into the new table.
+		// Since we know that no key exists twice in the old table, and
+		// that the new one has no erased slots, we just need to find the
+		// first empty slot.
+		const size_type hash = _hash(old_nodes[ctr]._key);
+		size_type idx = hash & _mask;
+		while (_slots[idx] != kSlotEmpty)
+			idx = (idx + 1) & _mask;
+
+		new (&_nodes[idx]) Node(old_nodes[ctr]);
+		_slots[idx] = slotTag(hash);
+		_size++;
+
+		old_nodes[ctr].~Node();
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == old_size);
+
+	delete[] old_slots;
+	free(old_nodes);
+}
+
+/**
+ * Find the slot of the given key.
+ * @return the slot index, or _mask + 1 if the key is not contained.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = _hash(key);
+	const byte tag = slotTag(hash);
+
+	// Linear probing; there always is at least one empty slot, which ends
+	// the search.
+	for (size_type ctr = hash & _mask; ; ctr = (ctr + 1) & _mask) {
+		if (_slots[ctr] == kSlotEmpty)
+			return _mask + 1;
+		if (_slots[ctr] == tag && _equal(_nodes[ctr]._key, key))
+			return ctr;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = _hash(key);
+	const byte tag = slotTag(hash);
+	const size_type NONE_FOUND = _mask + 1;
+	size_type first_free = NONE_FOUND;
+
+	size_type ctr = hash & _mask;
+	for (; _slots[ctr] != kSlotEmpty; ctr = (ctr + 1) & _mask) {
+		if (_slots[ctr] == kSlotErased) {
+			if (first_free == NONE_FOUND)
+				first_free = ctr;
+		} else if (_slots[ctr] == tag && _equal(_nodes[ctr]._key, key)) {
+			return ctr;
+		}
+	}
+
+	if (first_free != NONE_FOUND) {
+		ctr = first_free;
+		_erased--;
+	}
+
+	new (&_nodes[ctr]) Node(key);
+	_slots[ctr] = tag;
+	_size++;
+
+	// Keep the load factor below a certain threshold.
+	// Erased slots are also counted
+	size_type capacity = _mask + 1;
+	if ((_size + _erased) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only grow if the used slots alone need it, otherwise getting
+		// rid of the erased slots is enough.
+		if (_size * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+		resizeStorage(capacity);
+		ctr = lookup(key);
+		assert(ctr <= _mask);
+	}
+
+	return ctr;
+}
+
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) <= _mask;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _nodes[ctr]._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	return getVal(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _nodes[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_nodes[ctr]._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(isUsed(ctr));
+
+	_nodes[ctr].~Node();
+	_size--;
+
+	// A slot followed by an empty one is not part of any other probe
+	// sequence, so it can become empty, too. The same then holds for the
+	// erased slots before it. Otherwise mark it as erased.
+	if (_slots[(ctr + 1) & _mask] == kSlotEmpty) {
+		_slots[ctr] = kSlotEmpty;
+		for (size_type prev = (ctr - 1) & _mask; _slots[prev] == kSlotErased; prev = (prev - 1) & _mask) {
+			_slots[prev] = kSlotEmpty;
+			_erased--;
+		}
+	} else {
+		_slots[ctr] = kSlotErased;
+		_erased++;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		erase(iterator(ctr, this));
+}
+
+} // End of namespace Common
+
+#endif
@@ -125,6 +125,10 @@ bool FSNode::isWritable() const {
 	return _realNode && _realNode->isWritable();
 }
 
+bool FSNode::getFileStatus(uint32 &size, uint32 &modificationTime) const {
+	return _realNode && _realNode->getFileStatus(size, modificationTime);
+}
+
 SeekableReadStream *FSNode::createReadStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -191,8 +195,9 @@ FSNode *FSDirectory::lookupCache(NodeCache &cache, const String &name) const {
 	if (!name.empty()) {
 		ensureCached();
 
-		if (cache.contains(name))
-			return &cache[name];
+		NodeCache::iterator it = cache.find(name);
+		if (it != cache.end())
+			return &it->_value;
 	}
 
 	return nullptr;
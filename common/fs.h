@@ -213,6 +213,15 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Query the size of the file referred by this node and the time it was
+	 * last modified at. Not all file systems support this. The time is only
+	 * meant for detecting changes, by comparing it to an earlier query.
+	 *
+	 * @return true if the values were retrieved, false otherwise.
+	 */
+	bool getFileStatus(uint32 &size, uint32 &modificationTime) const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -45,6 +45,9 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 
 	assert(maxLength <= 32);
 
+	_maxLength = maxLength;
+	_tableBits = MIN<uint8>(maxLength, kMaxTableBits);
+
 	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
 
@@ -58,6 +61,8 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 		// And put the pointer to the symbol/code struct into the symbol list.
 		_symbols[i] = &_codes[lengths[i] - 1].back();
 	}
+
+	buildTables();
 }
 
 Huffman::~Huffman() {
@@ -66,6 +71,83 @@ Huffman::~Huffman() {
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (uint32 i = 0; i < _symbols.size(); i++)
 		_symbols[i]->symbol = symbols ? *symbols++ : i;
+
+	buildTables();
+}
+
+void Huffman::buildTables() {
+	Array<Fragment> codes;
+	for (uint32 i = 0; i < _codes.size(); i++) {
+		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode) {
+			Fragment fragment = { cCode->code, (uint8)(i + 1), cCode->symbol };
+			codes.push_back(fragment);
+		}
+	}
+
+	_tableMSB.clear();
+	_tableLSB.clear();
+	buildTable(_tableMSB, 0, _tableBits, codes, true);
+	buildTable(_tableLSB, 0, _tableBits, codes, false);
+}
+
+void Huffman::buildTable(Table &table, uint32 offset, uint8 width, const Array<Fragment> &codes, bool msbFirst) {
+	const TableEntry empty = { 0, 0, 0 };
+	table.resize(offset + (1 << width));
+	for (uint32 i = 0; i < (1u << width); i++)
+		table[offset + i] = empty;
+
+	// The codes longer than the table, by the index of the entry they start in
+	Array<Array<Fragment> > longCodes;
+
+	for (uint32 i = 0; i < codes.size(); i++) {
+		const Fragment &fragment = codes[i];
+
+		if (fragment.length <= width) {
+			// The code occupies every entry its bits are a prefix of. The
+			// first bit of the stream is the highest bit of the index in a
+			// MSB first stream, and the lowest bit in a LSB first one.
+			const uint32 count = 1 << (width - fragment.length);
+			const TableEntry entry = { fragment.symbol, fragment.length, 0 };
+			for (uint32 j = 0; j < count; j++) {
+				const uint32 index = msbFirst ? ((fragment.code << (width - fragment.length)) | j) : (fragment.code | (j << fragment.length));
+				table[offset + index] = entry;
+			}
+			continue;
+		}
+
+		// Split off the bits looked up in this table
+		const uint8 restLength = fragment.length - width;
+		Fragment rest;
+		uint32 index;
+		if (msbFirst) {
+			index = fragment.code >> restLength;
+			rest.code = fragment.code & ((1u << restLength) - 1);
+		} else {
+			index = fragment.code & ((1u << width) - 1);
+			rest.code = fragment.code >> width;
+		}
+		rest.length = restLength;
+		rest.symbol = fragment.symbol;
+
+		if (longCodes.empty())
+			longCodes.resize(1 << width);
+		longCodes[index].push_back(rest);
+	}
+
+	for (uint32 i = 0; i < longCodes.size(); i++) {
+		if (longCodes[i].empty())
+			continue;
+
+		uint8 subBits = 0;
+		for (uint32 j = 0; j < longCodes[i].size(); j++)
+			subBits = MAX(subBits, longCodes[i][j].length);
+		subBits = MIN<uint8>(subBits, kMaxTableBits);
+
+		const uint32 subOffset = table.size();
+		table[offset + i].value = subOffset;
+		table[offset + i].subBits = subBits;
+		buildTable(table, subOffset, subBits, longCodes[i], msbFirst);
+	}
 }
 
 } // End of namespace Common
@@ -34,6 +34,11 @@ namespace Common {
 /**
  * Huffman bitstream decoding
  *
+ * Symbols are decoded through lookup tables indexed by the next few bits
+ * of the stream, with codes longer than that continued in sub tables. As
+ * the order of the bits within the table index depends on the stream, a
+ * set of tables is kept for MSB first and for LSB first streams each.
+ *
  * Used in engines:
  *  - scumm
  */
@@ -56,6 +61,30 @@ public:
 	/** Return the next symbol in the bitstream. */
 	template<class BITSTREAM>
 	uint32 getSymbol(BITSTREAM &bits) const {
+		// The tables may look at more bits than the code is long, which
+		// must not run past the end of the stream
+		if (bits.size() - bits.pos() >= _maxLength) {
+			const TableEntry *table = BITSTREAM::isMSBFirst() ? _tableMSB.begin() : _tableLSB.begin();
+			uint32 offset = 0;
+			uint8 width = _tableBits;
+
+			for (;;) {
+				const TableEntry &entry = table[offset + bits.peekBits(width)];
+				if (entry.length) {
+					bits.skip(entry.length);
+					return entry.value;
+				}
+				if (!entry.subBits)
+					break;
+
+				bits.skip(width);
+				offset = entry.value;
+				width = entry.subBits;
+			}
+
+			error("Unknown Huffman code");
+		}
+
 		uint32 code = 0;
 
 		for (uint32 i = 0; i < _codes.size(); i++) {
@@ -87,6 +116,41 @@ private:
 
 	/** Sorted list of pointers to the symbols. */
 	SymbolList _symbols;
+
+	enum {
+		/** Maximal number of bits looked up at once */
+		kMaxTableBits = 9
+	};
+
+	struct TableEntry {
+		uint32 value;   ///< The symbol, or the offset of the sub table.
+		uint8 length;   ///< Number of bits of the code in this table, 0 if there is no code.
+		uint8 subBits;  ///< Number of bits indexing the sub table, 0 if there is none.
+	};
+
+	/** A code, or the part of it still to be looked up. */
+	struct Fragment {
+		uint32 code;
+		uint8 length;
+		uint32 symbol;
+	};
+
+	typedef Array<TableEntry> Table;
+
+	/** Rebuild both sets of lookup tables from _codes. */
+	void buildTables();
+
+	/**
+	 * Fill a table with the given codes, appending sub tables for the
+	 * codes longer than its width.
+	 */
+	static void buildTable(Table &table, uint32 offset, uint8 width, const Array<Fragment> &codes, bool msbFirst);
+
+	uint8 _maxLength;
+	uint8 _tableBits;
+
+	Table _tableMSB;
+	Table _tableLSB;
 };
 
 } // End of namespace Common
@@ -75,6 +75,28 @@ public:
 	uint getRandomNumberRng(uint min, uint max);
 };
 
+/**
+ * Pseudo random numbers from a fixed seed, for tests and benchmarks which
+ * need the same input data on every run. Unlike RandomSource, it does not
+ * need an OSystem and is not registered with the event recorder.
+ */
+class XorShiftRandom {
+private:
+	uint32 _state;
+
+public:
+	/** The seed must not be zero. */
+	explicit XorShiftRandom(uint32 seed) : _state(seed) {}
+
+	/** @return the next number of the xorshift32 sequence */
+	uint32 next() {
+		_state ^= _state << 13;
+		_state ^= _state >> 17;
+		_state ^= _state << 5;
+		return _state;
+	}
+};
+
 } // End of namespace Common
 
 #endif
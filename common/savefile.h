@@ -204,6 +204,20 @@ public:
 	 * for saving or loading because they are being synced by CloudManager.
 	 */
 	virtual void updateSavefilesList(StringArray &lockedFiles) = 0;
+
+	/**
+	 * Query the size and the modification time of the given savefile,
+	 * without opening it. Both values are only meant to detect whether the
+	 * file changed since an earlier query, e.g. to validate cached
+	 * information about its contents.
+	 *
+	 * @param name              The name of the savefile.
+	 * @param size              Receives the size of the file.
+	 * @param modificationTime  Receives the time of the last modification.
+	 * @return true if the values were retrieved, false if the file does
+	 *         not exist or the backend cannot tell.
+	 */
+	virtual bool getSavefileStatus(const String &name, uint32 &size, uint32 &modificationTime) { return false; }
 };
 
 } // End of namespace Common
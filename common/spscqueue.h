@@ -0,0 +1,174 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_SPSCQUEUE_H
+#define COMMON_SPSCQUEUE_H
+
+#include "common/scummsys.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Common {
+
+/**
+ * Full memory barrier: no load or store is moved across it, neither by the
+ * compiler nor by the CPU.
+ *
+ * On compilers we know nothing about, this degrades to nothing. Those are
+ * only used for single core targets, where the volatile accesses done by
+ * the users of this function are enough.
+ */
+inline void memoryBarrier() {
+#if defined(__GNUC__)
+	__sync_synchronize();
+#elif defined(_MSC_VER)
+	// These are the intrinsics MemoryBarrier() from <windows.h> expands to.
+	// _ReadWriteBarrier() alone only stops the compiler, which is not
+	// enough on ARM.
+#if defined(_M_ARM64)
+	__dmb(_ARM64_BARRIER_SY);
+#elif defined(_M_ARM)
+	__dmb(_ARM_BARRIER_SY);
+#elif defined(_M_X64)
+	__faststorefence();
+#else
+	long barrier = 0;
+	_InterlockedOr(&barrier, 0);
+#endif
+#endif
+}
+
+/**
+ * Fixed size, wait-free queue for passing values from exactly one producer
+ * thread to exactly one consumer thread.
+ *
+ * Neither push() nor pop() ever block or allocate memory, which makes this
+ * suitable for communicating with real-time threads like the audio mixer.
+ * If more than one thread needs to push (or pop), the callers have to
+ * serialize those threads themselves, e.g. with a Common::Mutex.
+ *
+ * @tparam T    the element type; it is copied in and out of the queue.
+ * @tparam SIZE the capacity of the queue; must be a power of two.
+ */
+template<class T, uint SIZE>
+class SPSCQueue {
+public:
+	SPSCQueue() : _head(0), _tail(0) {
+		STATIC_ASSERT((SIZE & (SIZE - 1)) == 0, SPSCQueue_size_must_be_a_power_of_two);
+	}
+
+	/**
+	 * Append an element at the end of the queue.
+	 * May only be called from the producer thread.
+	 *
+	 * @return false if the queue is full and the element was not added.
+	 */
+	bool push(const T &value) {
+		const uint32 head = _head;
+		if (head - _tail == SIZE)
+			return false;
+
+		// Make sure the consumer is done reading the element we are about
+		// to overwrite before writing it.
+		memoryBarrier();
+		_storage[head & (SIZE - 1)] = value;
+
+		// Publish the element only after it was completely written.
+		memoryBarrier();
+		_head = head + 1;
+		return true;
+	}
+
+	/**
+	 * Remove the element at the front of the queue.
+	 * May only be called from the consumer thread.
+	 *
+	 * @return false if the queue is empty and nothing was removed.
+	 */
+	bool pop(T &value) {
+		const uint32 tail = _tail;
+		if (_head == tail)
+			return false;
+
+		memoryBarrier();
+		value = _storage[tail & (SIZE - 1)];
+
+		// Only hand the slot back to the producer after we copied it.
+		memoryBarrier();
+		_tail = tail + 1;
+		return true;
+	}
+
+	/**
+	 * Copy the element at the front of the queue, without removing it.
+	 * May only be called from the consumer thread.
+	 *
+	 * @return false if the queue is empty.
+	 */
+	bool peek(T &value) const {
+		const uint32 tail = _tail;
+		if (_head == tail)
+			return false;
+
+		memoryBarrier();
+		value = _storage[tail & (SIZE - 1)];
+		return true;
+	}
+
+	/**
+	 * Check whether the queue is empty. Only a snapshot when called from
+	 * the producer thread.
+	 */
+	bool empty() const {
+		return _head == _tail;
+	}
+
+	/**
+	 * Check whether the queue is full. Only a snapshot when called from
+	 * the consumer thread.
+	 */
+	bool full() const {
+		return _head - _tail == SIZE;
+	}
+
+	/**
+	 * Return the number of queued elements. Only a snapshot unless called
+	 * while both threads are idle.
+	 */
+	uint size() const {
+		return _head - _tail;
+	}
+
+private:
+	T _storage[SIZE];
+
+	/** Number of elements ever pushed; only written by the producer. */
+	volatile uint32 _head;
+	/** Number of elements ever popped; only written by the consumer. */
+	volatile uint32 _tail;
+};
+
+} // End of namespace Common
+
+#endif
@@ -90,6 +90,27 @@ String::String(const String &str)
 	assert(_str != nullptr);
 }
 
+#if __cplusplus >= 201103L
+String::String(String &&str)
+	: _size(str._size) {
+	if (str.isStorageIntern()) {
+		// String in internal storage: just copy it
+		memcpy(_storage, str._storage, _builtinCapacity);
+		_str = _storage;
+	} else {
+		// String in external storage: take it over, including the
+		// reference count if the storage is shared
+		_extern._refCount = str._extern._refCount;
+		_extern._capacity = str._extern._capacity;
+		_str = str._str;
+		str._str = str._storage;
+	}
+
+	str._storage[0] = 0;
+	str._size = 0;
+}
+#endif
+
 String::String(char c)
 	: _size(0), _str(_storage) {
 
@@ -237,6 +258,33 @@ String &String::operator=(const String &str) {
 	return *this;
 }
 
+#if __cplusplus >= 201103L
+String &String::operator=(String &&str) {
+	if (&str == this)
+		return *this;
+
+	if (str.isStorageIntern()) {
+		operator=(str);
+		str._storage[0] = 0;
+		str._size = 0;
+		return *this;
+	}
+
+	decRefCount(_extern._refCount);
+
+	_extern._refCount = str._extern._refCount;
+	_extern._capacity = str._extern._capacity;
+	_size = str._size;
+	_str = str._str;
+
+	str._str = str._storage;
+	str._storage[0] = 0;
+	str._size = 0;
+
+	return *this;
+}
+#endif
+
 String &String::operator=(char c) {
 	decRefCount(_extern._refCount);
 	_str = _storage;
@@ -756,6 +804,23 @@ String operator+(const String &x, char y) {
 	return temp;
 }
 
+#if __cplusplus >= 201103L
+String operator+(String &&x, const String &y) {
+	x += y;
+	return static_cast<String &&>(x);
+}
+
+String operator+(String &&x, const char *y) {
+	x += y;
+	return static_cast<String &&>(x);
+}
+
+String operator+(String &&x, char y) {
+	x += y;
+	return static_cast<String &&>(x);
+}
+#endif
+
 char *ltrim(char *t) {
 	while (isSpace(*t))
 		t++;
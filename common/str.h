@@ -27,6 +27,16 @@
 
 #include <stdarg.h>
 
+/**
+ * The size of a String object in bytes. Strings which fit into the object
+ * next to its length and data pointer are stored inline, without allocating
+ * memory. Ports which are very short on stack space may define a smaller
+ * size (but no less than 24) in their build flags.
+ */
+#ifndef COMMON_STRING_SIZE
+#define COMMON_STRING_SIZE 48
+#endif
+
 namespace Common {
 
 /**
@@ -62,14 +72,13 @@ protected:
 	 * The size of the internal storage. Increasing this means less heap
 	 * allocations are needed, at the cost of more stack memory usage,
 	 * and of course lots of wasted memory. Empirically, 90% or more of
-	 * all String instances are less than 32 chars long. If a platform
-	 * is very short on stack space, it would be possible to lower this.
-	 * A value of 24 still seems acceptable, though considerably worse,
-	 * while 16 seems to be the lowest you want to go... Anything lower
-	 * than 8 makes no sense, since that's the size of member _extern
+	 * all String instances are less than 32 chars long, and with the
+	 * default COMMON_STRING_SIZE of 48 bytes these fit on 64 bit systems
+	 * too. A value of 16 seems to be the lowest you want to go... Anything
+	 * lower than 8 makes no sense, since that's the size of member _extern
 	 * (on 32 bit machines; 12 bytes on systems with 64bit pointers).
 	 */
-	static const uint32 _builtinCapacity = 32 - sizeof(uint32) - sizeof(char *);
+	static const uint32 _builtinCapacity = COMMON_STRING_SIZE - sizeof(uint32) - sizeof(char *);
 
 	/**
 	 * Length of the string. Stored to avoid having to call strlen
@@ -120,6 +129,15 @@ public:
 	/** Construct a copy of the given string. */
 	String(const String &str);
 
+#if __cplusplus >= 201103L
+	/**
+	 * Construct a string taking over the contents of the given string,
+	 * which is left empty. Unlike copying, this never touches a reference
+	 * count.
+	 */
+	String(String &&str);
+#endif
+
 	/** Construct a string consisting of the given character. */
 	explicit String(char c);
 
@@ -127,6 +145,10 @@ public:
 
 	String &operator=(const char *str);
 	String &operator=(const String &str);
+#if __cplusplus >= 201103L
+	/** Take over the contents of the given string, which is left empty. */
+	String &operator=(String &&str);
+#endif
 	String &operator=(char c);
 	String &operator+=(const char *str);
 	String &operator+=(const String &str);
@@ -339,6 +361,14 @@ String operator+(const String &x, const char *y);
 String operator+(const String &x, char y);
 String operator+(char x, const String &y);
 
+#if __cplusplus >= 201103L
+// Append to a temporary string in place, so chains like a + b + c only
+// build a single string
+String operator+(String &&x, const String &y);
+String operator+(String &&x, const char *y);
+String operator+(String &&x, char y);
+#endif
+
 // Some useful additional comparison operators for Strings
 bool operator==(const char *x, const String &y);
 bool operator!=(const char *x, const String &y);
@@ -106,10 +106,15 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/substream.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #if defined(STRICTUNZIP) || defined(STRICTZIPUNZIP)
 /* like the STRICT of WIN32, we define a pointer that cannot be converted
     from (void *) without cast */
@@ -1419,12 +1424,85 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+namespace {
+
+/** Atomically add delta to value, and return the new value. */
+inline int32 atomicAdd(volatile int32 *value, int32 delta) {
+#if defined(__GNUC__)
+	return __sync_add_and_fetch(value, delta);
+#elif defined(_MSC_VER)
+	return _InterlockedExchangeAdd((volatile long *)value, delta) + delta;
+#else
+	// Like memoryBarrier() in spscqueue.h, we assume that other compilers
+	// are only used for single core targets.
+	return *value += delta;
+#endif
+}
+
+/**
+ * Counts the streams of stored files which have a file handle of their
+ * own. The archive and each of these streams hold a reference. The
+ * streams may be destroyed on other threads and after the archive, hence
+ * the atomic updates.
+ */
+class ZipHandleCounter {
+	volatile int32 _refs;
+
+public:
+	ZipHandleCounter() : _refs(1) {}
+
+	int32 getHandleCount() const { return _refs - 1; }
+
+	void ref() { atomicAdd(&_refs, 1); }
+
+	void unref() {
+		if (atomicAdd(&_refs, -1) == 0)
+			delete this;
+	}
+};
+
+/** Stream of a stored file, reading from a file handle of its own */
+class ZipStoredFileStream : public SeekableSubReadStream {
+	ZipHandleCounter *_counter;
+
+public:
+	ZipStoredFileStream(SeekableReadStream *file, uint32 begin, uint32 end, ZipHandleCounter *counter)
+		: SeekableSubReadStream(file, begin, end), _counter(counter) {
+		_counter->ref();
+	}
+
+	~ZipStoredFileStream() {
+		// Close the handle before it stops being counted
+		delete _parentStream;
+		_counter->unref();
+	}
+};
+
+} // End of anonymous namespace
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
 
+	/**
+	 * The archive file, if it can be opened again. Each stream for a file
+	 * stored uncompressed then reads from a stream of its own, so they can
+	 * be used from different threads.
+	 */
+	ArchiveMemberPtr _source;
+
+	/**
+	 * The streams of stored files with a handle of their own. Beyond
+	 * kMaxStoredFileHandles of them, stored files are copied to memory
+	 * like compressed ones, so we do not run out of file handles.
+	 */
+	ZipHandleCounter *_handles;
+
 public:
-	ZipArchive(unzFile zipFile);
+	enum {
+		kMaxStoredFileHandles = 16
+	};
+
+	ZipArchive(unzFile zipFile, const ArchiveMemberPtr &source);
 
 
 	~ZipArchive();
@@ -1453,16 +1531,20 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
+ZipArchive::ZipArchive(unzFile zipFile, const ArchiveMemberPtr &source) : _zipFile(zipFile), _source(source), _handles(new ZipHandleCounter()) {
 	assert(_zipFile);
 }
 
 ZipArchive::~ZipArchive() {
 	unzClose(_zipFile);
+	_handles->unref();
 }
 
 bool ZipArchive::hasFile(const String &name) const {
-	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
+	// Look the file up directly instead of through unzLocateFile, which
+	// would also make it the current file.
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	return archive->_hash.contains(name);
 }
 
 int ZipArchive::listMembers(ArchiveMemberList &list) const {
@@ -1490,10 +1572,35 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 		return nullptr;
 
 	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
+	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
 		return nullptr;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	if (fileInfo.compression_method == 0 && _source && _handles->getHandleCount() < kMaxStoredFileHandles) {
+		// Stored files need no decompression, so there is no need to copy
+		// them to memory either. They get their own stream of the archive
+		// file, as the one of the archive is not safe to share.
+		unz_s *const archive = (unz_s *)_zipFile;
+		uInt localHeaderVarSize;
+		uLong localExtraFieldOffset;
+		uInt localExtraFieldSize;
+		if (unzlocal_CheckCurrentFileCoherencyHeader(archive, &localHeaderVarSize,
+				&localExtraFieldOffset, &localExtraFieldSize) != UNZ_OK)
+			return nullptr;
+
+		const uint32 begin = archive->byte_before_the_zipfile + archive->cur_file_info_internal.offset_curfile +
+		                     SIZEZIPLOCALHEADER + localHeaderVarSize;
+		const uint32 end = begin + fileInfo.uncompressed_size;
+		if (end > (uint32)archive->_stream->size())
+			return nullptr;
+
+		SeekableReadStream *file = _source->createReadStream();
+		if (file)
+			return new ZipStoredFileStream(file, begin, end, _handles);
+
+		// Copy the file to memory instead
+	}
+
+	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return nullptr;
 
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
@@ -1517,15 +1624,7 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	// files in the archive and tries to use them independently.
 }
 
-Archive *makeZipArchive(const String &name) {
-	return makeZipArchive(SearchMan.createReadStreamForMember(name));
-}
-
-Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
-}
-
-Archive *makeZipArchive(SeekableReadStream *stream) {
+static Archive *makeZipArchive(SeekableReadStream *stream, const ArchiveMemberPtr &source) {
 	if (!stream)
 		return nullptr;
 	unzFile zipFile = unzOpen(stream);
@@ -1534,7 +1633,22 @@ Archive *makeZipArchive(SeekableReadStream *stream) {
 		// goes wrong.
 		return nullptr;
 	}
-	return new ZipArchive(zipFile);
+	return new ZipArchive(zipFile, source);
+}
+
+Archive *makeZipArchive(const String &name) {
+	const ArchiveMemberPtr member = SearchMan.getMember(name);
+	if (!member)
+		return nullptr;
+	return makeZipArchive(member->createReadStream(), member);
+}
+
+Archive *makeZipArchive(const FSNode &node) {
+	return makeZipArchive(node.createReadStream(), ArchiveMemberPtr(new FSNode(node)));
+}
+
+Archive *makeZipArchive(SeekableReadStream *stream) {
+	return makeZipArchive(stream, ArchiveMemberPtr());
 }
 
 } // End of namespace Common
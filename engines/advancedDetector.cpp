@@ -31,6 +31,7 @@
 #include "common/translation.h"
 #include "gui/EventRecorder.h"
 #include "engines/advancedDetector.h"
+#include "engines/filepropertiescache.h"
 #include "engines/obsolete.h"
 
 static Common::String sanitizeName(const char *name) {
@@ -371,14 +372,8 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
-	Common::File testFile;
-
-	if (!testFile.open(allFiles[fname]))
-		return false;
-
-	fileProps.size = (int32)testFile.size();
-	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
-	return true;
+	// Other engines may have looked at the same file already
+	return FilePropsCache.getFileProperties(allFiles[fname], _md5Bytes, fileProps);
 }
 
 ADDetectedGames AdvancedMetaEngine::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra) const {
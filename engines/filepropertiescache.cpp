@@ -0,0 +1,211 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/filepropertiescache.h"
+
+#include "common/algorithm.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/md5.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+namespace Common {
+DECLARE_SINGLETON(FilePropertiesCache);
+}
+
+static const char *const kCacheFileName = "scummvm-detection.cache";
+static const uint32 kCacheVersion = 2;
+
+static void writeString(Common::WriteStream *out, const Common::String &str) {
+	out->writeUint16BE(str.size());
+	out->writeString(str);
+}
+
+static Common::String readString(Common::ReadStream *in) {
+	const uint16 size = in->readUint16BE();
+	Common::String str;
+	for (uint16 i = 0; i < size && !in->eos(); i++)
+		str += (char)in->readByte();
+	return str;
+}
+
+FilePropertiesCache::FilePropertiesCache() : _useCount(0), _loaded(false), _dirty(false), _lastFlush(0) {
+}
+
+bool FilePropertiesCache::getFileProperties(const Common::FSNode &node, uint md5Bytes, FileProperties &fileProps) {
+	uint32 fileSize, modificationTime;
+	const Common::String key = Common::String::format("%u:%s", md5Bytes, node.getPath().c_str());
+	const bool haveStatus = node.getFileStatus(fileSize, modificationTime) && key.size() <= 0xFFFF;
+
+	if (haveStatus) {
+		if (!_loaded)
+			load();
+
+		if (lookup(key, fileSize, modificationTime, fileProps))
+			return true;
+	}
+
+	Common::File testFile;
+	if (!testFile.open(node))
+		return false;
+
+	fileProps.size = (int32)testFile.size();
+	fileProps.md5 = Common::computeStreamMD5AsString(testFile, md5Bytes);
+
+	if (haveStatus)
+		store(key, fileSize, modificationTime, fileProps);
+
+	return true;
+}
+
+bool FilePropertiesCache::lookup(const Common::String &key, uint32 fileSize, uint32 modificationTime, FileProperties &fileProps) {
+	EntryMap::iterator it = _entries.find(key);
+	if (it == _entries.end() || it->_value.fileSize != fileSize || it->_value.modificationTime != modificationTime)
+		return false;
+
+	// The new order is only written along with the next changed entry, a
+	// scan finding all files unchanged does not rewrite the cache
+	it->_value.lastUsed = ++_useCount;
+	fileProps = it->_value.properties;
+	return true;
+}
+
+void FilePropertiesCache::store(const Common::String &key, uint32 fileSize, uint32 modificationTime, const FileProperties &fileProps) {
+	if (_entries.size() >= kMaxEntries && !_entries.contains(key))
+		prune(kMaxEntries * 3 / 4);
+
+	Entry &entry = _entries[key];
+	entry.fileSize = fileSize;
+	entry.modificationTime = modificationTime;
+	entry.lastUsed = ++_useCount;
+	entry.properties = fileProps;
+	_dirty = true;
+}
+
+void FilePropertiesCache::prune(uint maxEntries) {
+	if (_entries.size() <= maxEntries)
+		return;
+
+	Common::Array<uint32> uses;
+	uses.reserve(_entries.size());
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+		uses.push_back(it->_value.lastUsed);
+	Common::sort(uses.begin(), uses.end());
+
+	// Entries read from the disk may share their counter with newer ones,
+	// so this may keep a few more
+	const uint32 threshold = uses[_entries.size() - maxEntries];
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		if (it->_value.lastUsed < threshold)
+			_entries.erase(it);
+	}
+
+	debug(1, "FilePropertiesCache: Pruned to %u entries", _entries.size());
+	_dirty = true;
+}
+
+void FilePropertiesCache::load() {
+	// Command line detection runs before the backend created the savefile
+	// manager, the cache is only kept in memory then
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+	_loaded = true;
+
+	Common::InSaveFile *in = saveFileMan->openForLoading(kCacheFileName);
+	if (!in)
+		return;
+
+	if (!loadFrom(*in))
+		debug(1, "FilePropertiesCache: Ignoring outdated cache file");
+	delete in;
+}
+
+bool FilePropertiesCache::loadFrom(Common::ReadStream &in) {
+	if (in.readUint32BE() != MKTAG('F', 'P', 'C', 'H') || in.readUint32BE() != kCacheVersion)
+		return false;
+
+	const uint32 count = in.readUint32BE();
+	for (uint32 i = 0; i < count && !in.eos() && !in.err(); i++) {
+		Common::String key = readString(&in);
+		Entry entry;
+		entry.fileSize = in.readUint32BE();
+		entry.modificationTime = in.readUint32BE();
+		entry.lastUsed = in.readUint32BE();
+		entry.properties.size = in.readSint32BE();
+		entry.properties.md5 = readString(&in);
+
+		if (in.eos() || in.err())
+			break;
+		// Entries computed before loading are more recent
+		if (!_entries.contains(key))
+			_entries[key] = entry;
+		_useCount = MAX(_useCount, entry.lastUsed);
+	}
+
+	prune(kMaxEntries);
+	return true;
+}
+
+void FilePropertiesCache::saveTo(Common::WriteStream &out) const {
+	out.writeUint32BE(MKTAG('F', 'P', 'C', 'H'));
+	out.writeUint32BE(kCacheVersion);
+	out.writeUint32BE(_entries.size());
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		writeString(&out, it->_key);
+		out.writeUint32BE(it->_value.fileSize);
+		out.writeUint32BE(it->_value.modificationTime);
+		out.writeUint32BE(it->_value.lastUsed);
+		out.writeSint32BE(it->_value.properties.size);
+		writeString(&out, it->_value.properties.md5);
+	}
+}
+
+void FilePropertiesCache::flush(bool force) {
+	if (!_dirty)
+		return;
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	const uint32 now = g_system->getMillis();
+	if (!saveFileMan || (!force && now - _lastFlush < kFlushInterval))
+		return;
+
+	// Merge with what is on disk before overwriting it
+	if (!_loaded)
+		load();
+
+	Common::OutSaveFile *out = saveFileMan->openForSaving(kCacheFileName, false);
+	if (!out) {
+		warning("FilePropertiesCache: Could not write '%s'", kCacheFileName);
+		return;
+	}
+
+	saveTo(*out);
+	out->finalize();
+	delete out;
+
+	_dirty = false;
+	_lastFlush = now;
+}
@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_FILEPROPERTIESCACHE_H
+#define ENGINES_FILEPROPERTIESCACHE_H
+
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+#include "engines/game.h"
+
+namespace Common {
+class FSNode;
+class ReadStream;
+class WriteStream;
+}
+
+/**
+ * Remembers the sizes and MD5 checksums of the files looked at during game
+ * detection, across engines and across runs of ScummVM.
+ *
+ * Entries are keyed by the path of the file and the number of bytes the
+ * checksum covers. They are only used while the size and modification time
+ * of the file are unchanged, which limits the cache to file systems able
+ * to report those; see Common::FSNode::getFileStatus(). When the cache is
+ * full, the least recently used quarter of the entries is dropped.
+ *
+ * The cache is stored as a file next to the saved games.
+ *
+ * The detection runs on a single thread, as the detection code of the
+ * engines uses global state like SearchMan and the debug channels without
+ * any locking.
+ */
+class FilePropertiesCache : public Common::Singleton<FilePropertiesCache> {
+public:
+	FilePropertiesCache();
+
+	/**
+	 * Get the size and the MD5 checksum of the first md5Bytes of a file,
+	 * computing them only if the file is not in the cache or was changed.
+	 *
+	 * @return false if the file could not be read.
+	 */
+	bool getFileProperties(const Common::FSNode &node, uint md5Bytes, FileProperties &fileProps);
+
+	/**
+	 * Write the cache to disk if it was changed.
+	 *
+	 * @param force	write even if the cache was written recently.
+	 */
+	void flush(bool force = false);
+
+	/**
+	 * Get the cached properties of a file.
+	 *
+	 * @param key	the number of bytes the checksum covers and the path of the
+	 *				file, as "<md5Bytes>:<path>"
+	 * @return false if there is no entry for the file with the given size
+	 *		   and modification time.
+	 */
+	bool lookup(const Common::String &key, uint32 fileSize, uint32 modificationTime, FileProperties &fileProps);
+
+	/** Add or replace the entry of a file. */
+	void store(const Common::String &key, uint32 fileSize, uint32 modificationTime, const FileProperties &fileProps);
+
+	/**
+	 * Add the entries of a cache file, except for the files already in the
+	 * cache.
+	 *
+	 * @return false if the stream is not a cache file of this version.
+	 */
+	bool loadFrom(Common::ReadStream &in);
+
+	/** Write all entries in the format read by loadFrom(). */
+	void saveTo(Common::WriteStream &out) const;
+
+	/** Return the number of entries. */
+	uint size() const { return _entries.size(); }
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+
+	enum {
+		/** Minimal number of milliseconds between two writes, unless forced */
+		kFlushInterval = 5000,
+		/** Maximal number of entries, to keep the file from growing forever */
+		kMaxEntries = 100000
+	};
+
+	struct Entry {
+		uint32 fileSize;
+		uint32 modificationTime;
+		uint32 lastUsed;
+		FileProperties properties;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	void load();
+
+	/** Drop the least recently used entries, down to the given number. */
+	void prune(uint maxEntries);
+
+	EntryMap _entries;
+	/** Use counter, for finding the least recently used entries */
+	uint32 _useCount;
+	bool _loaded;
+	bool _dirty;
+	uint32 _lastFlush;
+};
+
+/** Shortcut for accessing the file properties cache. */
+#define FilePropsCache		FilePropertiesCache::instance()
+
+#endif
@@ -4,9 +4,11 @@ MODULE_OBJS := \
 	advancedDetector.o \
 	dialogs.o \
 	engine.o \
+	filepropertiescache.o \
 	game.o \
 	obsolete.o \
-	savestate.o
+	savestate.o \
+	savestateindex.o
 
 # Include common rules
 include $(srcdir)/rules.mk
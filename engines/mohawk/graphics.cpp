@@ -24,6 +24,7 @@
 #include "mohawk/resource.h"
 #include "mohawk/graphics.h"
 
+#include "common/debug.h"
 #include "common/system.h"
 #include "engines/util.h"
 #include "graphics/palette.h"
@@ -68,7 +69,10 @@ void MohawkSurface::convertToTrueColor() {
 	_surface = surface;
 }
 
-GraphicsManager::GraphicsManager() {
+GraphicsManager::GraphicsManager() :
+		_cacheBudget(0),
+		_cacheSize(0),
+		_cacheUseCounter(0) {
 }
 
 GraphicsManager::~GraphicsManager() {
@@ -76,8 +80,8 @@ GraphicsManager::~GraphicsManager() {
 }
 
 void GraphicsManager::clearCache() {
-	for (Common::HashMap<uint16, MohawkSurface *>::iterator it = _cache.begin(); it != _cache.end(); it++)
-		delete it->_value;
+	for (ImageCache::iterator it = _cache.begin(); it != _cache.end(); it++)
+		delete it->_value.surface;
 	for (Common::HashMap<uint16, Common::Array<MohawkSurface *> >::iterator it = _subImageCache.begin(); it != _subImageCache.end(); it++) {
 		Common::Array<MohawkSurface *> &array = it->_value;
 		for (uint i = 0; i < array.size(); i++)
@@ -86,18 +90,62 @@ void GraphicsManager::clearCache() {
 
 	_cache.clear();
 	_subImageCache.clear();
+	_cacheSize = 0;
+}
+
+void GraphicsManager::setCacheBudget(uint32 budget) {
+	_cacheBudget = budget;
+	makeRoomInCache(0);
 }
 
 MohawkSurface *GraphicsManager::findImage(uint16 id) {
-	if (!_cache.contains(id))
-		_cache[id] = decodeImage(id);
+	ImageCache::iterator it = _cache.find(id);
+	if (it != _cache.end()) {
+		it->_value.lastUse = ++_cacheUseCounter;
+		return it->_value.surface;
+	}
+
+	MohawkSurface *surface = decodeImage(id);
+	addImage(id, surface, false);
+	return surface;
+}
+
+void GraphicsManager::addImage(uint16 id, MohawkSurface *surface, bool pinned) {
+	const Graphics::Surface *pixels = surface->getSurface();
+	uint32 size = pixels ? pixels->pitch * pixels->h : 0;
+	if (surface->getPalette())
+		size += 256 * 3;
+
+	makeRoomInCache(size);
 
-	// TODO: Probably would be nice to limit the size of the cache
-	// Currently, this can't get large because it is freed on every
-	// card/stack change in Myst/Riven so I'm not worried about it.
-	// Doesn't mean this shouldn't be done in the future.
+	CachedImage &image = _cache[id];
+	image.surface = surface;
+	image.size = size;
+	image.lastUse = ++_cacheUseCounter;
+	image.pinned = pinned;
+	_cacheSize += size;
+}
+
+void GraphicsManager::makeRoomInCache(uint32 size) {
+	if (_cacheBudget == 0)
+		return;
 
-	return _cache[id];
+	while (_cacheSize + size > _cacheBudget) {
+		ImageCache::iterator oldest = _cache.end();
+		for (ImageCache::iterator it = _cache.begin(); it != _cache.end(); it++) {
+			if (!it->_value.pinned && (oldest == _cache.end() || it->_value.lastUse < oldest->_value.lastUse))
+				oldest = it;
+		}
+
+		// Only pinned images left, go over budget
+		if (oldest == _cache.end())
+			break;
+
+		debug(5, "Evicting image %d from the cache", oldest->_key);
+		_cacheSize -= oldest->_value.size;
+		delete oldest->_value.surface;
+		_cache.erase(oldest);
+	}
 }
 
 Common::Array<MohawkSurface *> GraphicsManager::decodeImages(uint16 id) {
@@ -227,7 +275,7 @@ void GraphicsManager::addImageToCache(uint16 id, MohawkSurface *surface) {
 	if (_cache.contains(id))
 		error("Image %d already in cache", id);
 
-	_cache[id] = surface;
+	addImage(id, surface, true);
 }
 
 } // End of namespace Mohawk
@@ -74,10 +74,21 @@ public:
 	// Free all surfaces in the cache
 	void clearCache();
 
+	// Limit the memory used by the images in the cache, in bytes. When adding
+	// an image would exceed the budget, the least recently used images are
+	// freed. A budget of 0, the default, lets the cache grow until
+	// clearCache() is called.
+	//
+	// With a budget, an image returned by findImage() may be freed by the
+	// next call to findImage(), so it must not be kept around.
+	void setCacheBudget(uint32 budget);
+
 	// findImage will search the cache to find the image.
 	// If not found, it will call decodeImage to get a new one.
 	MohawkSurface *findImage(uint16 id);
 
+	bool isImageCached(uint16 id) const { return _cache.contains(id); }
+
 	void preloadImage(uint16 image);
 	virtual void setPalette(uint16 id);
 	void copyAnimImageToScreen(uint16 image, int left = 0, int top = 0);
@@ -94,12 +105,35 @@ protected:
 	virtual Common::Array<MohawkSurface *> decodeImages(uint16 id);
 
 	virtual MohawkEngine *getVM() = 0;
+
+	// Add an image which decodeImage cannot recreate. It is never
+	// freed because of the cache budget.
 	void addImageToCache(uint16 id, MohawkSurface *surface);
 
 private:
-	// An image cache that stores images until clearCache() is called
-	Common::HashMap<uint16, MohawkSurface *> _cache;
+	struct CachedImage {
+		MohawkSurface *surface;
+		uint32 size;
+		uint32 lastUse;
+		bool pinned;
+	};
+
+	typedef Common::HashMap<uint16, CachedImage> ImageCache;
+
+	// An image cache that stores images until clearCache() is called,
+	// or until they are evicted to stay within the budget
+	ImageCache _cache;
 	Common::HashMap<uint16, Common::Array<MohawkSurface *> > _subImageCache;
+
+	uint32 _cacheBudget;
+	uint32 _cacheSize;
+	uint32 _cacheUseCounter;
+
+	void addImage(uint16 id, MohawkSurface *surface, bool pinned);
+
+	// Free the least recently used images until an image of the given
+	// size fits into the budget
+	void makeRoomInCache(uint32 size);
 };
 
 } // End of namespace Mohawk
@@ -26,7 +26,10 @@
 
 namespace Mohawk {
 
-ResourceCache::ResourceCache() {
+ResourceCache::ResourceCache() :
+		_budget(32 * 1024 * 1024),
+		_size(0),
+		_useCounter(0) {
 	enabled = true;
 }
 
@@ -40,25 +43,40 @@ void ResourceCache::clear() {
 
 	debugC(kDebugCache, "Clearing Cache...");
 
-	for (uint32 i = 0; i < _store.size(); i++)
-		delete _store[i].data;
+	for (DataMap::iterator it = _store.begin(); it != _store.end(); it++)
+		delete it->_value.data;
 
 	_store.clear();
+	_size = 0;
+}
+
+void ResourceCache::setBudget(uint32 budget) {
+	_budget = budget;
+	makeRoom(0);
 }
 
 void ResourceCache::add(uint32 tag, uint16 id, Common::SeekableReadStream *data) {
 	if (!enabled)
 		return;
 
+	Key key;
+	key.tag = tag;
+	key.id = id;
+
+	uint32 size = data->size();
+	if (_store.contains(key) || size > _budget)
+		return;
+
 	debugC(kDebugCache, "Adding item %d - tag 0x%04X id %d", _store.size(), tag, id);
 
-	DataObject current;
-	current.tag = tag;
-	current.id = id;
+	makeRoom(size);
+
+	DataObject &current = _store[key];
 	uint32 dataCurPos = data->pos();
-	current.data = data->readStream(data->size());
+	current.data = data->readStream(size);
+	current.lastUse = ++_useCounter;
 	data->seek(dataCurPos);
-	_store.push_back(current);
+	_size += size;
 }
 
 // Returns NULL if not found
@@ -68,18 +86,38 @@ Common::SeekableReadStream *ResourceCache::search(uint32 tag, uint16 id) {
 
 	debugC(kDebugCache, "Searching for tag 0x%04X id %d", tag, id);
 
-	for (uint32 i = 0; i < _store.size(); i++) {
-		if (tag == _store[i].tag && id == _store[i].id) {
-			debugC(kDebugCache, "Found cached tag 0x%04X id %u", tag, id);
-			uint32 dataCurPos  = _store[i].data->pos();
-			Common::SeekableReadStream *ret = _store[i].data->readStream(_store[i].data->size());
-			_store[i].data->seek(dataCurPos);
-			return ret;
-		}
+	Key key;
+	key.tag = tag;
+	key.id = id;
+
+	DataMap::iterator it = _store.find(key);
+	if (it == _store.end()) {
+		debugC(kDebugCache, "tag 0x%04X id %d not found", tag, id);
+		return nullptr;
 	}
 
-	debugC(kDebugCache, "tag 0x%04X id %d not found", tag, id);
-	return nullptr;
+	debugC(kDebugCache, "Found cached tag 0x%04X id %u", tag, id);
+	DataObject &object = it->_value;
+	object.lastUse = ++_useCounter;
+	uint32 dataCurPos = object.data->pos();
+	Common::SeekableReadStream *ret = object.data->readStream(object.data->size());
+	object.data->seek(dataCurPos);
+	return ret;
+}
+
+void ResourceCache::makeRoom(uint32 size) {
+	while (!_store.empty() && _size + size > _budget) {
+		DataMap::iterator oldest = _store.begin();
+		for (DataMap::iterator it = _store.begin(); it != _store.end(); it++) {
+			if (it->_value.lastUse < oldest->_value.lastUse)
+				oldest = it;
+		}
+
+		debugC(kDebugCache, "Evicting tag 0x%04X id %d", oldest->_key.tag, oldest->_key.id);
+		_size -= oldest->_value.data->size();
+		delete oldest->_value.data;
+		_store.erase(oldest);
+	}
 }
 
 } // End of namespace Mohawk
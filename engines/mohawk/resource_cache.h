@@ -23,11 +23,18 @@
 #ifndef RESOURCE_CACHE_H
 #define RESOURCE_CACHE_H
 
-#include "common/array.h"
+#include "common/hashmap.h"
 #include "common/stream.h"
 
 namespace Mohawk {
 
+/**
+ * A cache of raw resource data, looked up by tag and id.
+ *
+ * The memory used by the cached data is limited to a budget. When adding data
+ * would exceed it, the least recently used resources are dropped, and have to
+ * be read from disk again when they are needed.
+ */
 class ResourceCache {
 public:
 	ResourceCache();
@@ -41,14 +48,34 @@ public:
 	// Returns NULL if not found
 	Common::SeekableReadStream *search(uint32 tag, uint16 id);
 
+	// Set the maximum size of the cached data, in bytes
+	void setBudget(uint32 budget);
+
 private:
-	struct DataObject {
+	struct Key {
 		uint32 tag;
 		uint16 id;
+
+		bool operator==(const Key &other) const { return tag == other.tag && id == other.id; }
+	};
+
+	struct KeyHash {
+		uint operator()(const Key &key) const { return key.tag * 31 + key.id; }
+	};
+
+	struct DataObject {
 		Common::SeekableReadStream *data;
+		uint32 lastUse;
 	};
 
-	Common::Array<DataObject> _store;
+	typedef Common::HashMap<Key, DataObject, KeyHash> DataMap;
+
+	DataMap _store;
+	uint32 _budget;
+	uint32 _size;
+	uint32 _useCounter;
+
+	void makeRoom(uint32 size);
 };
 
 } // End of namespace Mohawk
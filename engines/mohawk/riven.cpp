@@ -237,6 +237,10 @@ void MohawkEngine_Riven::doFrame() {
 	_system->updateScreen();
 	uint32 loopElapsed = _system->getMillis() - loopStart;
 
+	// Use the spare frame time to decode the pictures of the neighbouring cards
+	if (loopElapsed < 10 && !_scriptMan->runningQueuedScripts() && _gfx->prefetchNextImage())
+		loopElapsed = _system->getMillis() - loopStart;
+
 	// Cut down on CPU usage
 	if (loopElapsed < 10)
 		_system->delayMillis(10 - loopElapsed);
@@ -404,6 +408,7 @@ void MohawkEngine_Riven::changeToStack(uint16 stackId) {
 	_sound->stopAllSLST();
 
 	// Clear the graphics cache; images aren't used across stack boundaries
+	_gfx->clearPrefetchQueue();
 	_gfx->clearCache();
 
 	// Clear the old stack files out
@@ -602,9 +607,9 @@ static const RivenSpecialChange rivenSpecialChange[] = {
 void MohawkEngine_Riven::changeToCard(uint16 dest) {
 	debug (1, "Changing to card %d", dest);
 
-	// Clear the graphics cache (images typically aren't used
-	// on different cards).
-	_gfx->clearCache();
+	// The graphics cache is kept, within its budget, so images shared with
+	// the previous card or prefetched for this one don't need decoding again.
+	_gfx->clearPrefetchQueue();
 
 	if (!(getFeatures() & GF_DEMO)) {
 		for (byte i = 0; i < ARRAYSIZE(rivenSpecialChange); i++)
@@ -630,6 +635,41 @@ void MohawkEngine_Riven::changeToCard(uint16 dest) {
 
 	// Finally, install any hardcoded timer
 	_stack->installCardTimer();
+
+	prefetchNeighbourCards();
+}
+
+void MohawkEngine_Riven::prefetchNeighbourCards() {
+	Common::Array<uint16> cardIds = _card->getDestinationCards();
+
+	// The picture shown when entering a card is usually the first of its list,
+	// queue those for all the neighbours before the alternate pictures.
+	Common::Array<uint16> firstPictures;
+	Common::Array<uint16> otherPictures;
+
+	for (uint i = 0; i < cardIds.size(); i++) {
+		if (!hasResource(ID_PLST, cardIds[i]))
+			continue;
+
+		Common::SeekableReadStream *plst = getResource(ID_PLST, cardIds[i]);
+		uint16 recordCount = plst->readUint16BE();
+
+		for (uint16 j = 0; j < recordCount; j++) {
+			uint16 index = plst->readUint16BE();
+			uint16 id = plst->readUint16BE();
+			plst->skip(4 * sizeof(uint16)); // rect
+
+			if (index == 1)
+				firstPictures.push_back(id);
+			else
+				otherPictures.push_back(id);
+		}
+
+		delete plst;
+	}
+
+	_gfx->prefetchImages(firstPictures);
+	_gfx->prefetchImages(otherPictures);
 }
 
 Common::SeekableReadStream *MohawkEngine_Riven::getExtrasResource(uint32 tag, uint16 id) {
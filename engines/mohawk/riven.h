@@ -124,6 +124,9 @@ private:
 	RivenCard *_card;
 	RivenStack *_stack;
 
+	/** Queue the pictures of the cards reachable from the current card for idle time decoding */
+	void prefetchNeighbourCards();
+
 	int _menuSavedCard;
 	int _menuSavedStack;
 	Common::ScopedPtr<Graphics::Surface, Graphics::SurfaceDeleter> _menuThumbnail;
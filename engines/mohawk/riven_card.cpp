@@ -31,6 +31,7 @@
 #include "mohawk/resource.h"
 #include "mohawk/riven.h"
 
+#include "common/algorithm.h"
 #include "common/memstream.h"
 
 namespace Mohawk {
@@ -684,6 +685,24 @@ Common::Array<RivenHotspot *> RivenCard::getHotspots() const {
 	return _hotspots;
 }
 
+Common::Array<uint16> RivenCard::getDestinationCards() const {
+	Common::Array<uint16> scriptCardIds;
+	for (uint i = 0; i < _hotspots.size(); i++) {
+		if (_hotspots[i]->isEnabled()) {
+			_hotspots[i]->findDestinationCards(scriptCardIds);
+		}
+	}
+
+	Common::Array<uint16> cardIds;
+	for (uint i = 0; i < scriptCardIds.size(); i++) {
+		if (scriptCardIds[i] != _id && Common::find(cardIds.begin(), cardIds.end(), scriptCardIds[i]) == cardIds.end()) {
+			cardIds.push_back(scriptCardIds[i]);
+		}
+	}
+
+	return cardIds;
+}
+
 RivenHotspot *RivenCard::getHotspotByName(const Common::String &name, bool optional) const {
 	int16 nameId = _vm->getStack()->getIdFromName(kHotspotNames, name);
 
@@ -1170,6 +1189,12 @@ void RivenHotspot::applyScriptPatches(uint32 cardGlobalId) {
 	}
 }
 
+void RivenHotspot::findDestinationCards(Common::Array<uint16> &cardIds) const {
+	for (uint16 i = 0; i < _scripts.size(); i++) {
+		_scripts[i].script->findDestinationCards(cardIds);
+	}
+}
+
 bool RivenHotspot::isEnabled() const {
 	return (_flags & kFlagEnabled) != 0;
 }
@@ -113,6 +113,12 @@ public:
 	/** Get all the hotspots in the card. To be used for debugging features only */
 	Common::Array<RivenHotspot *> getHotspots() const;
 
+	/**
+	 * Get the ids of the cards the enabled hotspots of the card may lead to,
+	 * in hotspot order and without duplicates
+	 */
+	Common::Array<uint16> getDestinationCards() const;
+
 	/** Activate a hotspot using a hotspot enable list entry */
 	void activateHotspotEnableRecord(uint16 index);
 
@@ -272,6 +278,9 @@ public:
 	/** Apply patches to the hotspot's scripts to fix bugs in the original game scripts */
 	void applyScriptPatches(uint32 cardGlobalId);
 
+	/** Append the ids of the cards the hotspot's scripts may change to */
+	void findDestinationCards(Common::Array<uint16> &cardIds) const;
+
 	/** Apply patches to the hotspot's properties to fix bugs in the original game scripts */
 	void applyPropertiesPatches(uint32 cardGlobalId);
 
@@ -28,6 +28,7 @@
 #include "mohawk/riven_stack.h"
 #include "mohawk/riven_video.h"
 
+#include "common/algorithm.h"
 #include "common/system.h"
 
 #include "engines/util.h"
@@ -339,6 +340,11 @@ RivenGraphics::RivenGraphics(MohawkEngine_Riven* vm) :
 	_effectScreen = new Graphics::Surface();
 	_effectScreen->create(608, 392, _pixelFormat);
 
+	// Card images are kept across card changes so going back and forth
+	// between neighbouring cards does not decode them again. A full screen
+	// picture is about 465 KB once converted to 16 bpp.
+	setCacheBudget(kRivenImageCacheBudget);
+
 	loadMenuFont();
 }
 
@@ -365,16 +371,44 @@ void RivenGraphics::copyImageToScreen(uint16 image, uint32 left, uint32 top, uin
 	beginScreenUpdate();
 
 	// Clip the width to fit on the screen. Fixes some images.
-	if (left + surface->w > 608)
-		surface->w = 608 - left;
+	// The cached surface is left untouched as it may be drawn again elsewhere.
+	uint16 width = surface->w;
+	if (left + width > 608)
+		width = 608 - left;
 
 	for (uint16 i = 0; i < surface->h; i++)
-		memcpy(_mainScreen->getBasePtr(left, i + top), surface->getBasePtr(0, i), surface->w * surface->format.bytesPerPixel);
+		memcpy(_mainScreen->getBasePtr(left, i + top), surface->getBasePtr(0, i), width * surface->format.bytesPerPixel);
 
 	_dirtyScreen = true;
 	applyScreenUpdate();
 }
 
+void RivenGraphics::prefetchImages(const Common::Array<uint16> &ids) {
+	for (uint i = 0; i < ids.size() && _prefetchQueue.size() < kRivenMaxPrefetchedImages; i++) {
+		if (!isImageCached(ids[i]) && Common::find(_prefetchQueue.begin(), _prefetchQueue.end(), ids[i]) == _prefetchQueue.end())
+			_prefetchQueue.push_back(ids[i]);
+	}
+}
+
+bool RivenGraphics::prefetchNextImage() {
+	while (!_prefetchQueue.empty()) {
+		uint16 id = _prefetchQueue.front();
+		_prefetchQueue.remove_at(0);
+
+		if (!isImageCached(id) && _vm->hasResource(ID_TBMP, id)) {
+			debug(5, "Prefetching tBMP %d", id);
+			preloadImage(id);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void RivenGraphics::clearPrefetchQueue() {
+	_prefetchQueue.clear();
+}
+
 void RivenGraphics::updateScreen() {
 	if (_dirtyScreen) {
 		// Copy to screen if there's no transition. Otherwise transition.
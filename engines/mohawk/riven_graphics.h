@@ -65,6 +65,11 @@ enum RivenCreditsImageNumber {
 	kRivenCreditsLastImage   = 320
 };
 
+enum {
+	kRivenImageCacheBudget    = 32 * 1024 * 1024, // bytes
+	kRivenMaxPrefetchedImages = 8
+};
+
 class RivenGraphics : public GraphicsManager {
 public:
 	explicit RivenGraphics(MohawkEngine_Riven *vm);
@@ -107,6 +112,11 @@ public:
 	// Main menu
 	void drawText(const Common::U32String &text, const Common::Rect &dest, uint8 greyLevel);
 
+	// Idle time image decoding
+	void prefetchImages(const Common::Array<uint16> &ids);
+	bool prefetchNextImage();
+	void clearPrefetchQueue();
+
 	// Credits
 	void beginCredits();
 	void updateCredits();
@@ -149,6 +159,9 @@ private:
 	void loadMenuFont();
 	const Graphics::Font *getMenuFont() const;
 
+	// Images to decode ahead of time, in order
+	Common::Array<uint16> _prefetchQueue;
+
 	// Credits
 	uint _creditsImage, _creditsPos;
 };
@@ -232,6 +232,12 @@ void RivenScript::addCommand(RivenCommandPtr command) {
 	_commands.push_back(command);
 }
 
+void RivenScript::findDestinationCards(Common::Array<uint16> &cardIds) const {
+	for (uint i = 0; i < _commands.size(); i++) {
+		_commands[i]->findDestinationCards(cardIds);
+	}
+}
+
 bool RivenScript::empty() const {
 	return _commands.empty();
 }
@@ -831,6 +837,12 @@ RivenCommandType RivenSimpleCommand::getType() const {
 	return _type;
 }
 
+void RivenSimpleCommand::findDestinationCards(Common::Array<uint16> &cardIds) const {
+	if (_type == kRivenCommandChangeCard && !_arguments.empty()) {
+		cardIds.push_back(_arguments[0]);
+	}
+}
+
 RivenSwitchCommand::RivenSwitchCommand(MohawkEngine_Riven *vm) :
 		RivenCommand(vm),
 		_variableId(0) {
@@ -918,6 +930,12 @@ void RivenSwitchCommand::applyCardPatches(uint32 globalId, int scriptType, uint1
 	}
 }
 
+void RivenSwitchCommand::findDestinationCards(Common::Array<uint16> &cardIds) const {
+	for (uint i = 0; i < _branches.size(); i++) {
+		_branches[i].script->findDestinationCards(cardIds);
+	}
+}
+
 RivenStackChangeCommand::RivenStackChangeCommand(MohawkEngine_Riven *vm, uint16 stackId, uint32 globalCardId,
                                                  bool byStackId, bool byStackCardId) :
 		RivenCommand(vm),
@@ -131,6 +131,9 @@ public:
 	/** Apply patches to card script to fix bugs in the original game scripts */
 	void applyCardPatches(MohawkEngine_Riven *vm, uint32 cardGlobalId, uint16 scriptType, uint16 hotspotId);
 
+	/** Append the ids of the cards the script may change to, in any branch */
+	void findDestinationCards(Common::Array<uint16> &cardIds) const;
+
 	/** Append the commands of the other script to this script */
 	RivenScript &operator+=(const RivenScript &other);
 
@@ -267,6 +270,9 @@ public:
 	/** Apply card patches for the command's sub-scripts */
 	virtual void applyCardPatches(uint32 globalId, int scriptType, uint16 hotspotId) {}
 
+	/** Append the ids of the cards the command may change to */
+	virtual void findDestinationCards(Common::Array<uint16> &cardIds) const {}
+
 protected:
 	MohawkEngine_Riven *_vm;
 };
@@ -291,6 +297,7 @@ public:
 	virtual void dump(byte tabs) override;
 	virtual void execute() override;
 	virtual RivenCommandType getType() const override;
+	virtual void findDestinationCards(Common::Array<uint16> &cardIds) const override;
 
 private:
 	typedef void (RivenSimpleCommand::*OpcodeProcRiven)(uint16 op, const ArgumentArray &args);
@@ -365,6 +372,7 @@ public:
 	virtual void execute() override;
 	virtual RivenCommandType getType() const override;
 	virtual void applyCardPatches(uint32 globalId, int scriptType, uint16 hotspotId) override;
+	virtual void findDestinationCards(Common::Array<uint16> &cardIds) const override;
 
 private:
 	RivenSwitchCommand(MohawkEngine_Riven *vm);
@@ -0,0 +1,190 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "engines/savestateindex.h"
+#include "engines/savestate.h"
+
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/savefile.h"
+#include "common/system.h"
+
+namespace Common {
+DECLARE_SINGLETON(SaveStateIndex);
+}
+
+static const uint32 kIndexVersion = 1;
+
+static void writeString(Common::WriteStream *out, const Common::String &str) {
+	out->writeUint16BE(str.size());
+	out->writeString(str);
+}
+
+static Common::String readString(Common::ReadStream *in) {
+	const uint16 size = in->readUint16BE();
+	Common::String str;
+	for (uint16 i = 0; i < size && !in->eos(); i++)
+		str += (char)in->readByte();
+	return str;
+}
+
+void SaveStateIndex::Entry::applyTo(SaveStateDescriptor &desc) const {
+	desc.setDescription(description);
+	if (flags & kHasSaveDate)
+		desc.setSaveDate(saveDate >> 16, (saveDate >> 8) & 0xFF, saveDate & 0xFF);
+	if (flags & kHasSaveTime)
+		desc.setSaveTime((saveTime >> 8) & 0xFF, saveTime & 0xFF);
+	if (flags & kHasPlayTime)
+		desc.setPlayTime(playTime);
+}
+
+SaveStateIndex::SaveStateIndex() : _dirty(false) {
+}
+
+SaveStateIndex::~SaveStateIndex() {
+	flush();
+}
+
+bool SaveStateIndex::lookup(const Common::String &target, const Common::String &fileName, Entry &entry) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	uint32 fileSize, modificationTime;
+	if (!saveFileMan->getSavefileStatus(fileName, fileSize, modificationTime))
+		return false;
+
+	selectTarget(target);
+
+	EntryMap::const_iterator it = _entries.find(fileName);
+	if (it == _entries.end() || it->_value.fileSize != fileSize || it->_value.modificationTime != modificationTime)
+		return false;
+
+	entry = it->_value.entry;
+	return true;
+}
+
+void SaveStateIndex::store(const Common::String &target, const Common::String &fileName, const Entry &entry) {
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	uint32 fileSize, modificationTime;
+	if (!saveFileMan->getSavefileStatus(fileName, fileSize, modificationTime) || entry.description.size() > 0xFFFF)
+		return;
+
+	selectTarget(target);
+
+	if (_entries.size() >= kMaxEntries && !_entries.contains(fileName))
+		return;
+
+	IndexedEntry &indexed = _entries[fileName];
+	indexed.fileSize = fileSize;
+	indexed.modificationTime = modificationTime;
+	indexed.entry = entry;
+	_dirty = true;
+}
+
+void SaveStateIndex::remove(const Common::String &target, const Common::String &fileName) {
+	selectTarget(target);
+
+	if (_entries.contains(fileName)) {
+		_entries.erase(fileName);
+		_dirty = true;
+	}
+}
+
+void SaveStateIndex::selectTarget(const Common::String &target) {
+	if (_target == target)
+		return;
+
+	flush();
+	_entries.clear();
+	_target = target;
+	load();
+}
+
+Common::String SaveStateIndex::getIndexFileName(const Common::String &target) {
+	// Engines list their savefiles with patterns starting with the target,
+	// so the index must not start with it.
+	return "scummvm-" + target + ".saveindex";
+}
+
+void SaveStateIndex::load() {
+	Common::InSaveFile *in = g_system->getSavefileManager()->openForLoading(getIndexFileName(_target));
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != MKTAG('S', 'I', 'D', 'X') || in->readUint32BE() != kIndexVersion) {
+		debug(1, "SaveStateIndex: Ignoring outdated index of '%s'", _target.c_str());
+		delete in;
+		return;
+	}
+
+	const uint32 count = in->readUint32BE();
+	for (uint32 i = 0; i < count && !in->eos() && !in->err(); i++) {
+		Common::String fileName = readString(in);
+		IndexedEntry indexed;
+		indexed.fileSize = in->readUint32BE();
+		indexed.modificationTime = in->readUint32BE();
+		indexed.entry.description = readString(in);
+		indexed.entry.version = in->readUint32BE();
+		indexed.entry.flags = in->readUint32BE();
+		indexed.entry.saveDate = in->readUint32BE();
+		indexed.entry.saveTime = in->readUint32BE();
+		indexed.entry.playTime = in->readUint32BE();
+		indexed.entry.thumbnailOffset = in->readSint32BE();
+
+		if (in->eos() || in->err())
+			break;
+		_entries[fileName] = indexed;
+	}
+
+	delete in;
+}
+
+void SaveStateIndex::flush() {
+	if (!_dirty)
+		return;
+	_dirty = false;
+
+	const Common::String indexFileName = getIndexFileName(_target);
+	Common::OutSaveFile *out = g_system->getSavefileManager()->openForSaving(indexFileName, false);
+	if (!out) {
+		warning("SaveStateIndex: Could not write '%s'", indexFileName.c_str());
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('S', 'I', 'D', 'X'));
+	out->writeUint32BE(kIndexVersion);
+	out->writeUint32BE(_entries.size());
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		const IndexedEntry &indexed = it->_value;
+		writeString(out, it->_key);
+		out->writeUint32BE(indexed.fileSize);
+		out->writeUint32BE(indexed.modificationTime);
+		writeString(out, indexed.entry.description);
+		out->writeUint32BE(indexed.entry.version);
+		out->writeUint32BE(indexed.entry.flags);
+		out->writeUint32BE(indexed.entry.saveDate);
+		out->writeUint32BE(indexed.entry.saveTime);
+		out->writeUint32BE(indexed.entry.playTime);
+		out->writeSint32BE(indexed.entry.thumbnailOffset);
+	}
+	out->finalize();
+	delete out;
+}
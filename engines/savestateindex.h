@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef ENGINES_SAVESTATEINDEX_H
+#define ENGINES_SAVESTATEINDEX_H
+
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+class SaveStateDescriptor;
+
+/**
+ * Remembers the meta information of saved games, so the save and load
+ * dialogs do not need to open and parse every savefile of a target.
+ *
+ * Engines opt into the index from their MetaEngine: whenever they parsed
+ * a savefile, they store what they found with store(), and they try
+ * lookup() before opening the file the next time. Entries are only
+ * returned while the size and modification time reported by the savefile
+ * manager are unchanged, see Common::SaveFileManager::getSavefileStatus().
+ * On backends which cannot report these, the index stays empty.
+ *
+ * The index of one target is kept in memory at a time. It is stored in a
+ * savefile of its own, named after the target.
+ */
+class SaveStateIndex : public Common::Singleton<SaveStateIndex> {
+public:
+	enum {
+		kHasSaveDate = 1 << 0,
+		kHasSaveTime = 1 << 1,
+		kHasPlayTime = 1 << 2
+	};
+
+	/**
+	 * The information stored for one savefile. The thumbnail itself is not
+	 * stored; engines which know where it is in the savefile may keep its
+	 * offset to load it without parsing what precedes it.
+	 */
+	struct Entry {
+		Entry() : version(0), flags(0), saveDate(0), saveTime(0), playTime(0), thumbnailOffset(-1) {}
+
+		Common::String description;
+		/** Engine specific version of the savefile format */
+		uint32 version;
+		/** Combination of kHasSaveDate, kHasSaveTime and kHasPlayTime */
+		uint32 flags;
+		/** Save date, as (year << 16) | (month << 8) | day */
+		uint32 saveDate;
+		/** Save time, as (hour << 8) | minutes */
+		uint32 saveTime;
+		/** Play time in milliseconds */
+		uint32 playTime;
+		/** Offset of the thumbnail in the (uncompressed) savefile, -1 if there is none */
+		int32 thumbnailOffset;
+
+		/**
+		 * Set the description, save date, save time and play time of
+		 * the given descriptor. Its other properties are left alone.
+		 */
+		void applyTo(SaveStateDescriptor &desc) const;
+	};
+
+	SaveStateIndex();
+	~SaveStateIndex();
+
+	/**
+	 * Look up the information stored for a savefile.
+	 *
+	 * @return false if there is none, or the file was changed since.
+	 */
+	bool lookup(const Common::String &target, const Common::String &fileName, Entry &entry);
+
+	/**
+	 * Store the information just read from a savefile. Engines should only
+	 * do this for files they were able to parse.
+	 */
+	void store(const Common::String &target, const Common::String &fileName, const Entry &entry);
+
+	/**
+	 * Forget about a savefile, e.g. because it is removed.
+	 */
+	void remove(const Common::String &target, const Common::String &fileName);
+
+	/**
+	 * Write the index of the current target to disk if it was changed.
+	 */
+	void flush();
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+
+	enum {
+		/** Maximal number of entries per target */
+		kMaxEntries = 10000
+	};
+
+	struct IndexedEntry {
+		uint32 fileSize;
+		uint32 modificationTime;
+		Entry entry;
+	};
+
+	typedef Common::HashMap<Common::String, IndexedEntry, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> EntryMap;
+
+	/** Make the index of the given target the current one. */
+	void selectTarget(const Common::String &target);
+
+	static Common::String getIndexFileName(const Common::String &target);
+
+	void load();
+
+	Common::String _target;
+	EntryMap _entries;
+	bool _dirty;
+};
+
+/** Shortcut for accessing the save state index. */
+#define SaveIndex		SaveStateIndex::instance()
+
+#endif
@@ -115,6 +115,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -148,6 +149,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("pi",                 WRAP_METHOD(Console, cmdPlaneItemList));	// alias
 	registerCmd("visible_plane_items", WRAP_METHOD(Console, cmdVisiblePlaneItemList));
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
+	registerCmd("frameout_stats",     WRAP_METHOD(Console, cmdFrameoutStats));
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
 	// Segments
@@ -159,6 +161,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("segkill",			WRAP_METHOD(Console, cmdKillSegment));			// alias
 	// Garbage collection
 	registerCmd("gc",					WRAP_METHOD(Console, cmdGCInvoke));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	registerCmd("gc_objects",			WRAP_METHOD(Console, cmdGCObjects));
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
@@ -336,6 +339,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows statistics about the resource cache, or changes its size\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
@@ -365,6 +369,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_list / vpl - Shows a list of all the planes in the visible draw list (SCI2+)\n");
 	debugPrintf(" plane_items / pi - Shows a list of all items for a plane (SCI2+)\n");
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
+	debugPrintf(" frameout_stats - Shows statistics about the rendered frames (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
 	debugPrintf("\n");
@@ -375,6 +380,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("Garbage collection:\n");
 	debugPrintf(" gc - Invokes the garbage collector\n");
+	debugPrintf(" gc_stats - Shows statistics about the garbage collections\n");
 	debugPrintf(" gc_objects - Lists all reachable objects, normalized\n");
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
@@ -1092,6 +1098,43 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc > 2) {
+		debugPrintf("Shows statistics about the cache of unlocked resources\n");
+		debugPrintf("Usage: %s [<size in KiB> | reset]\n", argv[0]);
+		debugPrintf("The size can be set permanently with the resource_cache_size config key\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		if (!scumm_stricmp(argv[1], "reset")) {
+			resMan->resetCacheStats();
+			debugPrintf("Resource cache counters reset\n");
+			return true;
+		}
+
+		const int budget = atoi(argv[1]);
+		if (budget <= 0) {
+			debugPrintf("Invalid cache size '%s'\n", argv[1]);
+			return true;
+		}
+		resMan->setCacheBudget(budget * 1024);
+	}
+
+	const ResourceManager::CacheStats &stats = resMan->getCacheStats();
+	const uint32 lookups = stats.hits + stats.misses;
+
+	debugPrintf("Cache size: %d KiB, %d KiB in use\n", resMan->getCacheBudget() / 1024, resMan->getCacheMemory() / 1024);
+	debugPrintf("Locked resources: %d KiB\n", resMan->getLockedMemory() / 1024);
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate)\n", stats.hits, stats.misses, lookups ? (uint32)(stats.hits * 100ULL / lookups) : 0);
+	debugPrintf("Evictions: %u (%u KiB)\n", stats.evictions, stats.evictedBytes / 1024);
+	debugPrintf("Preloaded: %u, %u queued\n", stats.preloads, resMan->getPreloadQueueSize());
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2076,6 +2119,39 @@ bool Console::cmdVisiblePlaneList(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdFrameoutStats(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (!_engine->_gfxFrameout) {
+		debugPrintf("This SCI version does not have a list of planes\n");
+		return true;
+	}
+
+	FrameoutStatistics &stats = _engine->_gfxFrameout->getStatistics();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		memset(&stats, 0, sizeof(FrameoutStatistics));
+		debugPrintf("Frameout statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows statistics about the rendered frames\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Frames: %u\n", stats.frames);
+	if (stats.frames) {
+		debugPrintf("Frame time: last %u ms, max %u ms, average %u ms\n", stats.lastFrameTime, stats.maxFrameTime, stats.totalFrameTime / stats.frames);
+	}
+	if (stats.calcListsCalls) {
+		debugPrintf("calcLists time: last %u ms, max %u ms, average %u ms\n", stats.lastCalcListsTime, stats.maxCalcListsTime, stats.totalCalcListsTime / stats.calcListsCalls);
+		debugPrintf("Screen items: %u recalculated, %u redundant updates skipped, %u moved in the grid\n",
+			stats.screenItemsCalculated, stats.redundantUpdates, stats.screenItemsIndexed);
+	}
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
 
 bool Console::cmdPlaneItemList(int argc, const char **argv) {
 	if (argc != 2) {
@@ -2710,6 +2786,37 @@ bool Console::cmdIsSample(int argc, const char **argv) {
 bool Console::cmdGCInvoke(int argc, const char **argv) {
 	debugPrintf("Performing garbage collection...\n");
 	run_gc(_engine->_gamestate);
+
+	const GCStatistics &stats = _engine->_gamestate->gcStats;
+	debugPrintf("Freed %u entities in %u ms, %u addresses are reachable\n", stats.lastFreed, stats.lastPause, stats.lastReachable);
+	return true;
+}
+
+bool Console::cmdGCStats(int argc, const char **argv) {
+	const GCStatistics &stats = _engine->_gamestate->gcStats;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		memset(&_engine->_gamestate->gcStats, 0, sizeof(GCStatistics));
+		debugPrintf("Garbage collection statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Shows statistics about the garbage collections\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	debugPrintf("Collections: %u (%u incremental), ", stats.collections, stats.incrementalCollections);
+	if (_engine->_gamestate->incrementalGC->isRunning())
+		debugPrintf("one is running\n");
+	else
+		debugPrintf("next one due in %d kernel calls\n", _engine->_gamestate->gcCountDown);
+	if (stats.collections) {
+		debugPrintf("Pause time: last %u ms, max %u ms, average %u ms\n", stats.lastPause, stats.maxPause, stats.totalPause / stats.collections);
+		debugPrintf("Last collection: %u addresses reachable, %u entities freed\n", stats.lastReachable, stats.lastFreed);
+		debugPrintf("Last collection took %u frames, rescanned %u changed entries\n", stats.lastSteps, stats.lastRescanned);
+		debugPrintf("Total freed: %u entities\n", stats.totalFreed);
+	}
+
 	return true;
 }
 
@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -56,10 +57,12 @@ void WorklistManager::push(reg_t reg) {
 
 	debugC(kDebugLevelGC, "[GC] Adding %04x:%04x", PRINT_REG(reg));
 
-	if (_map.contains(reg))
+	// Insert the address and check whether it was new with a single lookup
+	const uint oldSize = _map.size();
+	_map[reg] = true;
+	if (_map.size() == oldSize)
 		return; // already dealt with it
 
-	_map.setVal(reg, true);
 	_worklist.push_back(reg);
 }
 
@@ -99,11 +102,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void pushRoots(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -170,7 +171,14 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
 
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRoots(s, wm);
+
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
 	processWorkList(s->_segMan, wm, heap);
 
 	if (g_sci->_gfxPorts)
@@ -179,11 +187,11 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
-	SegManager *segMan = s->_segMan;
-
-	// Some debug stuff
-	debugC(kDebugLevelGC, "[GC] Running...");
+/**
+ * Frees all deallocatable entries which are not in the given set.
+ * @return the number of freed entries
+ */
+static uint32 sweep(SegManager *segMan, const AddrSet &activeRefs) {
 #ifdef GC_DEBUG_CODE
 	const char *segnames[SEG_TYPE_MAX + 1];
 	int segcount[SEG_TYPE_MAX + 1];
@@ -191,8 +199,7 @@ void run_gc(EngineState *s) {
 	memset(segcount, 0, sizeof(segcount));
 #endif
 
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	uint32 freed = 0;
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
@@ -211,9 +218,10 @@ void run_gc(EngineState *s) {
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
+				if (!activeRefs.contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					freed++;
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
@@ -224,8 +232,6 @@ void run_gc(EngineState *s) {
 		}
 	}
 
-	delete activeRefs;
-
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -233,6 +239,192 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	return freed;
+}
+
+void run_gc(EngineState *s) {
+	// A full collection makes the running incremental one pointless
+	if (s->incrementalGC)
+		s->incrementalGC->cancel();
+
+	debugC(kDebugLevelGC, "[GC] Running...");
+
+	const uint32 startTime = g_system->getMillis();
+
+	// Compute the set of all segments references currently in use.
+	AddrSet *activeRefs = findAllActiveReferences(s);
+
+	const uint32 freed = sweep(s->_segMan, *activeRefs);
+
+	GCStatistics &stats = s->gcStats;
+	stats.collections++;
+	stats.lastPause = g_system->getMillis() - startTime;
+	stats.maxPause = MAX(stats.maxPause, stats.lastPause);
+	stats.totalPause += stats.lastPause;
+	stats.lastReachable = activeRefs->size();
+	stats.lastFreed = freed;
+	stats.totalFreed += freed;
+	stats.lastSteps = 1;
+	stats.lastRescanned = 0;
+
+	delete activeRefs;
+
+	debugC(kDebugLevelGC, "[GC] Freed %u entities in %u ms", freed, stats.lastPause);
+}
+
+/**
+ * Returns the references held by the given entry, except numbers, which the
+ * collection does not follow anyway.
+ */
+static void listPointers(const Common::Array<SegmentObj *> &heap, reg_t reg, Common::Array<reg_t> &refs) {
+	refs.clear();
+
+	SegmentObj *mobj = reg.getSegment() < heap.size() ? heap[reg.getSegment()] : nullptr;
+	// The game may have freed the entry since it was found
+	if (!mobj || !mobj->isValidOffset(reg.getOffset()))
+		return;
+
+	const Common::Array<reg_t> tmp = mobj->listAllOutgoingReferences(reg);
+	for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
+		if (it->getSegment())
+			refs.push_back(*it);
+	}
+}
+
+void IncrementalGC::start(EngineState *s) {
+	cancel();
+
+	debugC(kDebugLevelGC, "[GC] Starting incremental collection");
+	_running = true;
+
+	const uint32 startTime = g_system->getMillis();
+	pushRoots(s, _wm);
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(_wm);
+	_totalTime = g_system->getMillis() - startTime;
+}
+
+bool IncrementalGC::step(EngineState *s, uint32 maxTime) {
+	assert(_running);
+
+	const uint32 startTime = g_system->getMillis();
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
+	const SegmentId stackSegment = s->_segMan->findSegmentByType(SEG_TYPE_STACK);
+	Common::Array<reg_t> refs;
+
+	uint count = 0;
+	while (!_wm._worklist.empty()) {
+		// Checking the time for every entry would take longer than
+		// scanning most of them
+		if ((++count & 63) == 0 && g_system->getMillis() - startTime >= maxTime)
+			break;
+
+		const reg_t reg = _wm._worklist.back();
+		_wm._worklist.pop_back();
+		if (reg.getSegment() == stackSegment) // The stack is a root
+			continue;
+
+		debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
+		listPointers(heap, reg, refs);
+		_wm.pushArray(refs);
+
+		// Remember what the entry referenced, to find out whether the game
+		// changed it before the collection is finished
+		_scanned.push_back(reg);
+		_refs.push_back(refs);
+		_refsEnd.push_back(_refs.size());
+	}
+
+	const bool done = _wm._worklist.empty();
+	if (done)
+		finish(s);
+
+	const uint32 stepTime = g_system->getMillis() - startTime;
+	_steps++;
+	_maxStepTime = MAX(_maxStepTime, stepTime);
+	_totalTime += stepTime;
+
+	if (done) {
+		GCStatistics &stats = s->gcStats;
+		stats.lastPause = _maxStepTime;
+		stats.maxPause = MAX(stats.maxPause, stats.lastPause);
+		stats.totalPause += _totalTime;
+		stats.lastSteps = _steps;
+
+		debugC(kDebugLevelGC, "[GC] Freed %u entities in %u steps, up to %u ms each", stats.lastFreed, _steps, _maxStepTime);
+		cancel();
+	}
+
+	return done;
+}
+
+void IncrementalGC::finish(EngineState *s) {
+	SegManager *segMan = s->_segMan;
+	const Common::Array<SegmentObj *> &heap = segMan->getSegments();
+
+	// Find references the game put into the roots, or into entries which
+	// were already scanned, since the collection was started
+	pushRoots(s, _wm);
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(_wm);
+
+	Common::Array<reg_t> refs;
+	uint32 rescanned = 0;
+	for (uint i = 0; i < _scanned.size(); i++) {
+		listPointers(heap, _scanned[i], refs);
+
+		const uint32 begin = i ? _refsEnd[i - 1] : 0;
+		bool changed = refs.size() != _refsEnd[i] - begin;
+		for (uint j = 0; !changed && j < refs.size(); j++)
+			changed = refs[j] != _refs[begin + j];
+
+		if (changed) {
+			_wm.pushArray(refs);
+			rescanned++;
+		}
+	}
+
+	processWorkList(segMan, _wm, heap);
+
+	// Entries are marked by their own address, except for the ones of
+	// scripts and dynamic memory, which are marked as a whole. Add those
+	// whole addresses, instead of normalizing the addresses of all entries.
+	Common::Array<reg_t> canonical;
+	for (AddrSet::const_iterator it = _wm._map.begin(); it != _wm._map.end(); ++it) {
+		const reg_t reg = it->_key;
+		SegmentObj *mobj = reg.getSegment() < heap.size() ? heap[reg.getSegment()] : nullptr;
+		if (!mobj)
+			continue;
+
+		const SegmentType type = mobj->getType();
+		if (type == SEG_TYPE_SCRIPT || type == SEG_TYPE_LOCALS || type == SEG_TYPE_STACK || type == SEG_TYPE_DYNMEM)
+			canonical.push_back(mobj->findCanonicAddress(segMan, reg));
+	}
+	for (uint i = 0; i < canonical.size(); i++)
+		_wm._map.setVal(canonical[i], true);
+
+	const uint32 freed = sweep(segMan, _wm._map);
+
+	GCStatistics &stats = s->gcStats;
+	stats.collections++;
+	stats.incrementalCollections++;
+	stats.lastReachable = _wm._map.size();
+	stats.lastFreed = freed;
+	stats.totalFreed += freed;
+	stats.lastRescanned = rescanned;
+}
+
+void IncrementalGC::cancel() {
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_scanned.clear();
+	_refsEnd.clear();
+	_refs.clear();
+	_running = false;
+	_steps = 0;
+	_maxStepTime = 0;
+	_totalTime = 0;
 }
 
 } // End of namespace Sci
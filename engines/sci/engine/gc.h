@@ -24,7 +24,7 @@
 #ifndef SCI_ENGINE_GC_H
 #define SCI_ENGINE_GC_H
 
-#include "common/hashmap.h"
+#include "common/flathashmap.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/state.h"
 
@@ -38,9 +38,11 @@ struct reg_t_Hash {
 
 /*
  * The AddrSet is a "set" of reg_t values.
- * We don't have a HashSet type, so we abuse a HashMap for this.
+ * We don't have a HashSet type, so we abuse a HashMap for this. The GC
+ * spends most of its time looking up addresses in these sets, hence the
+ * open addressing FlatHashMap.
  */
-typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
+typedef Common::FlatHashMap<reg_t, bool, reg_t_Hash> AddrSet;
 
 /**
  * Finds all used references and normalises them to their memory addresses
@@ -50,7 +52,9 @@ typedef Common::HashMap<reg_t, bool, reg_t_Hash> AddrSet;
 AddrSet *findAllActiveReferences(EngineState *s);
 
 /**
- * Runs garbage collection on the current system state
+ * Runs garbage collection on the current system state, and updates the
+ * statistics in s->gcStats. The whole heap is marked and swept in one go,
+ * any running incremental collection is discarded.
  * @param s The state in which we should gc
  */
 void run_gc(EngineState *s);
@@ -63,6 +67,61 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+enum {
+	/** Time an incremental collection may spend per frame, in milliseconds */
+	kGCStepTime = 2
+};
+
+/**
+ * A garbage collection which marks the heap over several frames, instead of
+ * pausing the game for all of it like run_gc().
+ *
+ * The game keeps running between the steps, so references may be written
+ * into entries which were already marked. Scripts and kernel functions
+ * write references through raw pointers, so there is no write barrier to
+ * catch this. Instead, the references held by each entry are recorded when
+ * it is marked. The last step marks the roots again, compares the recorded
+ * references of all marked entries to their current ones, and only rescans
+ * the entries which changed, before freeing the unreachable ones. Numbers
+ * are not recorded, so entries which only had numbers changed, like most
+ * long-lived objects, are not rescanned.
+ */
+class IncrementalGC {
+public:
+	IncrementalGC() : _running(false), _steps(0), _maxStepTime(0), _totalTime(0) {}
+
+	bool isRunning() const { return _running; }
+
+	/** Starts a new collection by adding the root set. */
+	void start(EngineState *s);
+
+	/**
+	 * Marks reachable entries for up to maxTime milliseconds. Once nothing
+	 * is left to mark, finishes the collection, and updates the statistics
+	 * in s->gcStats.
+	 * @return true if the collection was finished
+	 */
+	bool step(EngineState *s, uint32 maxTime);
+
+	/** Discards the running collection, if any. */
+	void cancel();
+
+private:
+	void finish(EngineState *s);
+
+	WorklistManager _wm;
+	/** The marked entries, in the order they were scanned */
+	Common::Array<reg_t> _scanned;
+	/** The references of _scanned[i] are _refs[_refsEnd[i - 1]] up to _refs[_refsEnd[i]] */
+	Common::Array<uint32> _refsEnd;
+	Common::Array<reg_t> _refs;
+
+	bool _running;
+	uint32 _steps;
+	uint32 _maxStepTime;
+	uint32 _totalTime;
+};
+
 
 } // End of namespace Sci
 
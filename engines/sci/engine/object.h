@@ -277,6 +277,7 @@ public:
 	reg_t &getVariableRef(uint var) { return _variables[var]; }
 
 	uint16 getMethodCount() const { return _methodCount; }
+	const byte *getBaseObjectData() const { return _baseObj.data(); }
 	reg_t getPos() const { return _pos; }
 
 	void saveLoadWithSerializer(Common::Serializer &ser);
@@ -68,6 +68,8 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_lockers = 1;
 	_markedAsDeleted = false;
 	_objects.clear();
+	_instructionIndex.clear();
+	_instructions.clear();
 
 	_offsetLookupArray.clear();
 	_offsetLookupObjectCount = 0;
@@ -647,6 +649,28 @@ const Object *Script::getObject(uint32 offset) const {
 		return 0;
 }
 
+const PMachineInstruction &Script::getInstruction(uint32 offset) {
+	if (_instructionIndex.empty())
+		_instructionIndex.resize(_buf->size());
+
+	const uint16 index = _instructionIndex[offset];
+	if (index)
+		return _instructions[index - 1];
+
+	// The index cannot refer to any more instructions, which should never
+	// happen in practice. Just decode them on every call then.
+	if (_instructions.size() == 0xFFFF) {
+		_uncachedInstruction.size = readPMachineInstruction(getBuf(offset), _uncachedInstruction.extOpcode, _uncachedInstruction.params);
+		return _uncachedInstruction;
+	}
+
+	PMachineInstruction instruction;
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.params);
+	_instructions.push_back(instruction);
+	_instructionIndex[offset] = _instructions.size();
+	return _instructions.back();
+}
+
 Object *Script::scriptObjInit(reg_t obj_pos, bool fullObjectInit) {
 	if (obj_pos.getOffset() >= _buf->size())
 		error("Attempt to initialize object beyond end of script %d (%u >= %u)", _nr, obj_pos.getOffset(), _buf->size());
@@ -94,6 +94,14 @@ private:
 
 	ObjMap _objects;	/**< Table for objects, contains property variables */
 
+	/**
+	 * For each offset into the buffer, the 1-based index of the instruction
+	 * at that offset in _instructions, or 0 if it has not been decoded yet.
+	 */
+	Common::Array<uint16> _instructionIndex;
+	Common::Array<PMachineInstruction> _instructions;
+	PMachineInstruction _uncachedInstruction;
+
 protected:
 	offsetLookupArrayType _offsetLookupArray; // Table of all elements of currently loaded script, that may get pointed to
 
@@ -155,6 +163,14 @@ public:
 	Object *getObject(uint32 offset);
 	const Object *getObject(uint32 offset) const;
 
+	/**
+	 * Returns the instruction at the given offset of the script buffer.
+	 * Each instruction is only decoded once, when it is executed for the
+	 * first time, and is then kept until the script is freed.
+	 * @note The returned reference is only valid until the next call.
+	 */
+	const PMachineInstruction &getInstruction(uint32 offset);
+
 	/**
 	 * Initializes an object within the segment manager
 	 * @param obj_pos	Location (segment, offset) of the object. It must
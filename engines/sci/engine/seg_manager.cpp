@@ -48,6 +48,8 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 	_bitmapSegId = 0;
 #endif
 
+	invalidateSelectorCache();
+
 	createClassTable();
 }
 
@@ -56,6 +58,8 @@ SegManager::~SegManager() {
 }
 
 void SegManager::resetSegMan() {
+	invalidateSelectorCache();
+
 	// Free memory
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (_heap[i])
@@ -167,6 +171,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		invalidateSelectorCache();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -184,6 +189,11 @@ void SegManager::deallocate(SegmentId seg) {
 	_heap[actualSegment] = NULL;
 }
 
+void SegManager::invalidateSelectorCache() {
+	for (uint i = 0; i < kSelectorCacheSize; i++)
+		_selectorCache[i].baseObj = nullptr;
+}
+
 bool SegManager::isHeapObject(reg_t pos) const {
 	const Object *obj = getObject(pos);
 	if (obj == NULL || (obj && obj->isFreed()))
@@ -1043,6 +1053,7 @@ int SegManager::instantiateScript(int scriptNum) {
 	}
 
 	scr->load(scriptNum, _resMan, _scriptPatcher);
+	invalidateSelectorCache();
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
 	scr->initializeObjects(this, segmentId);
@@ -397,6 +397,35 @@ public:
 	 */
 	bool isObject(reg_t obj) const { return getObject(obj) != NULL; }
 
+	/**
+	 * An entry of the cache used by lookupSelector(). The result of a lookup
+	 * only depends on the definition of the object in its script and on its
+	 * superclass, which is what the entries are keyed on.
+	 */
+	struct SelectorCacheEntry {
+		const byte *baseObj;
+		reg_t superClass;
+		Selector selector;
+		SelectorType type;
+		int varIndex;
+		reg_t func;
+	};
+
+	/**
+	 * Returns the cache entry for the given key. The entry needs to be
+	 * checked against the key, and may be overwritten if it does not match.
+	 */
+	SelectorCacheEntry &getSelectorCacheEntry(const byte *baseObj, Selector selector) {
+		const uint hash = (uint)((size_t)baseObj >> 1) ^ (selector * 2654435761U);
+		return _selectorCache[(hash >> 8) & (kSelectorCacheSize - 1)];
+	}
+
+	/**
+	 * Clears the selector lookup cache. This needs to happen whenever a
+	 * script is loaded or freed.
+	 */
+	void invalidateSelectorCache();
+
 	// TODO: document this
 	bool isHeapObject(reg_t pos) const;
 
@@ -465,6 +494,11 @@ private:
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
 
+	enum {
+		kSelectorCacheSize = 1024 ///< Number of entries, must be a power of two
+	};
+	SelectorCacheEntry _selectorCache[kSelectorCacheSize];
+
 	SegmentId _clonesSegId; ///< ID of the (a) clones segment
 	SegmentId _listsSegId; ///< ID of the (a) list segment
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
@@ -310,9 +310,26 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
+static SelectorType lookupSelectorUncached(SegManager *segMan, const Object *obj, Selector selectorId, int &varIndex, reg_t &func) {
+	varIndex = obj->locateVarSelector(segMan, selectorId);
+	if (varIndex >= 0)
+		return kSelectorVariable;
+
+	// Check if it's a method, with recursive lookup in superclasses
+	while (obj) {
+		const int index = obj->funcSelectorPosition(selectorId);
+		if (index >= 0) {
+			func = obj->getFunction(index);
+			return kSelectorMethod;
+		}
+		obj = segMan->getObject(obj->getSuperClassSelector());
+	}
+
+	return kSelectorNone;
+}
+
 SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
 	const Object *obj = segMan->getObject(obj_location);
-	int index;
 	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
 
 	// Early SCI versions used the LSB in the selector ID as a read/write
@@ -325,34 +342,30 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x, %s", PRINT_REG(obj_location), origin.toString().c_str());
 	}
 
-	index = obj->locateVarSelector(segMan, selectorId);
+	// Scripts send the same selectors to the same kinds of objects over and
+	// over again, so remember where they were found
+	const byte *baseObj = obj->getBaseObjectData();
+	const reg_t superClass = obj->getSuperClassSelector();
+	SegManager::SelectorCacheEntry uncachedEntry;
+	SegManager::SelectorCacheEntry *entry = baseObj ? &segMan->getSelectorCacheEntry(baseObj, selectorId) : &uncachedEntry;
+	if (!baseObj || entry->baseObj != baseObj || entry->selector != selectorId || entry->superClass != superClass) {
+		entry->baseObj = baseObj;
+		entry->selector = selectorId;
+		entry->superClass = superClass;
+		entry->type = lookupSelectorUncached(segMan, obj, selectorId, entry->varIndex, entry->func);
+	}
 
-	if (index >= 0) {
-		// Found it as a variable
+	if (entry->type == kSelectorVariable) {
 		if (varp) {
 			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
-	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
-			}
+			varp->varindex = entry->varIndex;
 		}
-
-		return kSelectorNone;
+	} else if (entry->type == kSelectorMethod) {
+		if (fptr)
+			*fptr = entry->func;
 	}
 
-
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return entry->type;
 }
 
 } // End of namespace Sci
@@ -24,6 +24,7 @@
 #include "sci/sci.h"	// for INCLUDE_OLDGFX
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
@@ -70,10 +71,13 @@ EngineState::EngineState(SegManager *segMan)
 : _segMan(segMan),
 	_dirseeker() {
 
+	incrementalGC = new IncrementalGC();
+	memset(&gcStats, 0, sizeof(gcStats));
 	reset(false);
 }
 
 EngineState::~EngineState() {
+	delete incrementalGC;
 	delete _msgState;
 }
 
@@ -100,6 +104,8 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	// The collection refers to the entries of the replaced heap
+	incrementalGC->cancel();
 
 #ifdef ENABLE_SCI32
 	_eventCounter = 0;
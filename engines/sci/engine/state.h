@@ -46,6 +46,7 @@ namespace Sci {
 class FileHandle;
 class DirSeeker;
 class EventManager;
+class IncrementalGC;
 class MessageState;
 class SoundCommandParser;
 class VirtualIndexFile;
@@ -98,6 +99,23 @@ struct SciCallOrigin {
 	}
 };
 
+/**
+ * Statistics about the garbage collections, shown by the gc_stats debugger
+ * command.
+ */
+struct GCStatistics {
+	uint32 collections;
+	uint32 incrementalCollections; ///< Collections spread over several frames
+	uint32 lastPause;     ///< Longest pause of the last collection, in milliseconds
+	uint32 maxPause;      ///< Longest pause of all collections, in milliseconds
+	uint32 totalPause;    ///< Time spent in all collections, in milliseconds
+	uint32 lastSteps;     ///< Number of frames the last collection was spread over
+	uint32 lastRescanned; ///< Number of entries the last collection scanned again, because the game changed them
+	uint32 lastReachable; ///< Number of reachable addresses found by the last collection
+	uint32 lastFreed;     ///< Number of entities freed by the last collection
+	uint32 totalFreed;    ///< Number of entities freed by all collections
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -189,6 +207,8 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	IncrementalGC *incrementalGC;
+	GCStatistics gcStats;
 
 	MessageState *_msgState;
 
@@ -201,6 +201,15 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 
 		s->variables[type][index] = value;
 
+		// Scripts set the new room number one cycle before the room is
+		// actually switched, which gives us some time to preload it
+		if (type == VAR_GLOBAL) {
+			if (index == kGlobalVarNewRoomNo)
+				g_sci->getResMan()->preloadRoom(value.toUint16());
+			else if (index == kGlobalVarCurrentRoomNo)
+				g_sci->getResMan()->setCurrentRoom(value.toUint16());
+		}
+
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
 	}
 }
@@ -340,6 +349,23 @@ static void addKernelCallToExecStack(EngineState *s, int kernelCallNr, int kerne
 	s->_executionStack.push_back(xstack);
 }
 
+/**
+ * Checks whether the given kernel function draws a frame of the game, which
+ * is where the game waits for the speed throttler.
+ */
+static bool isFrameKernelCall(int kernelCallNr) {
+	const Kernel *kernel = g_sci->getKernel();
+	if (kernelCallNr >= (int)kernel->_kernelFuncs.size())
+		return false;
+
+	KernelFunctionCall *function = kernel->_kernelFuncs[kernelCallNr].function;
+#ifdef ENABLE_SCI32
+	if (function == kFrameOut)
+		return true;
+#endif
+	return function == kAnimate;
+}
+
 static void callKernelFunc(EngineState *s, int kernelCallNr, int argc) {
 	Kernel *kernel = g_sci->getKernel();
 
@@ -656,8 +682,10 @@ void run_vm(EngineState *s) {
 			s->xs->addr.pc.getOffset(), scr->getBufSize());
 
 		// Get opcode
-		byte extOpcode;
-		s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+		const PMachineInstruction &instruction = scr->getInstruction(s->xs->addr.pc.getOffset());
+		const byte extOpcode = instruction.extOpcode;
+		memcpy(opparams, instruction.params, sizeof(opparams));
+		s->xs->addr.pc.incOffset(instruction.size);
 		const byte opcode = extOpcode >> 1;
 		//debug("%s: %d, %d, %d, %d, acc = %04x:%04x, script %d, local script %d", opcodeNames[opcode], opparams[0], opparams[1], opparams[2], opparams[3], PRINT_REG(s->r_acc), scr->getScriptNumber(), local_script->getScriptNumber());
 
@@ -880,10 +908,23 @@ void run_vm(EngineState *s) {
 		}
 
 		case op_callk: { // 0x21 (33)
-			// Run the garbage collector, if needed
+			// Run the garbage collector, if needed. Once it is due, it
+			// marks a part of the heap before each frame the game draws,
+			// so that the speed throttler can make up for the time spent
+			// collecting instead of the collection delaying the frame.
+			// Games which do not draw any frames for a while, or do not
+			// finish the collection within another interval, are collected
+			// all at once.
 			if (s->gcCountDown-- <= 0) {
-				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				if (s->gcCountDown < -s->scriptGCInterval) {
+					s->gcCountDown = s->scriptGCInterval;
+					run_gc(s);
+				} else if (isFrameKernelCall(opparams[0])) {
+					if (!s->incrementalGC->isRunning())
+						s->incrementalGC->start(s);
+					if (s->incrementalGC->step(s, kGCStepTime))
+						s->gcCountDown = s->scriptGCInterval;
+				}
 			}
 
 			// Call kernel function
@@ -416,6 +416,16 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+/**
+ * A PMachine instruction as decoded by readPMachineInstruction(), see
+ * Script::getInstruction().
+ */
+struct PMachineInstruction {
+	int16 params[4];
+	uint16 size;	///< Length of the encoded instruction, in bytes
+	byte extOpcode;
+};
+
 /**
  * Finds the script-absolute offset of a relative object offset.
  *
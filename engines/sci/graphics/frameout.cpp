@@ -73,6 +73,8 @@ GfxFrameout::GfxFrameout(SegManager *segMan, GfxPalette32 *palette, GfxTransitio
 	_palMorphIsOn(false),
 	_lastScreenUpdateTick(0) {
 
+	memset(&_statistics, 0, sizeof(_statistics));
+
 	if (g_sci->getGameId() == GID_PHANTASMAGORIA) {
 		_currentBuffer.create(630, 450, Graphics::PixelFormat::createFormatCLUT8());
 	} else if (_isHiRes) {
@@ -392,6 +394,8 @@ void GfxFrameout::kernelAddPicAt(const reg_t planeObject, const GuiResourceId pi
 #pragma mark Rendering
 
 void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseRect) {
+	const uint32 frameStartTime = g_system->getMillis();
+
 	updateMousePositionForRendering();
 
 	RobotDecoder &robotPlayer = g_sci->_video32->getRobotPlayer();
@@ -405,25 +409,23 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 	// ScreenItemList / RectList
 	ScreenItemListList screenItemLists;
 	EraseListList eraseLists;
+	ScreenItemListList paletteLists;
 
 	screenItemLists.resize(_planes.size());
 	eraseLists.resize(_planes.size());
+	paletteLists.resize(_planes.size());
 
 	if (g_sci->_gfxRemap32->getRemapCount() > 0 && _remapOccurred) {
 		remapMarkRedraw();
 	}
 
-	calcLists(screenItemLists, eraseLists, eraseRect);
+	calcLists(screenItemLists, eraseLists, paletteLists, eraseRect);
 
 	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
 		list->sort();
 	}
 
-	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
-		for (DrawList::iterator drawItem = list->begin(); drawItem != list->end(); ++drawItem) {
-			(*drawItem)->screenItem->getCelObj().submitPalette();
-		}
-	}
+	submitPalettes(screenItemLists, paletteLists);
 
 	_remapOccurred = _palette->updateForFrame();
 
@@ -445,6 +447,12 @@ void GfxFrameout::frameOut(const bool shouldShowBits, const Common::Rect &eraseR
 	if (robotIsActive) {
 		robotPlayer.frameNowVisible();
 	}
+
+	const uint32 frameTime = g_system->getMillis() - frameStartTime;
+	++_statistics.frames;
+	_statistics.lastFrameTime = frameTime;
+	_statistics.maxFrameTime = MAX(_statistics.maxFrameTime, frameTime);
+	_statistics.totalFrameTime += frameTime;
 }
 
 void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *showStyle) {
@@ -463,24 +471,22 @@ void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *show
 	// ScreenItemList / RectList
 	ScreenItemListList screenItemLists;
 	EraseListList eraseLists;
+	ScreenItemListList paletteLists;
 
 	screenItemLists.resize(_planes.size());
 	eraseLists.resize(_planes.size());
+	paletteLists.resize(_planes.size());
 
 	if (g_sci->_gfxRemap32->getRemapCount() > 0 && _remapOccurred) {
 		remapMarkRedraw();
 	}
 
-	calcLists(screenItemLists, eraseLists);
+	calcLists(screenItemLists, eraseLists, paletteLists);
 	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
 		list->sort();
 	}
 
-	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
-		for (DrawList::iterator drawItem = list->begin(); drawItem != list->end(); ++drawItem) {
-			(*drawItem)->screenItem->getCelObj().submitPalette();
-		}
-	}
+	submitPalettes(screenItemLists, paletteLists);
 
 	_remapOccurred = _palette->updateForFrame();
 
@@ -526,16 +532,12 @@ void GfxFrameout::palMorphFrameOut(const int8 *styleRanges, PlaneShowStyle *show
 		remapMarkRedraw();
 	}
 
-	calcLists(screenItemLists, eraseLists);
+	calcLists(screenItemLists, eraseLists, paletteLists);
 	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
 		list->sort();
 	}
 
-	for (ScreenItemListList::iterator list = screenItemLists.begin(); list != screenItemLists.end(); ++list) {
-		for (DrawList::iterator drawItem = list->begin(); drawItem != list->end(); ++drawItem) {
-			(*drawItem)->screenItem->getCelObj().submitPalette();
-		}
-	}
+	submitPalettes(screenItemLists, paletteLists);
 
 	_remapOccurred = _palette->updateForFrame();
 
@@ -667,7 +669,19 @@ int splitRectsForRender(Common::Rect &middleRect, const Common::Rect &showRect,
 }
 
 // The third rectangle parameter is only ever passed by VMD code
-void GfxFrameout::calcLists(ScreenItemListList &drawLists, EraseListList &eraseLists, const Common::Rect &eraseRect) {
+void GfxFrameout::calcLists(ScreenItemListList &drawLists, EraseListList &eraseLists, ScreenItemListList &paletteLists, const Common::Rect &eraseRect) {
+	const uint32 startTime = g_system->getMillis();
+
+	calcListsInternal(drawLists, eraseLists, paletteLists, eraseRect);
+
+	const uint32 calcListsTime = g_system->getMillis() - startTime;
+	++_statistics.calcListsCalls;
+	_statistics.lastCalcListsTime = calcListsTime;
+	_statistics.maxCalcListsTime = MAX(_statistics.maxCalcListsTime, calcListsTime);
+	_statistics.totalCalcListsTime += calcListsTime;
+}
+
+void GfxFrameout::calcListsInternal(ScreenItemListList &drawLists, EraseListList &eraseLists, ScreenItemListList &paletteLists, const Common::Rect &eraseRect) {
 	RectList eraseList;
 	Common::Rect outRects[4];
 	int deletedPlaneCount = 0;
@@ -854,7 +868,7 @@ void GfxFrameout::calcLists(ScreenItemListList &drawLists, EraseListList &eraseL
 					error("Missing visible plane for source plane %04x:%04x", PRINT_REG(plane._object));
 				}
 
-				plane.calcLists(*visiblePlane, _planes, drawLists[planeIndex], eraseLists[planeIndex]);
+				plane.calcLists(*visiblePlane, _planes, drawLists[planeIndex], eraseLists[planeIndex], paletteLists[planeIndex]);
 			}
 		} else {
 			plane.decrementScreenItemArrayCounts(visiblePlane, false);
@@ -908,6 +922,28 @@ void GfxFrameout::calcLists(ScreenItemListList &drawLists, EraseListList &eraseL
 	}
 }
 
+void GfxFrameout::submitPalettes(const ScreenItemListList &drawLists, ScreenItemListList &paletteLists) {
+	for (ScreenItemListList::size_type i = 0; i < drawLists.size(); ++i) {
+		const DrawList &drawList = drawLists[i];
+		DrawList &paletteList = paletteLists[i];
+		paletteList.sort();
+
+		// Merge both sorted lists, so the palettes of the items which were not
+		// redrawn are submitted at the same point as if they had been
+		DrawList::const_iterator drawItem = drawList.begin();
+		DrawList::const_iterator paletteItem = paletteList.begin();
+		while (drawItem != drawList.end() || paletteItem != paletteList.end()) {
+			if (paletteItem == paletteList.end() || (drawItem != drawList.end() && !(**paletteItem < **drawItem))) {
+				(*drawItem)->screenItem->getCelObj().submitPalette();
+				++drawItem;
+			} else {
+				(*paletteItem)->screenItem->getCelObj().submitPalette();
+				++paletteItem;
+			}
+		}
+	}
+}
+
 void GfxFrameout::drawEraseList(const RectList &eraseList, const Plane &plane) {
 	if (plane._type != kPlaneTypeColored) {
 		return;
@@ -36,6 +36,24 @@ class GfxCursor32;
 class GfxTransitions32;
 struct PlaneShowStyle;
 
+/**
+ * Counters describing the work done by `GfxFrameout::frameOut`, shown by the
+ * frameout_stats console command.
+ */
+struct FrameoutStatistics {
+	uint32 frames;
+	uint32 lastFrameTime;      ///< Duration of the last frame, in milliseconds
+	uint32 maxFrameTime;       ///< Duration of the longest frame, in milliseconds
+	uint32 totalFrameTime;     ///< Time spent in all frames, in milliseconds
+	uint32 calcListsCalls;
+	uint32 lastCalcListsTime;  ///< Duration of the last calcLists call, in milliseconds
+	uint32 maxCalcListsTime;   ///< Duration of the longest calcLists call, in milliseconds
+	uint32 totalCalcListsTime; ///< Time spent in all calcLists calls, in milliseconds
+	uint32 screenItemsCalculated; ///< Number of screen items whose rects were recalculated
+	uint32 redundantUpdates;   ///< Number of screen item updates which did not change anything
+	uint32 screenItemsIndexed; ///< Number of screen items moved in the screen item grids
+};
+
 /**
  * Frameout class, kFrameOut and relevant functions for SCI32 games.
  * Roughly equivalent to GraphicsMgr in SSCI.
@@ -345,10 +363,24 @@ private:
 	 * Calculates the location and dimensions of dirty rects over the entire
 	 * screen for rendering the next frame. The draw and erase lists in
 	 * `drawLists` and `eraseLists` each represent one plane on the screen.
-	 * The optional `eraseRect` argument allows a specific area of the screen to
-	 * be explicitly erased.
+	 * The screen items in `paletteLists` are not drawn, but their palettes
+	 * have to be submitted along with those of the draw lists. The optional
+	 * `eraseRect` argument allows a specific area of the screen to be
+	 * explicitly erased.
+	 */
+	void calcLists(ScreenItemListList &drawLists, EraseListList &eraseLists, ScreenItemListList &paletteLists, const Common::Rect &eraseRect = Common::Rect());
+
+	/**
+	 * Does the work of `calcLists`, which records its timing.
 	 */
-	void calcLists(ScreenItemListList &drawLists, EraseListList &eraseLists, const Common::Rect &eraseRect = Common::Rect());
+	void calcListsInternal(ScreenItemListList &drawLists, EraseListList &eraseLists, ScreenItemListList &paletteLists, const Common::Rect &eraseRect);
+
+	/**
+	 * Submits the palettes of the screen items in the sorted draw lists and
+	 * in the palette lists from `calcLists`, in the order of the screen
+	 * items.
+	 */
+	void submitPalettes(const ScreenItemListList &drawLists, ScreenItemListList &paletteLists);
 
 	/**
 	 * Erases the areas in the given erase list from the visible screen buffer
@@ -425,7 +457,12 @@ private:
 
 #pragma mark -
 #pragma mark Debugging
+private:
+	FrameoutStatistics _statistics;
+
 public:
+	FrameoutStatistics &getStatistics() { return _statistics; }
+
 	void printPlaneList(Console *con) const;
 	void printVisiblePlaneList(Console *con) const;
 	void printPlaneListInternal(Console *con, const PlaneList &planeList) const;
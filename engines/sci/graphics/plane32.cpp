@@ -314,9 +314,16 @@ void Plane::breakEraseListByPlanes(RectList &eraseList, const PlaneList &planeLi
 	eraseList.pack();
 }
 
-void Plane::calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList &drawList, RectList &eraseList) {
+void Plane::calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList &drawList, RectList &eraseList, DrawList &paletteList) {
 	const ScreenItemList::size_type screenItemCount = _screenItemList.size();
 	const ScreenItemList::size_type visiblePlaneItemCount = visiblePlane._screenItemList.size();
+	FrameoutStatistics &stats = g_sci->_gfxFrameout->getStatistics();
+
+	// Scripts update most of their screen items every frame whether or not
+	// anything about them changed. As long as the plane did not change
+	// either, recalculating and redrawing such items would give the same
+	// result, so they are treated as if they had not been updated.
+	const bool skipRedundantUpdates = !_created && !_updated && !_moved && g_sci->_gfxRemap32->getRemapCount() == 0;
 
 	for (ScreenItemList::size_type i = 0; i < screenItemCount; ++i) {
 		// Items can be added to ScreenItemList and we don't want to process
@@ -363,11 +370,26 @@ void Plane::calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList
 			}
 		}
 
+		if (
+			skipRedundantUpdates && item->_updated &&
+			!item->_created && !item->_deleted &&
+			item->isUpdateRedundant()
+		) {
+			// The palette of an updated item is still submitted, since it may
+			// restore colors which other palettes replaced in the meantime
+			if (!item->_screenRect.isEmpty()) {
+				paletteList.add(item, item->_screenRect);
+			}
+			item->_updated = 0;
+			++stats.redundantUpdates;
+		}
+
 		if (!item->_created && !item->_updated) {
 			continue;
 		}
 
 		item->calcRects(*this);
+		++stats.screenItemsCalculated;
 		const Common::Rect itemScreenRect(item->_screenRect);
 
 		if (item->_created) {
@@ -425,12 +447,17 @@ void Plane::calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList
 	// Remove parts of eraselist/drawlist that are covered by other planes
 	breakEraseListByPlanes(eraseList, planeList);
 	breakDrawListByPlanes(drawList, planeList);
+	breakDrawListByPlanes(paletteList, planeList);
 
 	// The current size of the draw list is stored here, as we need to loop over
 	// only the already-inserted entries later.
 	DrawList::size_type drawListSizePrimary = drawList.size();
 	const RectList::size_type eraseListCount = eraseList.size();
 
+	// All screen rects are up to date now. The SCI3 code below sorts the list
+	// in place, but restores its order before the grid is used.
+	stats.screenItemsIndexed += _screenItemGrid.update(_screenItemList, _screenRect);
+
 	if (getSciVersion() == SCI_VERSION_3) {
 		_screenItemList.sort();
 		bool pictureDrawn = false;
@@ -478,7 +505,9 @@ void Plane::calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList
 		// Add all items overlapping the erase list to the draw list
 		for (RectList::size_type i = 0; i < eraseListCount; ++i) {
 			const Common::Rect &rect = *eraseList[i];
-			for (ScreenItemList::size_type j = 0; j < screenItemCount; ++j) {
+			ScreenItemGrid::SlotSet candidates;
+			_screenItemGrid.find(rect, candidates);
+			for (ScreenItemList::size_type j = candidates.findNext(0); j < screenItemCount; j = candidates.findNext(j + 1)) {
 				ScreenItem *item = _screenItemList[j];
 				if (
 					item != nullptr &&
@@ -504,7 +533,13 @@ void Plane::calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList
 				drawListEntry = drawList[i];
 			}
 
-			for (ScreenItemList::size_type j = 0; j < screenItemCount; ++j) {
+			if (drawListEntry == nullptr) {
+				continue;
+			}
+
+			ScreenItemGrid::SlotSet candidates;
+			_screenItemGrid.find(drawListEntry->rect, candidates);
+			for (ScreenItemList::size_type j = candidates.findNext(0); j < screenItemCount; j = candidates.findNext(j + 1)) {
 				ScreenItem *newItem = nullptr;
 				if (j < _screenItemList.size()) {
 					newItem = _screenItemList[j];
@@ -884,6 +919,109 @@ void Plane::remapMarkRedraw() {
 	}
 }
 
+#pragma mark -
+#pragma mark ScreenItemGrid
+
+ScreenItemGrid::ScreenItemGrid() :
+	_cellWidth(1),
+	_cellHeight(1),
+	_slotCount(0) {
+	for (uint i = 0; i < kMaxSlots; ++i) {
+		_slots[i].screenItem = nullptr;
+	}
+}
+
+uint ScreenItemGrid::update(const ScreenItemList &screenItemList, const Common::Rect &bounds) {
+	if (bounds != _bounds) {
+		_bounds = bounds;
+		_cellWidth = MAX<int16>(1, (bounds.width() + kCellsX - 1) / kCellsX);
+		_cellHeight = MAX<int16>(1, (bounds.height() + kCellsY - 1) / kCellsY);
+
+		for (int i = 0; i < kCellsX * kCellsY; ++i) {
+			_cells[i].clear();
+		}
+		_occupied.clear();
+		for (uint i = 0; i < _slotCount; ++i) {
+			_slots[i].screenItem = nullptr;
+		}
+		_slotCount = 0;
+	}
+
+	const uint listSize = screenItemList.size();
+	const uint slotCount = MAX(listSize, _slotCount);
+	uint movedCount = 0;
+	for (uint i = 0; i < slotCount; ++i) {
+		const ScreenItem *screenItem = i < listSize ? screenItemList[i] : nullptr;
+		Slot &slot = _slots[i];
+
+		if (screenItem == slot.screenItem && (screenItem == nullptr || screenItem->_screenRect == slot.rect)) {
+			continue;
+		}
+
+		if (slot.screenItem != nullptr) {
+			removeSlot(i);
+		}
+
+		if (screenItem != nullptr) {
+			addSlot(i, screenItem->_screenRect);
+		}
+
+		slot.screenItem = screenItem;
+		++movedCount;
+	}
+
+	_slotCount = listSize;
+	return movedCount;
+}
+
+void ScreenItemGrid::find(const Common::Rect &rect, SlotSet &slots) const {
+	int x1, y1, x2, y2;
+	getCellRange(rect, x1, y1, x2, y2);
+
+	if ((x2 - x1 + 1) * (y2 - y1 + 1) > kMaxQueryCells) {
+		slots.addAll(_occupied);
+		return;
+	}
+
+	for (int y = y1; y <= y2; ++y) {
+		for (int x = x1; x <= x2; ++x) {
+			slots.addAll(_cells[y * kCellsX + x]);
+		}
+	}
+}
+
+void ScreenItemGrid::getCellRange(const Common::Rect &rect, int &x1, int &y1, int &x2, int &y2) const {
+	x1 = CLIP<int>((rect.left - _bounds.left) / _cellWidth, 0, kCellsX - 1);
+	y1 = CLIP<int>((rect.top - _bounds.top) / _cellHeight, 0, kCellsY - 1);
+	x2 = CLIP<int>((MAX(rect.right - 1, (int)rect.left) - _bounds.left) / _cellWidth, x1, kCellsX - 1);
+	y2 = CLIP<int>((MAX(rect.bottom - 1, (int)rect.top) - _bounds.top) / _cellHeight, y1, kCellsY - 1);
+}
+
+void ScreenItemGrid::addSlot(const uint slot, const Common::Rect &rect) {
+	_slots[slot].rect = rect;
+	_occupied.add(slot);
+
+	int x1, y1, x2, y2;
+	getCellRange(rect, x1, y1, x2, y2);
+	for (int y = y1; y <= y2; ++y) {
+		for (int x = x1; x <= x2; ++x) {
+			_cells[y * kCellsX + x].add(slot);
+		}
+	}
+}
+
+void ScreenItemGrid::removeSlot(const uint slot) {
+	_occupied.remove(slot);
+
+	int x1, y1, x2, y2;
+	getCellRange(_slots[slot].rect, x1, y1, x2, y2);
+	for (int y = y1; y <= y2; ++y) {
+		for (int x = x1; x <= x2; ++x) {
+			_cells[y * kCellsX + x].remove(slot);
+		}
+	}
+}
+
 #pragma mark -
 #pragma mark PlaneList
 
@@ -94,6 +94,145 @@ public:
 
 class PlaneList;
 
+#pragma mark -
+#pragma mark ScreenItemGrid
+
+/**
+ * A coarse grid over the screen rect of a plane, which records the slots of
+ * the plane's screen item list whose screen rects overlap each cell. It is
+ * used to find the screen items which intersect a dirty rect without testing
+ * every screen item of the plane.
+ *
+ * The grid is kept from one frame to the next, and only the slots whose screen
+ * item or screen rect changed since the last call to `update` are moved.
+ */
+class ScreenItemGrid {
+public:
+	enum {
+		/**
+		 * The capacity of ScreenItemList.
+		 */
+		kMaxSlots = 250
+	};
+
+	/**
+	 * A set of screen item list slots.
+	 */
+	class SlotSet {
+	public:
+		enum { kWords = (kMaxSlots + 31) / 32 };
+
+		SlotSet() { clear(); }
+
+		void clear() {
+			for (int i = 0; i < kWords; ++i) {
+				_bits[i] = 0;
+			}
+		}
+
+		void add(const uint slot) { _bits[slot >> 5] |= 1U << (slot & 31); }
+		void remove(const uint slot) { _bits[slot >> 5] &= ~(1U << (slot & 31)); }
+
+		void addAll(const SlotSet &other) {
+			for (int i = 0; i < kWords; ++i) {
+				_bits[i] |= other._bits[i];
+			}
+		}
+
+		/**
+		 * Returns the first slot in the set at or after `slot`, or `kMaxSlots`
+		 * if there is none.
+		 */
+		uint findNext(uint slot) const {
+			while (slot < kMaxSlots) {
+				const uint32 word = _bits[slot >> 5] >> (slot & 31);
+				if (word == 0) {
+					slot = (slot | 31) + 1;
+				} else if (word & 1) {
+					return slot;
+				} else {
+					++slot;
+				}
+			}
+
+			return kMaxSlots;
+		}
+
+	private:
+		uint32 _bits[kWords];
+	};
+
+	ScreenItemGrid();
+
+	/**
+	 * Moves the slots whose screen item or screen rect changed since the last
+	 * call to the cells that their current screen rects overlap. If the bounds
+	 * changed, the grid is rebuilt.
+	 *
+	 * @returns the number of slots that were moved.
+	 */
+	uint update(const ScreenItemList &screenItemList, const Common::Rect &bounds);
+
+	/**
+	 * Adds the slots of all screen items whose screen rects may intersect
+	 * `rect` to `slots`. This includes every screen item whose screen rect
+	 * intersects `rect`, and possibly some others.
+	 */
+	void find(const Common::Rect &rect, SlotSet &slots) const;
+
+private:
+	enum {
+		kCellsX = 16,
+		kCellsY = 16,
+
+		/**
+		 * Queries which span more cells than this just return all occupied
+		 * slots, which is cheaper than collecting the cells.
+		 */
+		kMaxQueryCells = 24
+	};
+
+	struct Slot {
+		const ScreenItem *screenItem;
+		Common::Rect rect;
+	};
+
+	/**
+	 * The rect covered by the grid. Rects outside of it are clamped to the
+	 * cells along its edges.
+	 */
+	Common::Rect _bounds;
+
+	int16 _cellWidth, _cellHeight;
+
+	/**
+	 * The number of slots at the start of `_slots` which may be in use.
+	 */
+	uint _slotCount;
+
+	/**
+	 * The screen item and screen rect each slot was last entered with.
+	 */
+	Slot _slots[kMaxSlots];
+
+	/**
+	 * All slots that are in use.
+	 */
+	SlotSet _occupied;
+
+	SlotSet _cells[kCellsX * kCellsY];
+
+	/**
+	 * Gets the range of cells covered by the given rect. Empty rects cover
+	 * the cell of their top-left corner, since Common::Rect::intersects
+	 * considers them to intersect rects around that point.
+	 */
+	void getCellRange(const Common::Rect &rect, int &x1, int &y1, int &x2, int &y2) const;
+
+	void addSlot(const uint slot, const Common::Rect &rect);
+	void removeSlot(const uint slot);
+};
+
 #pragma mark -
 #pragma mark Plane
 
@@ -356,6 +495,12 @@ public:
 #pragma mark -
 #pragma mark Plane - Rendering
 private:
+	/**
+	 * The location of the screen items of this plane, used to find the screen
+	 * items which need to be redrawn in `calcLists`.
+	 */
+	ScreenItemGrid _screenItemGrid;
+
 	/**
 	 * Splits all rects in the given draw list at the edges of all
 	 * higher-priority, non-transparent, intersecting planes.
@@ -387,9 +532,11 @@ public:
 	 * Calculates the location and dimensions of dirty rects of the screen items
 	 * in this plane and adds them to the given draw and erase lists, and
 	 * synchronises this plane's list of screen items to the given visible
-	 * plane.
+	 * plane. Updated screen items which are not redrawn because nothing about
+	 * them changed are added to `paletteList`, whose palettes must still be
+	 * submitted.
 	 */
-	void calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList &drawList, RectList &eraseList);
+	void calcLists(Plane &visiblePlane, const PlaneList &planeList, DrawList &drawList, RectList &eraseList, DrawList &paletteList);
 
 	/**
 	 * Synchronises changes to screen items from the current plane to the
@@ -258,6 +258,18 @@ void ScreenItem::calcRects(const Plane &plane) {
 
 	const CelObj &celObj = getCelObj();
 
+	_lastCalcRectsState.valid = true;
+	_lastCalcRectsState.celInfo = _celInfo;
+	_lastCalcRectsState.position = _position;
+	_lastCalcRectsState.scale = _scale;
+	_lastCalcRectsState.fixedPriority = _fixedPriority;
+	_lastCalcRectsState.priority = _priority;
+	_lastCalcRectsState.z = _z;
+	_lastCalcRectsState.useInsetRect = _useInsetRect;
+	_lastCalcRectsState.insetRect = _insetRect;
+	_lastCalcRectsState.mirrorX = _mirrorX;
+	_lastCalcRectsState.drawBlackLines = _drawBlackLines;
+
 	Common::Rect celRect(celObj._width, celObj._height);
 	if (_useInsetRect) {
 		if (_insetRect.intersects(celRect)) {
@@ -470,6 +482,32 @@ void ScreenItem::calcRects(const Plane &plane) {
 	}
 }
 
+bool ScreenItem::isUpdateRedundant() const {
+	const CalcRectsState &last = _lastCalcRectsState;
+
+	if (!last.valid || _celInfo.type != kCelTypeView || !_celObj || _celObj->_remap) {
+		return false;
+	}
+
+	// When it is not used, the inset rect is replaced by the cel rect in
+	// calcRects, so only compare it if it came from the VM object
+	return (
+		_celInfo == last.celInfo &&
+		_position == last.position &&
+		_scale.x == last.scale.x &&
+		_scale.y == last.scale.y &&
+		_scale.max == last.scale.max &&
+		_scale.signal == last.scale.signal &&
+		_fixedPriority == last.fixedPriority &&
+		_priority == last.priority &&
+		_z == last.z &&
+		_useInsetRect == last.useInsetRect &&
+		(!_useInsetRect || _insetRect == last.insetRect) &&
+		_mirrorX == last.mirrorX &&
+		_drawBlackLines == last.drawBlackLines
+	);
+}
+
 CelObj &ScreenItem::getCelObj() const {
 	if (!_celObj) {
 		switch (_celInfo.type) {
@@ -116,6 +116,26 @@ private:
 	 */
 	void setFromObject(SegManager *segMan, const reg_t object, const bool updateCel, const bool updateBitmap);
 
+	/**
+	 * The properties which were used the last time `calcRects` was called for
+	 * this screen item.
+	 */
+	struct CalcRectsState {
+		bool valid;
+		CelInfo32 celInfo;
+		Common::Point position;
+		ScaleInfo scale;
+		bool fixedPriority;
+		int16 priority;
+		int z;
+		bool useInsetRect;
+		Common::Rect insetRect;
+		bool mirrorX;
+		bool drawBlackLines;
+
+		CalcRectsState() : valid(false) {}
+	} _lastCalcRectsState;
+
 public:
 	/**
 	 * The creation order number, which ensures a stable sort when screen items
@@ -326,6 +346,16 @@ public:
 	 */
 	void calcRects(const Plane &plane);
 
+	/**
+	 * Returns true if none of the properties which determine the screen rect
+	 * and the pixels of this screen item have changed since `calcRects` was
+	 * last called. Only view cels without remapping qualify, since the pixels
+	 * of bitmaps and remapped cels can change without any property changing.
+	 * Screen items whose updates are redundant need not be redrawn, as long as
+	 * their plane did not change either.
+	 */
+	bool isUpdateRedundant() const;
+
 	/**
 	 * Retrieves the corresponding cel object for this screen item. If a cel
 	 * object does not already exist, one will be created and assigned.
@@ -22,9 +22,11 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -967,6 +969,14 @@ void ResourceManager::init() {
 	_memoryLocked = 0;
 	_memoryLRU = 0;
 	_LRU.clear();
+	_memoryPreloaded = 0;
+	_currentRoom = 0;
+	_preloadedRoom = 0;
+	_roomResources.clear();
+	_preloadQueue.clear();
+	// Start with a pessimistic guess, preloadNext() measures the real speed
+	_preloadBytesPerMs = 16 * 1024;
+	resetCacheStats();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1021,6 +1031,14 @@ void ResourceManager::init() {
 		_maxMemoryLRU = 4096 * 1024; // 4MiB
 	}
 
+	// Allow users with plenty of memory to keep more resources around, which
+	// avoids reloading and decompressing them whenever a room is revisited
+	if (!_detectionMode && ConfMan.hasKey("resource_cache_size")) {
+		const int budget = ConfMan.getInt("resource_cache_size");
+		if (budget > 0)
+			_maxMemoryLRU = budget * 1024;
+	}
+
 	switch (_viewType) {
 	case kViewEga:
 		debugC(1, kDebugLevelResMan, "resMan: Detected EGA graphic resources");
@@ -1109,6 +1127,8 @@ void ResourceManager::freeOldResources() {
 		assert(!_LRU.empty());
 		Resource *goner = _LRU.back();
 		removeFromLRU(goner);
+		_cacheStats.evictions++;
+		_cacheStats.evictedBytes += goner->size();
 		goner->unalloc();
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
@@ -1135,15 +1155,20 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheStats.misses++;
+		rememberRoomResource(id);
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
-		// The resource is removed from its current position
-		// in the LRU list because it has been requested
-		// again. Below, it will either be locked, or it
-		// will be added back to the LRU list at the 'most
-		// recent' position.
-		removeFromLRU(retval);
+	} else {
+		_cacheStats.hits++;
+		if (retval->_status == kResStatusEnqueued)
+			// The resource is removed from its current position
+			// in the LRU list because it has been requested
+			// again. Below, it will either be locked, or it
+			// will be added back to the LRU list at the 'most
+			// recent' position.
+			removeFromLRU(retval);
+	}
 
 	// Unless an error occurred, the resource is now either
 	// locked or allocated, but never queued or freed.
@@ -1187,6 +1212,118 @@ void ResourceManager::unlockResource(Resource *res) {
 	freeOldResources();
 }
 
+void ResourceManager::resetCacheStats() {
+	memset(&_cacheStats, 0, sizeof(_cacheStats));
+}
+
+void ResourceManager::setCacheBudget(int bytes) {
+	_maxMemoryLRU = bytes;
+	freeOldResources();
+}
+
+void ResourceManager::rememberRoomResource(const ResourceId &id) {
+	if (_detectionMode)
+		return;
+
+	// Speech is specific to a single message, and usually played once
+	const ResourceType type = id.getType();
+	if (type == kResourceTypeAudio36 || type == kResourceTypeSync36)
+		return;
+
+	Common::Array<ResourceId> &resources = _roomResources[_currentRoom];
+	if (resources.size() >= kMaxRoomResources)
+		return;
+
+	for (uint i = 0; i < resources.size(); i++) {
+		if (resources[i] == id)
+			return;
+	}
+	resources.push_back(id);
+}
+
+void ResourceManager::preloadRoom(uint16 roomNumber) {
+	if (roomNumber == _preloadedRoom || roomNumber == _currentRoom || _detectionMode)
+		return;
+
+	_preloadedRoom = roomNumber;
+	_preloadQueue.clear();
+	_memoryPreloaded = 0;
+
+	// Rooms are usually implemented by the script and drawn with the pic
+	// having the same number as the room. Queue those first, so that they
+	// are available even on the first visit of the room.
+	_preloadQueue.push_back(ResourceId(kResourceTypeScript, roomNumber));
+	if (getSciVersion() >= SCI_VERSION_1_1)
+		_preloadQueue.push_back(ResourceId(kResourceTypeHeap, roomNumber));
+	_preloadQueue.push_back(ResourceId(kResourceTypePic, roomNumber));
+
+	RoomResourceMap::const_iterator it = _roomResources.find(roomNumber);
+	if (it != _roomResources.end()) {
+		for (uint i = 0; i < it->_value.size(); i++)
+			_preloadQueue.push_back(it->_value[i]);
+	}
+}
+
+void ResourceManager::setCurrentRoom(uint16 roomNumber) {
+	if (_detectionMode)
+		return;
+
+	_currentRoom = roomNumber;
+	if (roomNumber != _preloadedRoom) {
+		// Restored games switch rooms without announcing the new room first
+		_preloadedRoom = roomNumber;
+		_preloadQueue.clear();
+	}
+}
+
+bool ResourceManager::preloadNext(uint32 deadline) {
+	Common::List<ResourceId>::iterator it = _preloadQueue.begin();
+	while (it != _preloadQueue.end()) {
+		// Preloaded resources may displace older resources from the cache,
+		// but never use more than half of it, to not evict each other or
+		// the resources the game is currently working with
+		if (_memoryPreloaded >= _maxMemoryLRU / 2) {
+			_preloadQueue.clear();
+			break;
+		}
+
+		Resource *res = testResource(*it);
+		if (!res || res->_status != kResStatusNoMalloc) {
+			it = _preloadQueue.erase(it);
+			continue;
+		}
+
+		// Leave resources which would take longer to load than the time we
+		// have left for a later, longer pause
+		const uint32 start = g_system->getMillis();
+		const uint32 estimate = res->size() / _preloadBytesPerMs + 1;
+		if (start + estimate >= deadline) {
+			++it;
+			continue;
+		}
+		_preloadQueue.erase(it);
+
+		loadResource(res);
+		if (res->_status != kResStatusAllocated || !res->data()) {
+			// Leave handling the error to the actual lookup
+			res->unalloc();
+			return true;
+		}
+
+		const uint32 elapsed = MAX<uint32>(g_system->getMillis() - start, 1);
+		const uint32 bytesPerMs = MAX<uint32>(res->size() / elapsed, 1);
+		_preloadBytesPerMs = (_preloadBytesPerMs * 3 + bytesPerMs) / 4;
+
+		_cacheStats.preloads++;
+		_memoryPreloaded += res->size();
+		addToLRU(res);
+		freeOldResources();
+		return true;
+	}
+
+	return false;
+}
+
 const char *ResourceManager::versionDescription(ResVersion version) const {
 	switch (version) {
 	case kResVersionUnknown:
@@ -24,6 +24,7 @@
 #define SCI_RESOURCE_H
 
 #include "common/str.h"
+#include "common/array.h"
 #include "common/list.h"
 #include "common/hashmap.h"
 
@@ -398,6 +399,55 @@ public:
 	const char *getVolVersionDesc() const { return versionDescription(_volVersion); }
 	ResVersion getVolVersion() const { return _volVersion; }
 
+	/**
+	 * Counters for the cache of unlocked resources, shown by the
+	 * `resource_cache` debugger command.
+	 */
+	struct CacheStats {
+		uint32 hits;         ///< Lookups of resources which were in memory
+		uint32 misses;       ///< Lookups which had to load the resource
+		uint32 evictions;    ///< Resources freed to stay within the budget
+		uint32 evictedBytes; ///< Total size of the evicted resources
+		uint32 preloads;     ///< Resources loaded ahead of time by preloadNext()
+	};
+
+	const CacheStats &getCacheStats() const { return _cacheStats; }
+	void resetCacheStats();
+
+	/**
+	 * Gets/sets the number of bytes of unlocked resources which are kept in
+	 * memory. Lowering the budget frees resources immediately.
+	 */
+	int getCacheBudget() const { return _maxMemoryLRU; }
+	void setCacheBudget(int bytes);
+	int getCacheMemory() const { return _memoryLRU; }
+	int getLockedMemory() const { return _memoryLocked; }
+
+	/**
+	 * Informs the resource manager that the game is about to switch to
+	 * another room. The resources remembered from earlier visits of the
+	 * room, as well as its script and pic, are queued for preloading.
+	 */
+	void preloadRoom(uint16 roomNumber);
+
+	/**
+	 * Informs the resource manager that the game has switched to another
+	 * room. Resources loaded from now on are remembered as part of the
+	 * working set of that room.
+	 */
+	void setCurrentRoom(uint16 roomNumber);
+
+	/**
+	 * Loads the next queued resource which can be loaded before the deadline
+	 * into the cache. This is meant to be called while the engine is idle.
+	 * @param deadline	time in milliseconds, as returned by OSystem::getMillis()
+	 * @return false if there was nothing to preload in time
+	 */
+	bool preloadNext(uint32 deadline);
+
+	/** Returns the number of resources queued for preloading. */
+	uint getPreloadQueueSize() const { return _preloadQueue.size(); }
+
 	/**
 	 * Adds the appropriate GM patch from the Sierra MIDI utility as 4.pat, without
 	 * requiring the user to rename the file to 4.pat. Thus, the original Sierra
@@ -480,6 +530,21 @@ protected:
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	CacheStats _cacheStats;
+
+	enum {
+		/** Maximum number of resources remembered for a single room */
+		kMaxRoomResources = 256
+	};
+
+	/** The resources loaded while in a room, by room number */
+	typedef Common::HashMap<uint16, Common::Array<ResourceId> > RoomResourceMap;
+	RoomResourceMap _roomResources;
+	uint16 _currentRoom;
+	uint16 _preloadedRoom; ///< The room the queued resources belong to
+	Common::List<ResourceId> _preloadQueue;
+	int _memoryPreloaded; ///< Bytes preloaded since the last room change
+	uint32 _preloadBytesPerMs; ///< Measured speed of loading resources
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -613,6 +678,7 @@ protected:
 
 	void printLRU();
 	void addToLRU(Resource *res);
+	void rememberRoomResource(const ResourceId &id);
 	void removeFromLRU(Resource *res);
 
 	ResourceCompression getViewCompression();
@@ -34,6 +34,7 @@
 #include "sci/event.h"
 
 #include "sci/engine/features.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/message.h"
 #include "sci/engine/object.h"
@@ -533,6 +534,7 @@ bool SciEngine::initGame() {
 
 	_gamestate->_msgState = new MessageState(_gamestate->_segMan);
 	_gamestate->gcCountDown = GC_INTERVAL - 1;
+	_gamestate->incrementalGC->cancel();
 
 	// Script 0 should always be at segment 1
 	if (script0Segment != 1) {
@@ -869,7 +871,10 @@ void SciEngine::sleep(uint32 msecs) {
 #endif
 		time = g_system->getMillis();
 		if (time + 10 < wakeUpTime) {
-			g_system->delayMillis(10);
+			// Use the time to warm up the resource cache for the
+			// next room, if anything is left to load in time
+			if (!_resMan->preloadNext(wakeUpTime - 10))
+				g_system->delayMillis(10);
 		} else {
 			if (time < wakeUpTime)
 				g_system->delayMillis(wakeUpTime - time);
@@ -37,6 +37,8 @@
 
 namespace Scumm {
 
+extern const char *nameOfResType(ResType type);
+
 void debugC(int channel, const char *s, ...) {
 	char buf[STRINGBUFLEN];
 	va_list va;
@@ -97,6 +99,7 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
 
 	registerCmd("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
+	registerCmd("resources",       WRAP_METHOD(ScummDebugger, Cmd_Resources));
 }
 
 ScummDebugger::~ScummDebugger() {
@@ -842,4 +845,29 @@ bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	return false;
 }
 
+bool ScummDebugger::Cmd_Resources(int argc, const char **argv) {
+	ResourceManager *res = _vm->_res;
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		res->resetStats();
+		debugPrintf("Resource statistics reset\n");
+		return true;
+	} else if (argc != 1) {
+		debugPrintf("Syntax: resources [reset]\n");
+		return true;
+	}
+
+	debugPrintf("Allocated: %u of %u bytes, %u resources queued for prefetching\n",
+		res->getAllocatedSize(), res->getMaxHeapThreshold(), res->getPrefetchQueueSize());
+	debugPrintf("%-12s %8s %8s %8s %8s\n", "Type", "Hits", "Misses", "Expired", "Prefetch");
+	for (int i = rtFirst; i <= rtLast; i++) {
+		const ResourceManager::TypeStats &stats = res->_stats[i];
+		if (!stats.hits && !stats.misses && !stats.evictions && !stats.prefetches)
+			continue;
+		debugPrintf("%-12s %8u %8u %8u %8u\n", nameOfResType((ResType)i),
+			stats.hits, stats.misses, stats.evictions, stats.prefetches);
+	}
+	return true;
+}
+
 } // End of namespace Scumm
@@ -68,6 +68,7 @@ private:
 	bool Cmd_IMuse(int argc, const char **argv);
 
 	bool Cmd_ResetCursors(int argc, const char **argv);
+	bool Cmd_Resources(int argc, const char **argv);
 
 	void printBox(int box);
 	void drawBox(int box);
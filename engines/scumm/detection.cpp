@@ -43,6 +43,7 @@
 #include "scumm/resource.h"
 
 #include "engines/metaengine.h"
+#include "engines/savestateindex.h"
 
 
 namespace Scumm {
@@ -1289,6 +1290,15 @@ SaveStateList ScummMetaEngine::listSaves(const char *target) const {
 		int slotNum = atoi(file->c_str() + file->size() - 2);
 
 		if (slotNum >= 0 && slotNum <= 99) {
+			// Going through the meta information fills the save index, so the
+			// savefile does not need to be opened again the next time.
+			SaveStateMetaInfos infos;
+			SaveStateMetaInfos *infoPtr = &infos;
+			if (ScummEngine::querySaveMetaInfos(target, slotNum, 0, saveDesc, nullptr, infoPtr)) {	// FIXME: heversion?!?
+				saveList.push_back(SaveStateDescriptor(slotNum, saveDesc));
+				continue;
+			}
+
 			Common::InSaveFile *in = saveFileMan->openForLoading(*file);
 			if (in) {
 				Scumm::getSavegameName(in, saveDesc, 0);	// FIXME: heversion?!?
@@ -1297,6 +1307,7 @@ SaveStateList ScummMetaEngine::listSaves(const char *target) const {
 			}
 		}
 	}
+	SaveIndex.flush();
 
 	// Sort saves based on slot number.
 	Common::sort(saveList.begin(), saveList.end(), SaveStateDescriptorSlotComparator());
@@ -1306,6 +1317,8 @@ SaveStateList ScummMetaEngine::listSaves(const char *target) const {
 void ScummMetaEngine::removeSaveState(const char *target, int slot) const {
 	Common::String filename = ScummEngine::makeSavegameName(target, slot, false);
 	g_system->getSavefileManager()->removeSavefile(filename);
+	SaveIndex.remove(target, filename);
+	SaveIndex.flush();
 }
 
 SaveStateDescriptor ScummMetaEngine::querySaveMetaInfos(const char *target, int slot) const {
@@ -1316,7 +1329,7 @@ SaveStateDescriptor ScummMetaEngine::querySaveMetaInfos(const char *target, int
 	SaveStateMetaInfos *infoPtr = &infos;
 
 	// FIXME: heversion?!?
-	if (!ScummEngine::querySaveMetaInfos(target, slot, 0, saveDesc, thumbnail, infoPtr)) {
+	if (!ScummEngine::querySaveMetaInfos(target, slot, 0, saveDesc, &thumbnail, infoPtr)) {
 		return SaveStateDescriptor();
 	}
 
@@ -23,6 +23,7 @@
 #ifdef ENABLE_HE
 
 #include "common/scummsys.h"
+#include "common/config-manager.h"
 
 #include "scumm/he/animation_he.h"
 #include "scumm/he/intern_he.h"
@@ -76,6 +77,13 @@ int MoviePlayer::load(const Common::String &filename, int flags, int image) {
 
 	_video->start();
 
+#ifdef USE_BINK
+	// Bink frames are expensive to decode, so allow decoding some of them
+	// ahead
+	if (_vm->_game.heversion >= 100 && (_vm->_game.features & GF_16BIT_COLOR))
+		_video->setFrameAhead(MAX<int>(ConfMan.getInt("video_frame_ahead"), 0));
+#endif
+
 	debug(1, "Playing video %s", filename.c_str());
 
 	if (flags & 2)
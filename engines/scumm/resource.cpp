@@ -612,7 +612,9 @@ void ScummEngine::ensureResourceLoaded(ResType type, ResId idx) {
 	if (idx <= _res->_types[type].size() && _res->_types[type][idx]._address)
 		return;
 
+	const uint32 startTime = _system->getMillis();
 	loadResource(type, idx);
+	_res->_types[type][idx]._loadTime = MIN<uint32>(_system->getMillis() - startTime, 0xFFFF);
 
 	if (_game.version == 5 && type == rtRoom && (int)idx == _roomResource)
 		VAR(VAR_ROOM_FLAG) = 1;
@@ -700,6 +702,64 @@ int ScummEngine::loadResource(ResType type, ResId idx) {
 	return 1;
 }
 
+uint32 ScummEngine::prefetchResource(ResType type, ResId idx, uint32 maxSize) {
+	// Sounds may come from other files, and the older data file formats
+	// involve too many special cases
+	if (type == rtRoom || type == rtSound || (_game.features & (GF_SMALL_HEADER | GF_OLD_BUNDLE)))
+		return 0;
+	if (idx == 0 || idx >= _res->_types[type].size() || !_fileHandle->isOpen())
+		return 0;
+
+	int roomNr = getResourceRoomNr(type, idx);
+	if (roomNr == 0)
+		roomNr = _roomResource;
+
+	const uint32 fileOffs = getResourceRoomOffset(type, idx);
+	if (fileOffs == RES_INVALID_OFFSET)
+		return 0;
+
+	// Find the room in the open file like openRoom() does, but leave the
+	// room the game is using open
+	uint32 roomOffs;
+	if (roomNr == _lastLoadedRoom)
+		roomOffs = _fileOffset;
+	else if (_game.heversion < 98 && roomNr > 0 && roomNr < _numRooms)
+		roomOffs = _res->_types[rtRoom][roomNr]._roomoffs;
+	else
+		return 0;
+	if (roomOffs == 0 || roomOffs == RES_INVALID_OFFSET)
+		return 0;
+
+	const int32 oldPos = _fileHandle->pos();
+	const uint32 offset = roomOffs + fileOffs;
+
+	_fileHandle->seek(offset, SEEK_SET);
+	const uint32 tag = _fileHandle->readUint32BE();
+	uint32 size = _fileHandle->readUint32BE();
+
+	// Newer HE games use different tags, see loadResource()
+	if (_fileHandle->err() || _fileHandle->eos() || size < 8 || offset + size > (uint32)_fileHandle->size() ||
+	        (tag != _res->_types[type]._tag && _game.heversion < 70)) {
+		debugC(DEBUG_RESOURCE, "Not prefetching invalid resource (%s,%d)", nameOfResType(type), idx);
+		size = 0;
+	} else if (size <= maxSize) {
+		const uint32 startTime = _system->getMillis();
+		_fileHandle->seek(offset, SEEK_SET);
+		_fileHandle->read(_res->createResource(type, idx, size), size);
+
+		if (_fileHandle->err() || _fileHandle->eos()) {
+			_res->nukeResource(type, idx);
+			size = 0;
+		} else {
+			_res->_types[type][idx]._loadTime = MIN<uint32>(_system->getMillis() - startTime, 0xFFFF);
+		}
+	}
+
+	_fileHandle->clearErr();
+	_fileHandle->seek(oldPos, SEEK_SET);
+	return size;
+}
+
 int ScummEngine::getResourceRoomNr(ResType type, ResId idx) {
 	if (type == rtRoom && _game.heversion < 70)
 		return idx;
@@ -736,8 +796,13 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 		return NULL;
 
 	// If the resource is missing, but loadable from the game data files, try to do so.
-	if (!_res->_types[type][idx]._address && _res->_types[type]._mode != kDynamicResTypeMode) {
-		ensureResourceLoaded(type, idx);
+	if (_res->_types[type]._mode != kDynamicResTypeMode) {
+		if (!_res->_types[type][idx]._address) {
+			_res->recordMiss(type, idx, _roomResource);
+			ensureResourceLoaded(type, idx);
+		} else {
+			_res->_stats[type].hits++;
+		}
 	}
 
 	ptr = (byte *)_res->_types[type][idx]._address;
@@ -747,6 +812,8 @@ byte *ScummEngine::getResourceAddress(ResType type, ResId idx) {
 	}
 
 	_res->setResourceCounter(type, idx, 1);
+	if (_res->_types[type][idx]._useCount < 0xFF)
+		_res->_types[type][idx]._useCount++;
 
 	debugC(DEBUG_RESOURCE, "getResourceAddress(%s,%d) == %p", nameOfResType(type), idx, (void *)ptr);
 	return ptr;
@@ -780,10 +847,12 @@ void ResourceManager::increaseResourceCounters() {
 	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 		ResId idx = _types[type].size();
 		while (idx-- > 0) {
-			byte counter = _types[type][idx].getResourceCounter();
+			Resource &res = _types[type][idx];
+			byte counter = res.getResourceCounter();
 			if (counter && counter < RF_USAGE_MAX) {
 				setResourceCounter(type, idx, counter + 1);
 			}
+			res._useCount >>= 1;
 		}
 	}
 }
@@ -844,6 +913,8 @@ ResourceManager::Resource::Resource() {
 	_status = 0;
 	_roomno = 0;
 	_roomoffs = 0;
+	_useCount = 0;
+	_loadTime = 0;
 }
 
 ResourceManager::Resource::~Resource() {
@@ -857,6 +928,8 @@ void ResourceManager::Resource::nuke() {
 	_size = 0;
 	_flags = 0;
 	_status &= ~RS_MODIFIED;
+	_useCount = 0;
+	_loadTime = 0;
 }
 
 ResourceManager::ResTypeData::ResTypeData() {
@@ -872,6 +945,9 @@ ResourceManager::ResourceManager(ScummEngine *vm) : _vm(vm) {
 	_maxHeapThreshold = 0;
 	_minHeapThreshold = 0;
 	_expireCounter = 0;
+	// Start with a pessimistic guess, prefetchNext() measures the real speed
+	_prefetchBytesPerMs = 16 * 1024;
+	resetStats();
 }
 
 ResourceManager::~ResourceManager() {
@@ -1033,7 +1109,7 @@ void ResourceManager::Resource::setOnHeap() {
 }
 
 void ResourceManager::expireResources(uint32 size) {
-	byte best_counter;
+	uint32 best_score, best_size;
 	ResType best_type;
 	int best_res = 0;
 	uint32 oldAllocatedSize;
@@ -1050,7 +1126,8 @@ void ResourceManager::expireResources(uint32 size) {
 
 	do {
 		best_type = rtInvalid;
-		best_counter = 2;
+		best_score = 0;
+		best_size = 0;
 
 		for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 			if (_types[type]._mode != kDynamicResTypeMode) {
@@ -1060,10 +1137,18 @@ void ResourceManager::expireResources(uint32 size) {
 				while (idx-- > 0) {
 					Resource &tmp = _types[type][idx];
 					byte counter = tmp.getResourceCounter();
-					if (!tmp.isLocked() && counter >= best_counter && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
-						best_counter = counter;
-						best_type = type;
-						best_res = idx;
+					if (!tmp.isLocked() && counter >= 2 && tmp._address && !_vm->isResourceInUse(type, idx) && !tmp.isOffHeap()) {
+						// Prefer resources which have not been used for a long
+						// time, were rarely used while they were loaded, and are
+						// cheap to load again. Among equals, free the largest.
+						const uint32 cost = (1 + tmp._useCount) * (1 + MIN<uint32>(tmp._loadTime, 0xFF));
+						const uint32 score = (counter << 16) / cost;
+						if (score > best_score || (score == best_score && tmp._size > best_size)) {
+							best_score = score;
+							best_size = tmp._size;
+							best_type = type;
+							best_res = idx;
+						}
 					}
 				}
 			}
@@ -1072,6 +1157,7 @@ void ResourceManager::expireResources(uint32 size) {
 		if (!best_type)
 			break;
 		nukeResource(best_type, best_res);
+		_stats[best_type].evictions++;
 	} while (size + _allocatedSize > _minHeapThreshold);
 
 	increaseResourceCounters();
@@ -1079,6 +1165,117 @@ void ResourceManager::expireResources(uint32 size) {
 	debugC(DEBUG_RESOURCE, "Expired resources, mem %d -> %d", oldAllocatedSize, _allocatedSize);
 }
 
+void ResourceManager::resetStats() {
+	memset(_stats, 0, sizeof(_stats));
+}
+
+void ResourceManager::recordMiss(ResType type, ResId idx, int room) {
+	_stats[type].misses++;
+
+	if (type != rtCostume && type != rtScript)
+		return;
+
+	Common::Array<ResourceRef> &resources = _roomResources[room];
+	if (resources.size() >= kMaxRoomResources)
+		return;
+
+	for (uint i = 0; i < resources.size(); i++) {
+		if (resources[i].type == type && resources[i].idx == idx)
+			return;
+	}
+
+	ResourceRef ref = { type, idx };
+	resources.push_back(ref);
+}
+
+void ResourceManager::prefetchRoom(int room) {
+	_prefetchQueue.clear();
+
+	// Loading resources from the older data file formats involves too many
+	// special cases to do it behind the back of the game
+	if (_vm->_game.features & (GF_SMALL_HEADER | GF_OLD_BUNDLE))
+		return;
+
+	// What the room needed during previous visits comes first
+	Common::HashMap<int, Common::Array<ResourceRef> >::const_iterator it = _roomResources.find(room);
+	if (it != _roomResources.end()) {
+		for (uint i = 0; i < it->_value.size(); i++)
+			_prefetchQueue.push_back(it->_value[i]);
+	}
+
+	static const ResType prefetchTypes[] = { rtScript, rtCostume };
+	for (int i = 0; i < ARRAYSIZE(prefetchTypes); i++) {
+		const ResType type = prefetchTypes[i];
+		for (ResId idx = 1; idx < _types[type].size(); idx++) {
+			if (_types[type][idx]._roomno == room && isPrefetchable(type, idx)) {
+				ResourceRef ref = { type, idx };
+				_prefetchQueue.push_back(ref);
+			}
+		}
+	}
+}
+
+bool ResourceManager::isPrefetchable(ResType type, ResId idx) const {
+	if (idx == 0 || idx >= _types[type].size())
+		return false;
+
+	const Resource &res = _types[type][idx];
+	if (res._address || res._roomoffs == RES_INVALID_OFFSET)
+		return false;
+
+	// Only load resources from the data file which is currently open, as
+	// opening another one may require asking the user to insert another disk
+	const int room = res._roomno;
+	if (room == 0 || room == _vm->_roomResource)
+		return true;
+	if (_vm->_game.heversion >= 98 || room < 0 || (uint)room >= _types[rtRoom].size())
+		return false;
+
+	const uint32 roomOffs = _types[rtRoom][room]._roomoffs;
+	return roomOffs != 0 && roomOffs != RES_INVALID_OFFSET;
+}
+
+bool ResourceManager::prefetchNext(uint32 deadline) {
+	Common::List<ResourceRef>::iterator it = _prefetchQueue.begin();
+	while (it != _prefetchQueue.end()) {
+		// Leave enough of the heap to the resources the game actually uses,
+		// so that prefetching does not cause them to expire
+		if (_allocatedSize >= (_minHeapThreshold + _maxHeapThreshold) / 2) {
+			_prefetchQueue.clear();
+			break;
+		}
+
+		const ResourceRef ref = *it;
+		if (!isPrefetchable(ref.type, ref.idx)) {
+			it = _prefetchQueue.erase(it);
+			continue;
+		}
+
+		// Only load what can be read in the time left, larger resources
+		// stay queued for a longer pause
+		const uint32 start = g_system->getMillis();
+		if (start >= deadline)
+			break;
+		const uint32 maxSize = (deadline - start) * _prefetchBytesPerMs;
+
+		const uint32 size = _vm->prefetchResource(ref.type, ref.idx, maxSize);
+		if (size > maxSize) {
+			++it;
+			continue;
+		}
+		_prefetchQueue.erase(it);
+		if (!size)
+			continue;
+
+		const uint32 elapsed = MAX<uint32>(g_system->getMillis() - start, 1);
+		_prefetchBytesPerMs = (_prefetchBytesPerMs * 3 + MAX<uint32>(size / elapsed, 1)) / 4;
+		_stats[ref.type].prefetches++;
+		return true;
+	}
+
+	return false;
+}
+
 void ResourceManager::freeResources() {
 	for (ResType type = rtFirst; type <= rtLast; type = ResType(type + 1)) {
 		ResId idx = _types[type].size();
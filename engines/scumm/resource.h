@@ -24,6 +24,8 @@
 #define SCUMM_RESOURCE_H
 
 #include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
 #include "scumm/scumm.h"	// for ResType
 
 namespace Scumm {
@@ -126,6 +128,19 @@ public:
 		 */
 		uint32 _roomoffs;
 
+		/**
+		 * How often the resource was looked up since it was loaded. This is
+		 * halved whenever the resource counters are increased, so resources
+		 * which are not used anymore lose their weight over time.
+		 */
+		byte _useCount;
+
+		/**
+		 * The time it took to load the resource, in milliseconds. Resources
+		 * which are expensive to reload are kept in memory for longer.
+		 */
+		uint16 _loadTime;
+
 	public:
 		Resource();
 		~Resource();
@@ -171,11 +186,38 @@ public:
 	};
 	ResTypeData _types[rtLast + 1];
 
+	/**
+	 * Lookup statistics of a resource type, shown by the "resources" debugger
+	 * command.
+	 */
+	struct TypeStats {
+		uint32 hits;       ///< Lookups of resources which were in memory
+		uint32 misses;     ///< Lookups which had to load the resource
+		uint32 evictions;  ///< Resources expired to stay below the heap threshold
+		uint32 prefetches; ///< Resources loaded ahead of time by prefetchNext()
+	};
+	TypeStats _stats[rtLast + 1];
+
 protected:
 	uint32 _allocatedSize;
 	uint32 _maxHeapThreshold, _minHeapThreshold;
 	byte _expireCounter;
 
+	enum {
+		/** Maximum number of resources remembered for a single room */
+		kMaxRoomResources = 128
+	};
+
+	struct ResourceRef {
+		ResType type;
+		ResId idx;
+	};
+
+	/** The resources which had to be loaded while in a room, by room number */
+	Common::HashMap<int, Common::Array<ResourceRef> > _roomResources;
+	Common::List<ResourceRef> _prefetchQueue;
+	uint32 _prefetchBytesPerMs; ///< Measured speed of loading resources
+
 public:
 	ResourceManager(ScummEngine *vm);
 	~ResourceManager();
@@ -224,11 +266,40 @@ public:
 	void increaseResourceCounters();
 
 	void resourceStats();
+	void resetStats();
+
+	uint32 getAllocatedSize() const { return _allocatedSize; }
+	uint32 getMaxHeapThreshold() const { return _maxHeapThreshold; }
+
+	/**
+	 * Record that a resource had to be loaded, and remember it as part of
+	 * the working set of the given room.
+	 */
+	void recordMiss(ResType type, ResId idx, int room);
+
+	/**
+	 * Queue the costumes and scripts which the given room is likely to use
+	 * for prefetching. These are the ones the room had to load during
+	 * previous visits, as well as the ones stored in the room itself.
+	 */
+	void prefetchRoom(int room);
+
+	/**
+	 * Load the next queued resource which can be loaded before the deadline,
+	 * if there is enough room on the heap. This is meant to be called while
+	 * the engine is waiting for the next frame.
+	 * @param deadline	time in milliseconds, as returned by OSystem::getMillis()
+	 * @return false if there was nothing to prefetch in time
+	 */
+	bool prefetchNext(uint32 deadline);
+
+	uint getPrefetchQueueSize() const { return _prefetchQueue.size(); }
 
 //protected:
 	bool validateResource(const char *str, ResType type, ResId idx) const;
 protected:
 	void expireResources(uint32 size);
+	bool isPrefetchable(ResType type, ResId idx) const;
 };
 
 } // End of namespace Scumm
@@ -213,6 +213,10 @@ void ScummEngine::startScene(int room, Actor *a, int objectNr) {
 		}
 	}
 
+	// Use the time while waiting for the next frames to load what the room
+	// is likely to need later on
+	_res->prefetchRoom(_roomResource);
+
 	_doEffect = true;
 
 	// Hint the backend about the virtual keyboard during copy protection screens
@@ -45,6 +45,8 @@
 
 #include "graphics/thumbnail.h"
 
+#include "engines/savestateindex.h"
+
 namespace Scumm {
 
 struct SaveGameHeader {
@@ -685,13 +687,43 @@ bool getSavegameName(Common::InSaveFile *in, Common::String &desc, int heversion
 	return true;
 }
 
-bool ScummEngine::querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Graphics::Surface *&thumbnail, SaveStateMetaInfos *&timeInfos) {
+bool ScummEngine::querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Graphics::Surface **thumbnail, SaveStateMetaInfos *&timeInfos) {
 	if (slot < 0) {
 		return false;
 	}
 
-	SaveGameHeader hdr;
 	const Common::String filename = ScummEngine::makeSavegameName(target, slot, false);
+
+	// Try the index first, it avoids parsing the savefile header. The
+	// thumbnail still needs to be loaded from the savefile, if asked for.
+	SaveStateIndex::Entry entry;
+	if (SaveIndex.lookup(target, filename, entry)) {
+		// We (deliberately) broke HE savegame compatibility at some point.
+		if (entry.version < VER(57) && heversion >= 60) {
+			return false;
+		}
+
+		desc = entry.description;
+
+		if (entry.flags & SaveStateIndex::kHasSaveDate) {
+			timeInfos->date = ((entry.saveDate & 0xFF) << 24) | (((entry.saveDate >> 8) & 0xFF) << 16) | (entry.saveDate >> 16);
+			timeInfos->time = entry.saveTime;
+			timeInfos->playtime = entry.playTime / 1000;
+		} else {
+			timeInfos = nullptr;
+		}
+
+		if (thumbnail && entry.thumbnailOffset >= 0) {
+			Common::ScopedPtr<Common::SeekableReadStream> in(g_system->getSavefileManager()->openForLoading(filename));
+			if (!in || !in->seek(entry.thumbnailOffset) || !Graphics::checkThumbnailHeader(*in) || !Graphics::loadThumbnail(*in, *thumbnail)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	SaveGameHeader hdr;
 	Common::ScopedPtr<Common::SeekableReadStream> in(g_system->getSavefileManager()->openForLoading(filename));
 
 	if (!in) {
@@ -703,10 +735,15 @@ bool ScummEngine::querySaveMetaInfos(const char *target, int slot, int heversion
 	}
 
 	desc = hdr.name;
+	entry.description = desc;
+	entry.version = hdr.ver;
 
 	if (hdr.ver > VER(52)) {
+		const int32 thumbnailOffset = in->pos();
 		if (Graphics::checkThumbnailHeader(*in)) {
-			if (!Graphics::loadThumbnail(*in, thumbnail)) {
+			entry.thumbnailOffset = thumbnailOffset;
+			const bool loaded = thumbnail ? Graphics::loadThumbnail(*in, *thumbnail) : Graphics::skipThumbnail(*in);
+			if (!loaded) {
 				return false;
 			}
 		}
@@ -715,11 +752,19 @@ bool ScummEngine::querySaveMetaInfos(const char *target, int slot, int heversion
 			if (!loadInfos(in.get(), timeInfos)) {
 				return false;
 			}
+
+			entry.flags = SaveStateIndex::kHasSaveDate | SaveStateIndex::kHasSaveTime | SaveStateIndex::kHasPlayTime;
+			entry.saveDate = ((timeInfos->date & 0xFFFF) << 16) | (((timeInfos->date >> 16) & 0xFF) << 8) | ((timeInfos->date >> 24) & 0xFF);
+			entry.saveTime = timeInfos->time;
+			entry.playTime = timeInfos->playtime * 1000;
 		} else {
 			timeInfos = nullptr;
 		}
+	} else {
+		timeInfos = nullptr;
 	}
 
+	SaveIndex.store(target, filename, entry);
 	return true;
 }
 
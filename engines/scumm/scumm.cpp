@@ -2177,7 +2177,8 @@ void ScummEngine::waitForTimer(int msec_delay) {
 		_system->updateScreen();
 		if (_system->getMillis() >= start_time + msec_delay)
 			break;
-		_system->delayMillis(10);
+		if (!_res->prefetchNext(start_time + msec_delay))
+			_system->delayMillis(10);
 	}
 }
 
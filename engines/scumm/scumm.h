@@ -635,7 +635,12 @@ public:
 
 // thumbnail + info stuff
 public:
-	static bool querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Graphics::Surface *&thumbnail, SaveStateMetaInfos *&timeInfos);
+	/**
+	 * Read the description and meta information of a savegame, going
+	 * through the save index when possible. The thumbnail is only loaded if
+	 * thumbnail is not null.
+	 */
+	static bool querySaveMetaInfos(const char *target, int slot, int heversion, Common::String &desc, Graphics::Surface **thumbnail, SaveStateMetaInfos *&timeInfos);
 
 protected:
 	void saveInfos(Common::WriteStream *file);
@@ -759,12 +764,22 @@ protected:
 	virtual uint32 getResourceRoomOffset(ResType type, ResId idx);
 	int getResourceSize(ResType type, ResId idx);
 
+	/**
+	 * Load a resource ahead of time from the data file which is currently
+	 * open, without making its room the current one. Resources which do not
+	 * look like the expected type are skipped, instead of being an error.
+	 * @param maxSize	the resource is only loaded if it is not larger
+	 * @return the size of the resource, or 0 if it cannot be loaded this way
+	 */
+	uint32 prefetchResource(ResType type, ResId idx, uint32 maxSize);
+
 public:
 	byte *getResourceAddress(ResType type, ResId idx);
 	virtual byte *getStringAddress(ResId idx);
 	byte *getStringAddressVar(int i);
 	void ensureResourceLoaded(ResType type, ResId idx);
 
+
 protected:
 	int readSoundResource(ResId idx);
 	int readSoundResourceSmallHeader(ResId idx);
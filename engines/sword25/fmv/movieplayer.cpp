@@ -29,6 +29,7 @@
  *
  */
 
+#include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -65,6 +66,9 @@ bool MoviePlayer::loadMovie(const Common::String &filename, uint z) {
 	// Get the file and load it into the decoder
 	Common::SeekableReadStream *in = Kernel::getInstance()->getPackage()->getStream(filename);
 	_decoder.loadStream(in);
+	// Package members have streams of their own, which the timer thread can
+	// read while the engine opens other files
+	_decoder.setFrameAhead(MAX<int>(ConfMan.getInt("video_frame_ahead"), 0));
 	_decoder.start();
 
 	GraphicEngine *pGfx = Kernel::getInstance()->getGfx();
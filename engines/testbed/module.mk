@@ -11,6 +11,10 @@ MODULE_OBJS := \
 	misc.o \
 	savegame.o \
 	sound.o \
+	speed.o \
+	speed_audio.o \
+	speed_common.o \
+	speed_graphics.o \
 	testbed.o \
 	testsuite.o
 
@@ -0,0 +1,48 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "testbed/speed.h"
+
+namespace Testbed {
+
+bool SpeedTests::reportSIMD(const Common::String &name, uint32 plainTime, uint32 simdTime, bool haveSIMD, bool same) {
+	Testsuite::logPrintf("Info! %s: %d ms plain, %d ms %s\n", name.c_str(),
+	                     plainTime, simdTime, haveSIMD ? "vectorized" : "plain (no vector support)");
+
+	if (!same)
+		Testsuite::logPrintf("Error! %s produced different output with vector instructions\n", name.c_str());
+	return same;
+}
+
+SpeedTestSuite::SpeedTestSuite() {
+	addTest("Blit", &SpeedTests::testBlit, false);
+	addTest("HQScalers", &SpeedTests::testHQScalers, false);
+	addTest("HashMaps", &SpeedTests::testHashMaps, false);
+	addTest("OPL", &SpeedTests::testOPL, false);
+	addTest("Strings", &SpeedTests::testStrings, false);
+	addTest("YUVToRGB", &SpeedTests::testYUVToRGB, false);
+}
+
+} // End of namespace Testbed
@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef TESTBED_SPEED_H
+#define TESTBED_SPEED_H
+
+#include "testbed/testsuite.h"
+
+namespace Testbed {
+
+namespace SpeedTests {
+
+// Benchmarks of performance critical code. Each of them also compares the
+// results of the optimized code against the plain implementation.
+
+// Helper functions for Speed tests
+/**
+ * Log the time the plain and the vectorized code took.
+ * @param same whether both produced the same output; logged as error if not
+ * @return same
+ */
+bool reportSIMD(const Common::String &name, uint32 plainTime, uint32 simdTime, bool haveSIMD, bool same);
+
+// will contain function declarations for Speed tests
+
+// Graphics, in speed_graphics.cpp
+TestExitStatus testBlit();
+TestExitStatus testHQScalers();
+TestExitStatus testYUVToRGB();
+
+// Common, in speed_common.cpp
+TestExitStatus testHashMaps();
+TestExitStatus testStrings();
+
+// Audio, in speed_audio.cpp
+TestExitStatus testOPL();
+// add more here
+
+} // End of namespace SpeedTests
+
+class SpeedTestSuite : public Testsuite {
+public:
+	/**
+	 * The constructor for the SpeedTestSuite
+	 * For every test to be executed one must:
+	 * 1) Create a function that would invoke the test
+	 * 2) Add that test to list by executing addTest()
+	 *
+	 * @see addTest()
+	 */
+	SpeedTestSuite();
+	~SpeedTestSuite() {}
+	const char *getName() const {
+		return "Speed";
+	}
+	const char *getDescription() const {
+		return "Benchmarks of scalers, converters, containers and OPL emulators";
+	}
+};
+
+} // End of namespace Testbed
+
+#endif // TESTBED_SPEED_H
@@ -0,0 +1,293 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/scummsys.h"
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "audio/fmopl.h"
+#include "audio/mixer.h"
+#include "audio/softsynth/opl/nuked.h"
+
+#include "testbed/speed.h"
+
+namespace Testbed {
+
+namespace {
+
+struct OPLWrite {
+	uint32 time; ///< milliseconds since the start
+	uint16 reg;
+	uint8 value;
+};
+
+struct OPLDump {
+	OPL::Config::OplType type;
+	uint32 length; ///< in milliseconds
+	Common::Array<OPLWrite> writes;
+};
+
+/**
+ * Load a register dump captured by DOSBox with "captureopl". Only version
+ * 2.0 of the DRO format is supported.
+ */
+bool loadDROFile(Common::SeekableReadStream &stream, OPLDump &dump) {
+	char id[8];
+	if (stream.read(id, 8) != 8 || memcmp(id, "DBRAWOPL", 8) != 0)
+		return false;
+	if (stream.readUint16LE() != 2 || stream.readUint16LE() != 0)
+		return false;
+
+	const uint32 pairs = stream.readUint32LE();
+	stream.readUint32LE(); // length in milliseconds
+	const byte hardware = stream.readByte();
+	const byte format = stream.readByte();
+	const byte compression = stream.readByte();
+	const byte shortDelayCode = stream.readByte();
+	const byte longDelayCode = stream.readByte();
+	const byte codemapLength = stream.readByte();
+	if (format != 0 || compression != 0 || codemapLength > 128)
+		return false;
+
+	byte codemap[128];
+	if (stream.read(codemap, codemapLength) != codemapLength)
+		return false;
+
+	dump.type = (hardware == 2) ? OPL::Config::kOpl3 : (hardware == 1) ? OPL::Config::kDualOpl2 : OPL::Config::kOpl2;
+	dump.writes.clear();
+
+	uint32 time = 0;
+	for (uint32 i = 0; i < pairs; ++i) {
+		const byte code = stream.readByte();
+		const byte value = stream.readByte();
+		if (stream.eos())
+			break;
+
+		if (code == shortDelayCode) {
+			time += value + 1;
+		} else if (code == longDelayCode) {
+			time += (value + 1) << 8;
+		} else if ((code & 0x7F) < codemapLength) {
+			OPLWrite write;
+			write.time = time;
+			write.reg = codemap[code & 0x7F] | ((code & 0x80) ? 0x100 : 0);
+			write.value = value;
+			dump.writes.push_back(write);
+		}
+	}
+	dump.length = time;
+
+	return dump.length && !dump.writes.empty();
+}
+
+/**
+ * Create an OPL3 dump with random instruments and notes on all channels,
+ * some of them in 4 operator and rhythm mode.
+ */
+void createOPLDump(OPLDump &dump) {
+	static const uint8 operatorRegs[] = { 0x20, 0x40, 0x60, 0x80, 0xE0 };
+	Common::XorShiftRandom rnd(0x2F6B1A3D);
+
+	dump.type = OPL::Config::kOpl3;
+	dump.length = 20000;
+	dump.writes.clear();
+
+	OPLWrite write;
+	write.time = 0;
+	for (uint32 time = 0; time < dump.length; time += 10) {
+		write.time = time;
+		if (time == 0) {
+			write.reg = 0x105;
+			write.value = 0x01;
+			dump.writes.push_back(write);
+		}
+
+		// Switch the 4 operator channels and the rhythm mode every few seconds
+		if (time % 3000 == 0) {
+			write.reg = 0x104;
+			write.value = rnd.next() & 0x3F;
+			dump.writes.push_back(write);
+			write.reg = 0xBD;
+			write.value = rnd.next() & 0xFF;
+			dump.writes.push_back(write);
+		}
+
+		for (int i = 0; i < 4; ++i) {
+			const uint16 high = (rnd.next() & 1) ? 0x100 : 0;
+			const uint channel = rnd.next() % 9;
+
+			// A new instrument now and then, otherwise a note
+			if ((rnd.next() & 7) == 0) {
+				for (int op = 0; op < 2; ++op) {
+					for (int r = 0; r < ARRAYSIZE(operatorRegs); ++r) {
+						write.reg = high | operatorRegs[r] | ((channel / 3) * 8 + channel % 3 + op * 3);
+						write.value = rnd.next() & 0xFF;
+						dump.writes.push_back(write);
+					}
+				}
+				write.reg = high | 0xC0 | channel;
+				write.value = (rnd.next() & 0x0F) | 0x30;
+				dump.writes.push_back(write);
+			}
+
+			const uint32 note = rnd.next();
+			write.reg = high | 0xA0 | channel;
+			write.value = note & 0xFF;
+			dump.writes.push_back(write);
+			write.reg = high | 0xB0 | channel;
+			write.value = (note >> 8) & 0x3F;
+			dump.writes.push_back(write);
+		}
+	}
+}
+
+/**
+ * Play a dump through an emulator.
+ * @return the time it took, in milliseconds
+ */
+uint32 renderOPLDump(OPL::EmulatedOPL *opl, const OPLDump &dump, int16 *buffer, uint32 frames, int channels) {
+	const uint32 rate = opl->getRate();
+	// readBuffer() counts the samples to the next callback, even without
+	// a callback
+	opl->setCallbackFrequency(OPL::OPL::kDefaultCallbackFrequency);
+
+	const uint32 start = g_system->getMillis();
+	uint32 frame = 0;
+	for (uint i = 0; i <= dump.writes.size(); ++i) {
+		const uint32 time = (i < dump.writes.size()) ? dump.writes[i].time : dump.length;
+		const uint32 end = MIN<uint32>((uint64)time * rate / 1000, frames);
+		if (end > frame) {
+			opl->readBuffer(buffer + frame * channels, (end - frame) * channels);
+			frame = end;
+		}
+
+		if (i < dump.writes.size())
+			opl->writeReg(dump.writes[i].reg, dump.writes[i].value);
+	}
+	return g_system->getMillis() - start;
+}
+
+} // End of anonymous namespace
+
+TestExitStatus SpeedTests::testOPL() {
+	static const char *const emulators[] = { "nuked", "db", "mame" };
+
+	// A DOSBox capture in the game directory is played instead of the
+	// built-in dump
+	OPLDump dump;
+	Common::SeekableReadStream *droFile = SearchMan.createReadStreamForMember("opl.dro");
+	if (!droFile || !loadDROFile(*droFile, dump))
+		createOPLDump(dump);
+	delete droFile;
+
+	static const char *const typeNames[] = { "OPL2", "dual OPL2", "OPL3" };
+	const uint32 rate = g_system->getMixer()->getOutputRate();
+	const uint32 frames = (uint64)dump.length * rate / 1000;
+	Testsuite::logPrintf("Info! Playing %d register writes, %d s of %s music at %d Hz\n",
+	                     dump.writes.size(), dump.length / 1000, typeNames[dump.type], rate);
+
+	// The first emulator serves as reference; Nuked is cycle accurate
+	int16 *reference = nullptr;
+	int referenceChannels = 0;
+	int16 *buffer = new int16[frames * 2];
+	bool passed = true;
+	for (int i = 0; i < ARRAYSIZE(emulators); ++i) {
+		const OPL::Config::DriverId id = OPL::Config::parse(emulators[i]);
+		const OPL::Config::EmulatorDescription *driver = OPL::Config::findDriver(id);
+		const uint32 flags = (dump.type == OPL::Config::kOpl3) ? OPL::Config::kFlagOpl3 :
+		                     (dump.type == OPL::Config::kDualOpl2) ? OPL::Config::kFlagDualOpl2 : OPL::Config::kFlagOpl2;
+		if (!driver || !(driver->flags & flags)) {
+			Testsuite::logPrintf("Info! %s is not available for %s music\n", emulators[i], typeNames[dump.type]);
+			continue;
+		}
+
+		const bool isNuked = !strcmp(emulators[i], "nuked");
+		for (int pass = 0; pass < (isNuked ? 2 : 1); ++pass) {
+#ifndef DISABLE_NUKED_OPL
+			bool haveSIMD = false;
+			if (isNuked)
+				haveSIMD = OPL::NUKED::OPL::setSIMD(pass == 1);
+#endif
+
+			// All drivers in the list are emulators
+			OPL::EmulatedOPL *opl = (OPL::EmulatedOPL *)OPL::Config::create(id, dump.type);
+			if (!opl || !opl->init()) {
+				Testsuite::logPrintf("Error! %s could not be initialized\n", driver->description);
+				delete opl;
+				passed = false;
+				break;
+			}
+
+			const int channels = opl->isStereo() ? 2 : 1;
+			const uint32 time = renderOPLDump(opl, dump, buffer, frames, channels);
+			delete opl;
+
+			Common::String name = driver->description;
+#ifndef DISABLE_NUKED_OPL
+			if (isNuked)
+				name += pass ? (haveSIMD ? " (vectorized)" : " (plain, no vector support)") : " (plain)";
+#endif
+			Testsuite::logPrintf("Info! %s: %d ms\n", name.c_str(), time);
+
+			if (!reference) {
+				reference = buffer;
+				referenceChannels = channels;
+				buffer = new int16[frames * 2];
+				continue;
+			}
+
+			// Mono output is compared against the left channel
+			const int compared = MIN(channels, referenceChannels);
+			uint32 differences = 0;
+			for (uint32 f = 0; f < frames; ++f) {
+				for (int c = 0; c < compared; ++c) {
+					if (buffer[f * channels + c] != reference[f * referenceChannels + c])
+						++differences;
+				}
+			}
+
+			if (!differences) {
+				Testsuite::logPrintf("Info! %s is bit-exact with the reference\n", name.c_str());
+			} else if (isNuked) {
+				Testsuite::logPrintf("Error! %s differs from the plain version in %d samples\n", name.c_str(), differences);
+				passed = false;
+			} else {
+				Testsuite::logPrintf("Info! %s differs from the reference in %d%% of the samples\n",
+				                     name.c_str(), (int)((uint64)differences * 100 / (frames * compared)));
+			}
+		}
+	}
+
+#ifndef DISABLE_NUKED_OPL
+	OPL::NUKED::OPL::setSIMD(true);
+#endif
+
+	delete[] reference;
+	delete[] buffer;
+
+	return passed ? kTestPassed : kTestFailed;
+}
+
+} // End of namespace Testbed
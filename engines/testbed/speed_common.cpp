@@ -0,0 +1,139 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/scummsys.h"
+#include "common/array.h"
+#include "common/flathashmap.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "testbed/speed.h"
+
+namespace Testbed {
+
+namespace {
+
+/**
+ * Fill the map with the given keys, then look each of them and a missing
+ * key up several times.
+ * @return the time it took, in milliseconds
+ */
+template<class Map>
+uint32 runHashMap(const Common::Array<Common::String> &keys, int rounds, uint32 &checksum) {
+	const uint32 start = g_system->getMillis();
+
+	Map map;
+	for (uint i = 0; i < keys.size(); ++i)
+		map[keys[i]] = i;
+
+	checksum = 0;
+	for (int round = 0; round < rounds; ++round) {
+		for (uint i = 0; i < keys.size(); ++i) {
+			checksum += map.getVal(keys[i], 0);
+			if (map.contains(keys[(i * 7) % keys.size()] + "x"))
+				checksum++;
+		}
+	}
+
+	return g_system->getMillis() - start;
+}
+
+} // End of anonymous namespace
+
+TestExitStatus SpeedTests::testHashMaps() {
+	typedef Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> NodeMap;
+	typedef Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatMap;
+	static const int sizes[] = { 16, 200, 5000 };
+	const int lookups = 2000000;
+
+	bool passed = true;
+	for (int s = 0; s < ARRAYSIZE(sizes); ++s) {
+		// Keys like the file names we usually look up
+		Common::Array<Common::String> keys;
+		Common::XorShiftRandom rnd(0x2468ACE);
+		for (int i = 0; i < sizes[s]; ++i)
+			keys.push_back(Common::String::format("resource_%u.dat", rnd.next() % 100000));
+
+		const int rounds = lookups / sizes[s];
+		uint32 nodeChecksum, flatChecksum;
+		const uint32 nodeTime = runHashMap<NodeMap>(keys, rounds, nodeChecksum);
+		const uint32 flatTime = runHashMap<FlatMap>(keys, rounds, flatChecksum);
+
+		Testsuite::logPrintf("Info! %d keys, %d lookups: %d ms HashMap, %d ms FlatHashMap\n",
+		                     sizes[s], rounds * sizes[s] * 2, nodeTime, flatTime);
+
+		if (nodeChecksum != flatChecksum) {
+			Testsuite::logPrintf("Error! HashMap and FlatHashMap returned different values\n");
+			passed = false;
+		}
+	}
+
+	return passed ? kTestPassed : kTestFailed;
+}
+
+TestExitStatus SpeedTests::testStrings() {
+	const int count = 1000;
+	const int rounds = 1000;
+
+	// Short names like script symbols and property paths, which used to
+	// need heap storage once two of them were joined
+	Common::Array<Common::String> names;
+	Common::XorShiftRandom rnd(0x51ED270B);
+	for (int i = 0; i < count; ++i)
+		names.push_back(Common::String::format("prop_%05u", rnd.next() % 100000));
+
+	uint32 start = g_system->getMillis();
+	uint32 checksum = 0;
+	for (int round = 0; round < rounds; ++round) {
+		for (int i = 0; i < count; ++i) {
+			const Common::String copy(names[i]);
+			const Common::String joined = copy + '.' + names[(i + round) % count];
+			checksum += joined.size() + joined.lastChar();
+		}
+	}
+	const uint32 concatTime = g_system->getMillis() - start;
+
+	Testsuite::logPrintf("Info! %d strings copied and joined: %d ms (checksum %08x)\n",
+	                     count * rounds, concatTime, checksum);
+
+	Common::HashMap<Common::String, uint> stringMap;
+	for (int i = 0; i < count; ++i)
+		stringMap[names[i]] = i;
+
+	start = g_system->getMillis();
+	uint32 stringChecksum = 0;
+	for (int round = 0; round < rounds; ++round) {
+		for (int i = 0; i < count; ++i)
+			stringChecksum += stringMap.getVal(names[(i * 7 + round) % count]);
+	}
+	const uint32 stringTime = g_system->getMillis() - start;
+
+	Testsuite::logPrintf("Info! %d String keys, %d lookups: %d ms (checksum %08x)\n",
+	                     stringMap.size(), count * rounds, stringTime, stringChecksum);
+
+	return kTestPassed;
+}
+
+} // End of namespace Testbed
@@ -0,0 +1,306 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "common/scummsys.h"
+#include "common/random.h"
+#include "common/system.h"
+
+#include "graphics/scaler.h"
+#include "graphics/transparent_surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "testbed/speed.h"
+
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+extern int gBitFormat;
+#endif
+
+namespace Testbed {
+
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+namespace {
+
+/**
+ * Fill a 16 bit image with flat areas, gradients and noise, so that the
+ * scalers see all kinds of neighbour patterns.
+ */
+void fillScalerInput(uint16 *pixels, int width, int height) {
+	Common::XorShiftRandom rnd(0x12345678);
+	for (int y = 0; y < height; ++y) {
+		for (int x = 0; x < width; ++x) {
+			uint16 color;
+			switch (((x / 32) + (y / 32)) % 3) {
+			case 0:
+				color = 0x7BEF;
+				break;
+			case 1:
+				color = (uint16)(((x & 31) << 11) | ((y & 63) << 5) | ((x + y) & 31));
+				break;
+			default:
+				color = (uint16)rnd.next();
+				break;
+			}
+			pixels[y * width + x] = color;
+		}
+	}
+}
+
+/**
+ * Scale the inner part of the image several times.
+ * @return the time it took, in milliseconds
+ */
+uint32 runScaler(ScalerProc *scaler, const uint16 *src, int srcWidth, int srcHeight, uint16 *dst, int scale, int iterations) {
+	// Leave a one pixel border for the neighbours of the outermost pixels
+	const uint8 *srcPtr = (const uint8 *)(src + srcWidth + 1);
+	const uint32 srcPitch = srcWidth * sizeof(uint16);
+	const int width = srcWidth - 2;
+	const int height = srcHeight - 2;
+	const uint32 dstPitch = width * scale * sizeof(uint16);
+
+	const uint32 start = g_system->getMillis();
+	for (int i = 0; i < iterations; ++i)
+		scaler(srcPtr, srcPitch, (uint8 *)dst, dstPitch, width, height);
+	return g_system->getMillis() - start;
+}
+
+} // End of anonymous namespace
+#endif
+
+TestExitStatus SpeedTests::testHQScalers() {
+#if defined(USE_SCALERS) && defined(USE_HQ_SCALERS)
+	static const struct {
+		const char *name;
+		ScalerProc *proc;
+		int scale;
+	} scalers[] = {
+		{ "HQ2x", HQ2x, 2 },
+		{ "HQ3x", HQ3x, 3 }
+	};
+	static const int sizes[][2] = { { 320, 200 }, { 640, 480 } };
+	const int iterations = 20;
+
+	// Builds the YUV table, which the backend only does if it uses the
+	// scalers itself.
+	InitScalers(gBitFormat);
+
+	bool passed = true;
+	for (int s = 0; s < ARRAYSIZE(sizes); ++s) {
+		const int srcWidth = sizes[s][0] + 2;
+		const int srcHeight = sizes[s][1] + 2;
+		uint16 *src = new uint16[srcWidth * srcHeight];
+		fillScalerInput(src, srcWidth, srcHeight);
+
+		for (int i = 0; i < ARRAYSIZE(scalers); ++i) {
+			const int dstSize = sizes[s][0] * sizes[s][1] * scalers[i].scale * scalers[i].scale;
+			uint16 *plainDst = new uint16[dstSize];
+			uint16 *simdDst = new uint16[dstSize];
+
+			setHQScalerSIMD(false);
+			const uint32 plainTime = runScaler(scalers[i].proc, src, srcWidth, srcHeight, plainDst, scalers[i].scale, iterations);
+			const bool haveSIMD = setHQScalerSIMD(true);
+			const uint32 simdTime = runScaler(scalers[i].proc, src, srcWidth, srcHeight, simdDst, scalers[i].scale, iterations);
+
+			const Common::String name = Common::String::format("%s %dx%d, %d frames", scalers[i].name, sizes[s][0], sizes[s][1], iterations);
+			if (!reportSIMD(name, plainTime, simdTime, haveSIMD, memcmp(plainDst, simdDst, dstSize * sizeof(uint16)) == 0))
+				passed = false;
+
+			delete[] plainDst;
+			delete[] simdDst;
+		}
+
+		delete[] src;
+	}
+
+	return passed ? kTestPassed : kTestFailed;
+#else
+	Testsuite::logPrintf("Info! Skipping test: HQ scalers are not built in.\n");
+	return kTestSkipped;
+#endif
+}
+
+namespace {
+
+/**
+ * Convert a frame with the given chroma subsampling.
+ */
+void convertYUV(Graphics::Surface &dst, Graphics::YUVToRGBManager::LuminanceScale scale, int subsampling,
+                const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int uvPitch) {
+	switch (subsampling) {
+	case 444:
+		YUVToRGBMan.convert444(&dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yWidth, uvPitch);
+		break;
+	case 420:
+		YUVToRGBMan.convert420(&dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yWidth, uvPitch);
+		break;
+	default:
+		YUVToRGBMan.convert410(&dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yWidth, uvPitch);
+		break;
+	}
+}
+
+} // End of anonymous namespace
+
+TestExitStatus SpeedTests::testYUVToRGB() {
+	static const int subsamplings[] = { 444, 420, 410 };
+	static const Graphics::PixelFormat formats[] = {
+		Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+		Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+	};
+	// Odd widths exercise the pixels left over by the vector code
+	static const int sizes[][2] = { { 640, 480 }, { 1276, 720 } };
+	const int iterations = 20;
+
+	bool passed = true;
+	for (int s = 0; s < ARRAYSIZE(sizes); ++s) {
+		const int yWidth = sizes[s][0];
+		const int yHeight = sizes[s][1];
+
+		// The chroma planes are big enough for any subsampling, including
+		// the extra row and column YUV410 needs.
+		const int uvPitch = yWidth + 1;
+		byte *ySrc = new byte[yWidth * yHeight];
+		byte *uSrc = new byte[uvPitch * (yHeight + 1)];
+		byte *vSrc = new byte[uvPitch * (yHeight + 1)];
+		Common::XorShiftRandom rnd(0x7F4A7C15);
+		for (int i = 0; i < yWidth * yHeight; ++i)
+			ySrc[i] = rnd.next();
+		for (int i = 0; i < uvPitch * (yHeight + 1); ++i) {
+			uSrc[i] = rnd.next();
+			vSrc[i] = rnd.next();
+		}
+
+		for (int f = 0; f < ARRAYSIZE(formats); ++f) {
+			Graphics::Surface tableDst, simdDst;
+			tableDst.create(yWidth, yHeight, formats[f]);
+			simdDst.create(yWidth, yHeight, formats[f]);
+
+			for (int i = 0; i < ARRAYSIZE(subsamplings); ++i) {
+				// YUV410 needs a width divisible by four
+				const int width = (subsamplings[i] == 410) ? (yWidth & ~3) : (yWidth & ~1);
+
+				uint32 tableTime = 0, simdTime = 0;
+				bool haveSIMD = false;
+				for (int scale = 0; scale < 2; ++scale) {
+					const Graphics::YUVToRGBManager::LuminanceScale luminanceScale = scale ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+					YUVToRGBMan.setSIMD(false);
+					uint32 start = g_system->getMillis();
+					for (int j = 0; j < iterations; ++j)
+						convertYUV(tableDst, luminanceScale, subsamplings[i], ySrc, uSrc, vSrc, width, yHeight, uvPitch);
+					tableTime += g_system->getMillis() - start;
+
+					haveSIMD = YUVToRGBMan.setSIMD(true);
+					start = g_system->getMillis();
+					for (int j = 0; j < iterations; ++j)
+						convertYUV(simdDst, luminanceScale, subsamplings[i], ySrc, uSrc, vSrc, width, yHeight, uvPitch);
+					simdTime += g_system->getMillis() - start;
+
+					if (memcmp(tableDst.getPixels(), simdDst.getPixels(), yHeight * tableDst.pitch) != 0) {
+						Testsuite::logPrintf("Error! YUV%d to %d bpp produced different output with vector instructions\n",
+						                     subsamplings[i], formats[f].bytesPerPixel * 8);
+						passed = false;
+					}
+				}
+
+				Testsuite::logPrintf("Info! YUV%d to %d bpp %dx%d, %d frames per luminance scale: %d ms with tables, %d ms %s\n",
+				                     subsamplings[i], formats[f].bytesPerPixel * 8, width, yHeight, iterations,
+				                     tableTime, simdTime, haveSIMD ? "vectorized" : "with tables (no vector support)");
+			}
+
+			tableDst.free();
+			simdDst.free();
+		}
+
+		delete[] ySrc;
+		delete[] uSrc;
+		delete[] vSrc;
+	}
+
+	return passed ? kTestPassed : kTestFailed;
+}
+
+TestExitStatus SpeedTests::testBlit() {
+	static const Graphics::TSpriteBlendMode blendModes[] = {
+		Graphics::BLEND_NORMAL, Graphics::BLEND_ADDITIVE, Graphics::BLEND_SUBTRACTIVE, Graphics::BLEND_MULTIPLY
+	};
+	static const char *const blendModeNames[] = { "Alpha", "Additive", "Subtractive", "Multiply" };
+	// The default color does not modulate; the other one takes the tinted paths
+	static const uint colors[] = { 0xFFFFFFFF, 0xC0FF8040 };
+	const int iterations = 200;
+
+	const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+
+	// An odd width exercises the pixels left over by the vector code
+	Graphics::TransparentSurface sprite;
+	sprite.create(255, 256, format);
+	Common::XorShiftRandom rnd(0x1B873593);
+	uint32 *spritePixels = (uint32 *)sprite.getPixels();
+	for (int i = 0; i < sprite.w * sprite.h; ++i)
+		spritePixels[i] = rnd.next();
+
+	Graphics::Surface background, plainDst, simdDst;
+	background.create(640, 480, format);
+	uint32 *backgroundPixels = (uint32 *)background.getPixels();
+	for (int i = 0; i < background.w * background.h; ++i)
+		backgroundPixels[i] = rnd.next();
+
+	bool passed = true;
+	for (int i = 0; i < ARRAYSIZE(blendModes); ++i) {
+		for (int c = 0; c < ARRAYSIZE(colors); ++c) {
+			// Flip every other sprite, to cover the flipped loops as well
+			plainDst.copyFrom(background);
+			Graphics::TransparentSurface::setSIMD(false);
+			uint32 start = g_system->getMillis();
+			for (int j = 0; j < iterations; ++j)
+				sprite.blit(plainDst, j % 385, j % 224, j & Graphics::FLIP_HV, nullptr, colors[c], -1, -1, blendModes[i]);
+			const uint32 plainTime = g_system->getMillis() - start;
+
+			simdDst.copyFrom(background);
+			const bool haveSIMD = Graphics::TransparentSurface::setSIMD(true);
+			start = g_system->getMillis();
+			for (int j = 0; j < iterations; ++j)
+				sprite.blit(simdDst, j % 385, j % 224, j & Graphics::FLIP_HV, nullptr, colors[c], -1, -1, blendModes[i]);
+			const uint32 simdTime = g_system->getMillis() - start;
+
+			if (memcmp(plainDst.getPixels(), simdDst.getPixels(), plainDst.h * plainDst.pitch) != 0) {
+				Testsuite::logPrintf("Error! %s blending%s produced different output with vector instructions\n",
+				                     blendModeNames[i], c ? " with color modulation" : "");
+				passed = false;
+			}
+
+			Testsuite::logPrintf("Info! %s blending%s, %d sprites of %dx%d: %d ms plain, %d ms %s\n",
+			                     blendModeNames[i], c ? " with color modulation" : "", iterations, sprite.w, sprite.h,
+			                     plainTime, simdTime, haveSIMD ? "vectorized" : "plain (no vector support)");
+
+			plainDst.free();
+			simdDst.free();
+		}
+	}
+
+	sprite.free();
+	background.free();
+
+	return passed ? kTestPassed : kTestFailed;
+}
+
+} // End of namespace Testbed
@@ -57,7 +57,6 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -75,8 +74,6 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 		delete ticket;
 	}
 
-	delete _dirtyRect;
-
 	_renderSurface->free();
 	delete _renderSurface;
 	_blankSurface->free();
@@ -140,6 +137,9 @@ bool BaseRenderOSystem::initRenderer(int width, int height, bool windowed) {
 	_blankSurface->fillRect(Common::Rect(0, 0, _blankSurface->h, _blankSurface->w), _blankSurface->format.ARGBToColor(255, 0, 0, 0));
 	_active = true;
 
+	_dirtyRects.setSize(_renderSurface->w, _renderSurface->h);
+	_ticketGrid.setSize(_renderSurface->w, _renderSurface->h);
+
 	_clearColor = _renderSurface->format.ARGBToColor(255, 0, 0, 0);
 
 	return STATUS_OK;
@@ -154,8 +154,7 @@ bool BaseRenderOSystem::indicatorFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.reset();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -194,9 +193,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		//  g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.reset();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -320,6 +317,8 @@ void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
 }
 
 void BaseRenderOSystem::invalidateTicketsFromSurface(BaseSurfaceOSystem *surf) {
+	_transformCache.invalidate(surf);
+
 	RenderQueueIterator it;
 	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
 		if ((*it)->_owner == surf) {
@@ -365,12 +364,7 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
-	}
-	_dirtyRect->clip(_renderRect);
+	_dirtyRects.addDirtyRect(rect, _renderRect);
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -389,7 +383,7 @@ void BaseRenderOSystem::drawTickets() {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRects.isEmpty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -399,43 +393,32 @@ void BaseRenderOSystem::drawTickets() {
 		return;
 	}
 
-	it = _renderQueue.begin();
 	_lastFrameIter = _renderQueue.end();
-	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
-	// the background color. Typical use-case: Fullscreen FMVs.
-	// Caveat: The FPS-counter will invalidate this.
-	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
-		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
-			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+	_drawList.resize(0);
+	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		_drawList.push_back(*it);
+		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
+		(*it)->_wantsDraw = false;
+	}
+
+	const Common::Array<Common::Rect> &dirtyRects = _dirtyRects.getOptimized();
+	if (dirtyRects.size() == 1) {
+		// Not worth building the grid for
+		_visibleTickets.resize(0);
+		for (uint i = 0; i < _drawList.size(); i++) {
+			if (_drawList[i]->_dstRect.intersects(dirtyRects[0])) {
+				_visibleTickets.push_back(i);
+			}
 		}
-		// Otherwise Do NOT fill.
+		drawDirtyRect(dirtyRects[0], _visibleTickets);
 	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
-	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
+		_ticketGrid.build(_drawList);
+		for (uint i = 0; i < dirtyRects.size(); i++) {
+			_ticketGrid.query(dirtyRects[i], _visibleTickets);
+			drawDirtyRect(dirtyRects[i], _visibleTickets);
 		}
-		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
-		ticket->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
+	_drawList.resize(0);
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
@@ -452,6 +435,46 @@ void BaseRenderOSystem::drawTickets() {
 
 }
 
+void BaseRenderOSystem::drawDirtyRect(const Common::Rect &rect, const Common::Array<uint> &tickets) {
+	// Everything below the topmost opaque ticket covering the whole rect
+	// would be overdrawn anyway. This also takes care of not filling the
+	// background for fullscreen FMVs and backgrounds.
+	uint first = 0;
+	bool covered = false;
+	for (uint i = tickets.size(); i-- > 0;) {
+		const RenderTicket *ticket = _drawList[tickets[i]];
+		if (ticket->_dstRect.contains(rect) && ticket->isOpaque()) {
+			first = i;
+			covered = true;
+			break;
+		}
+	}
+
+	if (!covered) {
+		// Apply the clear-color to the dirty rect.
+		_renderSurface->fillRect(rect, _clearColor);
+	}
+
+	for (uint i = first; i < tickets.size(); i++) {
+		RenderTicket *ticket = _drawList[tickets[i]];
+		// dstClip is the area we want redrawn.
+		Common::Rect dstClip(ticket->_dstRect);
+		// reduce it to the dirty rect
+		dstClip.clip(rect);
+		// we need to keep track of the position to redraw the dirty rect
+		Common::Rect pos(dstClip);
+		int16 offsetX = ticket->_dstRect.left;
+		int16 offsetY = ticket->_dstRect.top;
+		// convert from screen-coords to surface-coords.
+		dstClip.translate(-offsetX, -offsetY);
+
+		drawFromSurface(ticket, &pos, &dstClip);
+		_needsFlip = true;
+	}
+
+	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(rect.left, rect.top), _renderSurface->pitch, rect.left, rect.top, rect.width(), rect.height());
+}
+
 // Replacement for SDL2's SDL_RenderCopy
 void BaseRenderOSystem::drawFromSurface(RenderTicket *ticket) {
 	ticket->drawToSurface(_renderSurface);
@@ -571,6 +594,7 @@ void BaseRenderOSystem::endSaveLoad() {
 		it = _renderQueue.erase(it);
 		delete ticket;
 	}
+	_transformCache.clear();
 	// HACK: After a save the buffer will be drawn before the scripts get to update it,
 	// so just skip this single frame.
 	_skipThisFrame = true;
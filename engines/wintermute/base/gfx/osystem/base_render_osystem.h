@@ -30,6 +30,9 @@
 #define WINTERMUTE_BASE_RENDERER_SDL_H
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+#include "engines/wintermute/base/gfx/osystem/render_ticket_grid.h"
+#include "engines/wintermute/base/gfx/osystem/transform_cache.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "common/list.h"
@@ -111,6 +114,7 @@ public:
 	virtual bool endSpriteBatch() override;
 	void endSaveLoad();
 	void drawSurface(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform);
+	TransformCache *getTransformCache() { return &_transformCache; }
 	BaseSurface *createSurface() override;
 private:
 	/**
@@ -122,12 +126,23 @@ private:
 	 * Traverse the tickets that are dirty, and draw them
 	 */
 	void drawTickets();
+	/**
+	 * Redraw a single dirty rect from the given tickets, which must be
+	 * all tickets intersecting it in drawing order. Tickets hidden behind
+	 * an opaque ticket covering the whole rect are skipped.
+	 */
+	void drawDirtyRect(const Common::Rect &rect, const Common::Array<uint> &tickets);
 	// Non-dirty-rects:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	DirtyRectContainer _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
+	// Per-frame copy of _renderQueue used for drawing the dirty rects
+	Common::Array<RenderTicket *> _drawList;
+	RenderTicketGrid _ticketGrid;
+	Common::Array<uint> _visibleTickets;
+	TransformCache _transformCache;
 
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
@@ -0,0 +1,154 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+#include "common/util.h"
+
+namespace Wintermute {
+
+DirtyRectContainer::DirtyRectContainer() : _tilesW(0), _tilesH(0), _empty(true), _optimizedValid(false) {
+}
+
+void DirtyRectContainer::setSize(int width, int height) {
+	_tilesW = (width + kTileSize - 1) / kTileSize;
+	_tilesH = (height + kTileSize - 1) / kTileSize;
+	_tiles.resize(_tilesW * _tilesH);
+	reset();
+}
+
+void DirtyRectContainer::reset() {
+	if (!_tiles.empty()) {
+		memset(&_tiles[0], 0, _tiles.size() * sizeof(TileBox));
+	}
+	_empty = true;
+	_bounds = Common::Rect();
+	_optimized.clear();
+	_optimizedValid = false;
+}
+
+void DirtyRectContainer::addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect) {
+	Common::Rect r(rect);
+	r.clip(clipRect);
+	r.clip(Common::Rect(_tilesW * kTileSize, _tilesH * kTileSize));
+	if (r.isEmpty()) {
+		return;
+	}
+
+	if (_empty) {
+		_bounds = r;
+		_empty = false;
+	} else {
+		_bounds.extend(r);
+	}
+	_optimizedValid = false;
+
+	const int tileX0 = r.left / kTileSize;
+	const int tileY0 = r.top / kTileSize;
+	const int tileX1 = (r.right - 1) / kTileSize;
+	const int tileY1 = (r.bottom - 1) / kTileSize;
+
+	for (int ty = tileY0; ty <= tileY1; ty++) {
+		const int y0 = MAX<int>(r.top - ty * kTileSize, 0);
+		const int y1 = MIN<int>(r.bottom - ty * kTileSize, kTileSize);
+		for (int tx = tileX0; tx <= tileX1; tx++) {
+			int x0 = MAX<int>(r.left - tx * kTileSize, 0);
+			int x1 = MIN<int>(r.right - tx * kTileSize, kTileSize);
+
+			TileBox &box = _tiles[ty * _tilesW + tx];
+			if (box) {
+				box = makeBox(MIN(x0, boxLeft(box)), MIN(y0, boxTop(box)), MAX(x1, boxRight(box)), MAX(y1, boxBottom(box)));
+			} else {
+				box = makeBox(x0, y0, x1, y1);
+			}
+		}
+	}
+}
+
+const Common::Array<Common::Rect> &DirtyRectContainer::getOptimized() {
+	if (_optimizedValid) {
+		return _optimized;
+	}
+	_optimizedValid = true;
+	_optimized.clear();
+	if (_empty) {
+		return _optimized;
+	}
+
+	uint32 area = 0;
+	for (int ty = 0; ty < _tilesH; ty++) {
+		for (int tx = 0; tx < _tilesW; tx++) {
+			TileBox box = _tiles[ty * _tilesW + tx];
+			if (!box) {
+				continue;
+			}
+
+			Common::Rect rect;
+			rect.left = tx * kTileSize + boxLeft(box);
+			rect.top = ty * kTileSize + boxTop(box);
+			rect.bottom = ty * kTileSize + boxBottom(box);
+
+			// Join the following tiles, as long as the dirty area continues
+			// over the tile border with the same height
+			while (boxRight(box) == kTileSize && tx + 1 < _tilesW) {
+				TileBox next = _tiles[ty * _tilesW + tx + 1];
+				if (!next || boxLeft(next) != 0 || boxTop(next) != boxTop(box) || boxBottom(next) != boxBottom(box)) {
+					break;
+				}
+				box = next;
+				tx++;
+			}
+			rect.right = tx * kTileSize + boxRight(box);
+			area += rect.width() * rect.height();
+
+			// Join with a rect of the same width ending right above
+			bool merged = false;
+			for (uint i = 0; i < _optimized.size(); i++) {
+				Common::Rect &above = _optimized[i];
+				if (above.bottom == rect.top && above.left == rect.left && above.right == rect.right) {
+					above.bottom = rect.bottom;
+					merged = true;
+					break;
+				}
+			}
+			if (!merged) {
+				_optimized.push_back(rect);
+			}
+		}
+
+		if (_optimized.size() > kMaxRects) {
+			break;
+		}
+	}
+
+	// Drawing a rect has a fixed cost per ticket touching it, so give up on
+	// the details if there are too many of them, or if they cover most of
+	// their bounding rect anyway.
+	if (_optimized.size() > kMaxRects || area * 4 >= (uint32)(_bounds.width() * _bounds.height()) * 3) {
+		_optimized.clear();
+		_optimized.push_back(_bounds);
+	}
+
+	return _optimized;
+}
+
+} // End of namespace Wintermute
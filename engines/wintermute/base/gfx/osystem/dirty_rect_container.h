@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef WINTERMUTE_DIRTY_RECT_CONTAINER_H
+#define WINTERMUTE_DIRTY_RECT_CONTAINER_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Wintermute {
+
+/**
+ * Collects the dirty regions of the screen for one frame.
+ *
+ * Like sword25's MicroTileArray, the screen is divided into tiles, each of
+ * which keeps the bounding box of the dirty pixels inside it. Reading the
+ * result back merges neighbouring tiles into as few rectangles as possible,
+ * so that two small sprites moving at opposite ends of the screen no longer
+ * cause everything between them to be redrawn.
+ */
+class DirtyRectContainer {
+public:
+	DirtyRectContainer();
+
+	/**
+	 * Set the size of the screen, which also clears all dirty rects.
+	 */
+	void setSize(int width, int height);
+
+	/**
+	 * Mark a rect as dirty.
+	 * @param rect		the rect to add.
+	 * @param clipRect	the part of the screen being drawn to.
+	 */
+	void addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect);
+	void reset();
+	bool isEmpty() const { return _empty; }
+
+	/**
+	 * Get a set of disjoint rects covering all dirty pixels. Falls back to
+	 * the bounding rect of everything dirty when there are so many rects
+	 * that redrawing them one by one would cost more than it saves.
+	 */
+	const Common::Array<Common::Rect> &getOptimized();
+
+private:
+	enum {
+		kTileSize = 32,
+		/** Maximum number of rects returned by getOptimized() */
+		kMaxRects = 64
+	};
+
+	/**
+	 * Bounding box of the dirty part of a tile, packed as left, top, right
+	 * and bottom relative to the tile. Right and bottom are exclusive, so an
+	 * empty tile is the only one with a zero right edge.
+	 */
+	typedef uint32 TileBox;
+
+	static TileBox makeBox(int x0, int y0, int x1, int y1) {
+		return (x0 << 24) | (y0 << 16) | (x1 << 8) | y1;
+	}
+	static int boxLeft(TileBox box) { return box >> 24; }
+	static int boxTop(TileBox box) { return (box >> 16) & 0xFF; }
+	static int boxRight(TileBox box) { return (box >> 8) & 0xFF; }
+	static int boxBottom(TileBox box) { return box & 0xFF; }
+
+	Common::Array<TileBox> _tiles;
+	int _tilesW, _tilesH;
+
+	bool _empty;
+	/** Bounding rect of all dirty rects */
+	Common::Rect _bounds;
+
+	Common::Array<Common::Rect> _optimized;
+	bool _optimizedValid;
+};
+
+} // End of namespace Wintermute
+
+#endif
@@ -30,6 +30,7 @@
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/gfx/osystem/render_ticket.h"
 #include "engines/wintermute/base/gfx/osystem/base_surface_osystem.h"
+#include "engines/wintermute/base/gfx/osystem/base_render_osystem.h"
 #include "graphics/transform_tools.h"
 #include "common/textconsole.h"
 
@@ -43,55 +44,64 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	_wantsDraw(true),
 	_transform(transform) {
 	if (surf) {
-		_surface = new Graphics::Surface();
-		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
-		assert(_surface->format.bytesPerPixel == 4);
-		// Get a clipped copy of the surface
-		for (int i = 0; i < _surface->h; i++) {
-			memcpy(_surface->getBasePtr(0, i), surf->getBasePtr(srcRect->left, srcRect->top + i), srcRect->width() * _surface->format.bytesPerPixel);
-		}
-		// Then scale it if necessary
-		//
 		// NB: The numTimesX/numTimesY properties don't yet mix well with
 		// scaling and rotation, but there is no need for that functionality at
 		// the moment.
 		// NB: Mirroring and rotation are probably done in the wrong order.
 		// (Mirroring should most likely be done before rotation. See also
 		// TransformTools.)
-		if (_transform._angle != Graphics::kDefaultAngle) {
-			Graphics::TransparentSurface src(*_surface, false);
+		const bool rotate = _transform._angle != Graphics::kDefaultAngle;
+		const bool scale = !rotate &&
+			(dstRect->width() != srcRect->width() || dstRect->height() != srcRect->height()) &&
+			_transform._numTimesX * _transform._numTimesY == 1;
+
+		// Transformed surfaces are expensive to create, so reuse them while
+		// the sprite is drawn the same way.
+		TransformCache *cache = nullptr;
+		bool bilinear = false;
+		if (rotate || scale) {
+			bilinear = owner->_gameRef->getBilinearFiltering();
+			cache = static_cast<BaseRenderOSystem *>(owner->_gameRef->_renderer)->getTransformCache();
+			_surface = cache->get(owner, *srcRect, *dstRect, transform, bilinear);
+			if (_surface)
+				return;
+		}
+
+		Graphics::Surface *surface = new Graphics::Surface();
+		surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
+		assert(surface->format.bytesPerPixel == 4);
+		// Get a clipped copy of the surface
+		for (int i = 0; i < surface->h; i++) {
+			memcpy(surface->getBasePtr(0, i), surf->getBasePtr(srcRect->left, srcRect->top + i), srcRect->width() * surface->format.bytesPerPixel);
+		}
+		// Then scale it if necessary
+		if (rotate) {
+			Graphics::TransparentSurface src(*surface, false);
 			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
+			if (bilinear) {
 				temp = src.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
 			} else {
 				temp = src.rotoscaleT<Graphics::FILTER_NEAREST>(transform);
 			}
-			_surface->free();
-			delete _surface;
-			_surface = temp;
-		} else if ((dstRect->width() != srcRect->width() ||
-					dstRect->height() != srcRect->height()) &&
-					_transform._numTimesX * _transform._numTimesY == 1) {
-			Graphics::TransparentSurface src(*_surface, false);
+			surface->free();
+			delete surface;
+			surface = temp;
+		} else if (scale) {
+			Graphics::TransparentSurface src(*surface, false);
 			Graphics::Surface *temp;
-			if (owner->_gameRef->getBilinearFiltering()) {
+			if (bilinear) {
 				temp = src.scaleT<Graphics::FILTER_BILINEAR>(dstRect->width(), dstRect->height());
 			} else {
 				temp = src.scaleT<Graphics::FILTER_NEAREST>(dstRect->width(), dstRect->height());
 			}
-			_surface->free();
-			delete _surface;
-			_surface = temp;
+			surface->free();
+			delete surface;
+			surface = temp;
 		}
-	} else {
-		_surface = nullptr;
-	}
-}
+		_surface = SurfacePtr(surface, Graphics::SurfaceDeleter());
 
-RenderTicket::~RenderTicket() {
-	if (_surface) {
-		_surface->free();
-		delete _surface;
+		if (cache)
+			cache->put(owner, *srcRect, *dstRect, transform, bilinear, _surface);
 	}
 }
 
@@ -106,6 +116,22 @@ bool RenderTicket::operator==(const RenderTicket &t) const {
 	return true;
 }
 
+bool RenderTicket::isOpaque() const {
+	// Fade-tickets are owner-less, and always blended
+	if (!_owner || !_surface) {
+		return false;
+	}
+	if (!_transform._alphaDisable && _owner->getAlphaType() != Graphics::ALPHA_OPAQUE) {
+		return false;
+	}
+	if (_transform._rgbaMod != Graphics::kDefaultRgbaMod || _transform._blendMode != Graphics::BLEND_NORMAL) {
+		return false;
+	}
+	// Rotated and tiled tickets may leave parts of their rect untouched
+	return _transform._angle == Graphics::kDefaultAngle && _transform._numTimesX * _transform._numTimesY == 1 &&
+		_surface->w == _dstRect.width() && _surface->h == _dstRect.height();
+}
+
 // Replacement for SDL2's SDL_RenderCopy
 void RenderTicket::drawToSurface(Graphics::Surface *_targetSurface) const {
 	Graphics::TransparentSurface src(*getSurface(), false);
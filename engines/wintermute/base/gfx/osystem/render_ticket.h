@@ -29,6 +29,7 @@
 #ifndef WINTERMUTE_RENDER_TICKET_H
 #define WINTERMUTE_RENDER_TICKET_H
 
+#include "engines/wintermute/base/gfx/osystem/transform_cache.h"
 #include "graphics/transparent_surface.h"
 #include "graphics/surface.h"
 #include "common/rect.h"
@@ -53,8 +54,7 @@ class RenderTicket {
 public:
 	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform);
 	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()) {}
-	~RenderTicket();
-	const Graphics::Surface *getSurface() const { return _surface; }
+	const Graphics::Surface *getSurface() const { return _surface.get(); }
 	// Non-dirty-rects:
 	void drawToSurface(Graphics::Surface *_targetSurface) const;
 	// Dirty-rects:
@@ -69,9 +69,15 @@ public:
 
 	BaseSurfaceOSystem *_owner;
 	bool operator==(const RenderTicket &a) const;
+	/**
+	 * Check whether drawing the ticket overwrites every pixel of _dstRect,
+	 * hiding whatever was drawn there before.
+	 */
+	bool isOpaque() const;
 	const Common::Rect *getSrcRect() const { return &_srcRect; }
 private:
-	Graphics::Surface *_surface;
+	/** Shared with the TransformCache for scaled and rotated tickets */
+	SurfacePtr _surface;
 	Common::Rect _srcRect;
 };
 
@@ -0,0 +1,99 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "engines/wintermute/base/gfx/osystem/render_ticket_grid.h"
+#include "engines/wintermute/base/gfx/osystem/render_ticket.h"
+#include "common/algorithm.h"
+#include "common/util.h"
+
+namespace Wintermute {
+
+RenderTicketGrid::RenderTicketGrid() : _tickets(nullptr), _cellsW(0), _cellsH(0), _queryCount(0) {
+}
+
+void RenderTicketGrid::setSize(int width, int height) {
+	_cellsW = (width + kCellSize - 1) / kCellSize;
+	_cellsH = (height + kCellSize - 1) / kCellSize;
+	_cells.clear();
+	_cells.resize(_cellsW * _cellsH);
+	_tickets = nullptr;
+}
+
+void RenderTicketGrid::build(const Common::Array<RenderTicket *> &tickets) {
+	_tickets = &tickets;
+
+	// Keep the storage of the cells around, it is reused every frame
+	for (uint i = 0; i < _cells.size(); i++) {
+		_cells[i].resize(0);
+	}
+
+	const Common::Rect screen(_cellsW * kCellSize, _cellsH * kCellSize);
+	for (uint i = 0; i < tickets.size(); i++) {
+		Common::Rect rect(tickets[i]->_dstRect);
+		rect.clip(screen);
+		if (rect.isEmpty()) {
+			continue;
+		}
+
+		for (int cy = rect.top / kCellSize; cy <= (rect.bottom - 1) / kCellSize; cy++) {
+			for (int cx = rect.left / kCellSize; cx <= (rect.right - 1) / kCellSize; cx++) {
+				_cells[cy * _cellsW + cx].push_back(i);
+			}
+		}
+	}
+
+	_lastQuery.resize(tickets.size());
+	if (!_lastQuery.empty()) {
+		memset(&_lastQuery[0], 0, _lastQuery.size() * sizeof(uint32));
+	}
+	_queryCount = 0;
+}
+
+void RenderTicketGrid::query(const Common::Rect &rect, Common::Array<uint> &result) {
+	result.resize(0);
+
+	Common::Rect r(rect);
+	r.clip(Common::Rect(_cellsW * kCellSize, _cellsH * kCellSize));
+	if (!_tickets || r.isEmpty()) {
+		return;
+	}
+
+	// Tickets spanning several cells are listed in each of them
+	_queryCount++;
+	for (int cy = r.top / kCellSize; cy <= (r.bottom - 1) / kCellSize; cy++) {
+		for (int cx = r.left / kCellSize; cx <= (r.right - 1) / kCellSize; cx++) {
+			const Common::Array<uint> &cell = _cells[cy * _cellsW + cx];
+			for (uint i = 0; i < cell.size(); i++) {
+				const uint ticket = cell[i];
+				if (_lastQuery[ticket] != _queryCount && (*_tickets)[ticket]->_dstRect.intersects(r)) {
+					_lastQuery[ticket] = _queryCount;
+					result.push_back(ticket);
+				}
+			}
+		}
+	}
+
+	Common::sort(result.begin(), result.end());
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,78 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef WINTERMUTE_RENDER_TICKET_GRID_H
+#define WINTERMUTE_RENDER_TICKET_GRID_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Wintermute {
+
+class RenderTicket;
+
+/**
+ * A uniform grid over the screen, listing for every cell the render tickets
+ * drawing to it. Used to find the tickets touching a dirty rect without
+ * going through the whole render queue for every dirty rect.
+ */
+class RenderTicketGrid {
+public:
+	RenderTicketGrid();
+
+	/**
+	 * Set the size of the screen, which also clears the grid.
+	 */
+	void setSize(int width, int height);
+
+	/**
+	 * Index the given tickets, replacing the previous contents of the grid.
+	 * The tickets have to stay alive while the grid is queried.
+	 */
+	void build(const Common::Array<RenderTicket *> &tickets);
+
+	/**
+	 * Find the tickets intersecting a rect.
+	 * @param rect		the rect to look up.
+	 * @param result	receives the positions of the tickets in the array
+	 *					passed to build(), in ascending (i.e. drawing) order.
+	 */
+	void query(const Common::Rect &rect, Common::Array<uint> &result);
+
+private:
+	enum {
+		kCellSize = 64
+	};
+
+	const Common::Array<RenderTicket *> *_tickets;
+	Common::Array<Common::Array<uint> > _cells;
+	int _cellsW, _cellsH;
+
+	/** The number of the query which last returned each ticket */
+	Common::Array<uint32> _lastQuery;
+	uint32 _queryCount;
+};
+
+} // End of namespace Wintermute
+
+#endif
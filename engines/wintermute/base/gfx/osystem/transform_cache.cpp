@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+
+#include "engines/wintermute/base/gfx/osystem/transform_cache.h"
+
+namespace Wintermute {
+
+bool TransformCache::Entry::matches(const BaseSurfaceOSystem *owner_, const Common::Rect &srcRect_, const Common::Rect &dstRect,
+                                    const Graphics::TransformStruct &transform, bool bilinear_) const {
+	// Only the parts of the transform which affect the transformed pixels
+	// matter; flipping, color modulation and blending are done when blitting.
+	return owner == owner_ && srcRect == srcRect_ &&
+		width == dstRect.width() && height == dstRect.height() &&
+		angle == transform._angle && zoom == transform._zoom && hotspot == transform._hotspot &&
+		bilinear == bilinear_;
+}
+
+TransformCache::TransformCache() : _numEntries(0), _size(0) {
+}
+
+SurfacePtr TransformCache::get(const BaseSurfaceOSystem *owner, const Common::Rect &srcRect, const Common::Rect &dstRect,
+                               const Graphics::TransformStruct &transform, bool bilinear) {
+	for (EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		if (it->matches(owner, srcRect, dstRect, transform, bilinear)) {
+			// Move the entry to the front
+			if (it != _entries.begin()) {
+				_entries.push_front(*it);
+				_entries.erase(it);
+			}
+			return _entries.front().surface;
+		}
+	}
+
+	return SurfacePtr();
+}
+
+void TransformCache::put(const BaseSurfaceOSystem *owner, const Common::Rect &srcRect, const Common::Rect &dstRect,
+                         const Graphics::TransformStruct &transform, bool bilinear, const SurfacePtr &surface) {
+	const uint32 size = getSize(*surface);
+	if (size > kMaxSize)
+		return;
+
+	while (!_entries.empty() && (_numEntries >= kMaxEntries || _size + size > kMaxSize)) {
+		_size -= getSize(*_entries.back().surface);
+		--_numEntries;
+		_entries.pop_back();
+	}
+
+	Entry entry;
+	entry.owner = owner;
+	entry.srcRect = srcRect;
+	entry.width = dstRect.width();
+	entry.height = dstRect.height();
+	entry.angle = transform._angle;
+	entry.zoom = transform._zoom;
+	entry.hotspot = transform._hotspot;
+	entry.bilinear = bilinear;
+	entry.surface = surface;
+	_entries.push_front(entry);
+	++_numEntries;
+	_size += size;
+}
+
+void TransformCache::invalidate(const BaseSurfaceOSystem *owner) {
+	EntryList::iterator it = _entries.begin();
+	while (it != _entries.end()) {
+		if (it->owner == owner) {
+			_size -= getSize(*it->surface);
+			--_numEntries;
+			it = _entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void TransformCache::clear() {
+	_entries.clear();
+	_numEntries = 0;
+	_size = 0;
+}
+
+uint32 TransformCache::getSize(const Graphics::Surface &surface) {
+	return surface.h * surface.pitch;
+}
+
+} // End of namespace Wintermute
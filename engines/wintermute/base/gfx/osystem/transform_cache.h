@@ -0,0 +1,113 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef WINTERMUTE_TRANSFORM_CACHE_H
+#define WINTERMUTE_TRANSFORM_CACHE_H
+
+#include "common/list.h"
+#include "common/ptr.h"
+#include "common/rect.h"
+#include "graphics/surface.h"
+#include "graphics/transform_struct.h"
+
+namespace Wintermute {
+
+class BaseSurfaceOSystem;
+
+typedef Common::SharedPtr<Graphics::Surface> SurfacePtr;
+
+/**
+ * Keeps the most recently used scaled and rotated versions of surfaces, so
+ * that sprites drawn with the same zoom or angle in every frame (like
+ * zoomed actors walking around) are only transformed once.
+ *
+ * The cached surfaces are shared with the render tickets using them, and
+ * are never modified; entries made from a surface have to be dropped with
+ * invalidate() whenever its pixels change.
+ */
+class TransformCache {
+public:
+	TransformCache();
+
+	/**
+	 * Look up the transformed version of a part of a surface.
+	 * @param owner		the surface the pixels come from.
+	 * @param srcRect	the part of the surface which is transformed.
+	 * @param dstRect	the rect the result is drawn to; only its size matters.
+	 * @param transform	the transformation.
+	 * @param bilinear	whether bilinear filtering is used.
+	 * @return the transformed surface, or an empty pointer if it is not cached.
+	 */
+	SurfacePtr get(const BaseSurfaceOSystem *owner, const Common::Rect &srcRect, const Common::Rect &dstRect,
+	               const Graphics::TransformStruct &transform, bool bilinear);
+
+	/**
+	 * Add a transformed surface to the cache, evicting the least recently
+	 * used entries if necessary. Takes the same arguments as get().
+	 */
+	void put(const BaseSurfaceOSystem *owner, const Common::Rect &srcRect, const Common::Rect &dstRect,
+	         const Graphics::TransformStruct &transform, bool bilinear, const SurfacePtr &surface);
+
+	/**
+	 * Drop all entries made from the given surface.
+	 */
+	void invalidate(const BaseSurfaceOSystem *owner);
+
+	void clear();
+
+private:
+	enum {
+		/** Maximal number of cached surfaces */
+		kMaxEntries = 64,
+		/** Maximal total size of the cached pixels, in bytes */
+		kMaxSize = 8 * 1024 * 1024
+	};
+
+	struct Entry {
+		const BaseSurfaceOSystem *owner;
+		Common::Rect srcRect;
+		int16 width, height;
+		int32 angle;
+		Common::Point zoom;
+		Common::Point hotspot;
+		bool bilinear;
+		SurfacePtr surface;
+
+		bool matches(const BaseSurfaceOSystem *owner_, const Common::Rect &srcRect_, const Common::Rect &dstRect,
+		             const Graphics::TransformStruct &transform, bool bilinear_) const;
+	};
+
+	typedef Common::List<Entry> EntryList;
+
+	static uint32 getSize(const Graphics::Surface &surface);
+
+	/** The cached surfaces, the most recently used first */
+	EntryList _entries;
+	uint _numEntries;
+	/** The total size of the cached pixels, in bytes */
+	uint32 _size;
+};
+
+} // End of namespace Wintermute
+
+#endif
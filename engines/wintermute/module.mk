@@ -54,7 +54,10 @@ MODULE_OBJS := \
 	base/gfx/base_surface.o \
 	base/gfx/osystem/base_surface_osystem.o \
 	base/gfx/osystem/base_render_osystem.o \
+	base/gfx/osystem/dirty_rect_container.o \
 	base/gfx/osystem/render_ticket.o \
+	base/gfx/osystem/render_ticket_grid.o \
+	base/gfx/osystem/transform_cache.o \
 	base/particles/part_particle.o \
 	base/particles/part_emitter.o \
 	base/particles/part_force.o \
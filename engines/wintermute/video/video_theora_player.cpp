@@ -37,6 +37,7 @@
 #include "video/theora_decoder.h"
 #include "engines/wintermute/wintermute.h"
 #include "common/system.h"
+#include "common/config-manager.h"
 
 namespace Wintermute {
 
@@ -139,6 +140,10 @@ bool VideoTheoraPlayer::initialize(const Common::String &filename, const Common:
 		return STATUS_FAILED;
 	}
 
+	// Keep a few frames decoded if asked to, so expensive frames do not
+	// cause stutter
+	_theoraDecoder->setFrameAhead(MAX<int>(ConfMan.getInt("video_frame_ahead"), 0));
+
 	_state = THEORA_STATE_PAUSED;
 
 	// Additional setup.
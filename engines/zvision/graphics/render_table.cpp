@@ -22,20 +22,44 @@
 
 #include "zvision/graphics/render_table.h"
 
+#include "common/endian.h"
 #include "common/math.h"
 #include "common/rect.h"
 #include "common/scummsys.h"
 #include "graphics/colormasks.h"
 
+#if defined(SCUMM_LITTLE_ENDIAN) && defined(__SSE2__)
+#define RENDER_TABLE_SSE2
+#include <emmintrin.h>
+
+// The AVX2 versions are compiled through a function attribute and only used
+// when the CPU reports support for it at runtime.
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define RENDER_TABLE_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
 namespace ZVision {
 
 RenderTable::RenderTable(uint numColumns, uint numRows)
 	: _numRows(numRows),
 	  _numColumns(numColumns),
-	  _renderState(FLAT) {
+	  _renderState(FLAT),
+	  _warpFilter(NEAREST) {
 	assert(numRows != 0 && numColumns != 0);
 
-	_internalBuffer = new Common::Point[numRows * numColumns];
+	uint32 size = numRows * numColumns;
+	_internalBuffer = new Common::Point[size];
+	_sourceIndices = new uint32[size];
+	_sourceFractionsX = new uint8[size];
+	_sourceFractionsY = new uint8[size];
+
+	// Start with the identity mapping, like the zeroed offsets
+	for (uint32 i = 0; i < size; ++i)
+		_sourceIndices[i] = i;
+	memset(_sourceFractionsX, 0, size);
+	memset(_sourceFractionsY, 0, size);
 
 	memset(&_panoramaOptions, 0, sizeof(_panoramaOptions));
 	memset(&_tiltOptions, 0, sizeof(_tiltOptions));
@@ -43,6 +67,9 @@ RenderTable::RenderTable(uint numColumns, uint numRows)
 
 RenderTable::~RenderTable() {
 	delete[] _internalBuffer;
+	delete[] _sourceIndices;
+	delete[] _sourceFractionsX;
+	delete[] _sourceFractionsY;
 }
 
 void RenderTable::setRenderState(RenderState newState) {
@@ -66,6 +93,10 @@ void RenderTable::setRenderState(RenderState newState) {
 	}
 }
 
+void RenderTable::setWarpFilter(WarpFilter filter) {
+	_warpFilter = filter;
+}
+
 const Common::Point RenderTable::convertWarpedCoordToFlatCoord(const Common::Point &point) {
 	// If we're outside the range of the RenderTable, no warping is happening. Return the maximum image coords
 	if (point.x >= (int16)_numColumns || point.y >= (int16)_numRows || point.x < 0 || point.y < 0) {
@@ -87,17 +118,12 @@ void RenderTable::mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 d
 	uint32 destOffset = 0;
 
 	for (int16 y = subRect.top; y < subRect.bottom; ++y) {
-		uint32 sourceOffset = y * _numColumns;
+		const uint32 *sourceIndices = _sourceIndices + y * _numColumns;
 
 		for (int16 x = subRect.left; x < subRect.right; ++x) {
 			uint32 normalizedX = x - subRect.left;
-			uint32 index = sourceOffset + x;
 
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
-
-			destBuffer[destOffset + normalizedX] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
+			destBuffer[destOffset + normalizedX] = sourceBuffer[sourceIndices[x]];
 		}
 
 		destOffset += destWidth;
@@ -105,25 +131,285 @@ void RenderTable::mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 d
 }
 
 void RenderTable::mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf) {
-	uint32 destOffset = 0;
+	assert(srcBuf->w == (int16)_numColumns && srcBuf->h == (int16)_numRows);
+	assert(dstBuf->w == srcBuf->w && dstBuf->h == srcBuf->h);
+	assert(srcBuf->format.bytesPerPixel == 2);
 
-	uint16 *sourceBuffer = (uint16 *)srcBuf->getPixels();
+	const uint16 *sourceBuffer = (const uint16 *)srcBuf->getPixels();
 	uint16 *destBuffer = (uint16 *)dstBuf->getPixels();
 
-	for (int16 y = 0; y < srcBuf->h; ++y) {
-		uint32 sourceOffset = y * _numColumns;
+	if (_warpFilter == BILINEAR && _numColumns > 1 && _numRows > 1)
+		mutateImageBilinear(sourceBuffer, destBuffer, srcBuf->format);
+	else
+		mutateImageNearest(sourceBuffer, destBuffer);
+}
+
+// Whether the vector versions may be used, see RenderTable::setSIMD
+static bool s_useSIMD = true;
+
+bool RenderTable::setSIMD(bool enable) {
+	s_useSIMD = enable;
+#ifdef RENDER_TABLE_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
+
+#ifdef RENDER_TABLE_AVX2
+
+// Whether the CPU supports the AVX2 gathers. The CPU is only checked on
+// first use.
+static bool haveAVX2() {
+	static int supported = -1;
+	if (supported < 0) {
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+	}
+	return supported != 0;
+}
+
+// The gathers read the pixels as 32 bit values, together with their right
+// neighbours. The last pixel of the image is masked out of the gathers, so
+// they do not read past the end of the image, and taken from the lanes'
+// default value instead. Returns the number of pixels warped.
+
+__attribute__((target("avx2")))
+static uint32 mutateImageNearestAVX2(const uint16 *sourceBuffer, uint16 *destBuffer, const uint32 *sourceIndices, uint32 size) {
+	const __m256i last = _mm256_set1_epi32(size - 1);
+	const __m256i lastPixel = _mm256_set1_epi32(sourceBuffer[size - 1]);
+	const __m256i lowHalf = _mm256_set1_epi32(0xFFFF);
+
+	uint32 i = 0;
+	for (; i + 16 <= size; i += 16) {
+		__m256i index0 = _mm256_loadu_si256((const __m256i *)(sourceIndices + i));
+		__m256i index1 = _mm256_loadu_si256((const __m256i *)(sourceIndices + i + 8));
+
+		__m256i pixels0 = _mm256_mask_i32gather_epi32(lastPixel, (const int *)sourceBuffer, index0, _mm256_cmpgt_epi32(last, index0), 2);
+		__m256i pixels1 = _mm256_mask_i32gather_epi32(lastPixel, (const int *)sourceBuffer, index1, _mm256_cmpgt_epi32(last, index1), 2);
+
+		// The pack works within 128 bit lanes, so the halves of the result
+		// need to be put back in order
+		__m256i pixels = _mm256_packus_epi32(_mm256_and_si256(pixels0, lowHalf), _mm256_and_si256(pixels1, lowHalf));
+		_mm256_storeu_si256((__m256i *)(destBuffer + i), _mm256_permute4x64_epi64(pixels, 0xD8));
+	}
+
+	return i;
+}
+
+#endif
+
+void RenderTable::mutateImageNearest(const uint16 *sourceBuffer, uint16 *destBuffer) {
+	uint32 size = _numRows * _numColumns;
+	uint32 i = 0;
+
+#ifdef RENDER_TABLE_AVX2
+	if (s_useSIMD && haveAVX2())
+		i = mutateImageNearestAVX2(sourceBuffer, destBuffer, _sourceIndices, size);
+#endif
+
+	for (; i < size; ++i)
+		destBuffer[i] = sourceBuffer[_sourceIndices[i]];
+}
+
+// Bilinear filtering works on the three color components at once: the
+// green component is moved to the upper 16 bits, leaving enough room above
+// each component for a 5 bit weight. This holds for the 555 and 565 pixel
+// formats, where green sits between red and blue.
+
+static inline uint32 spreadComponents(uint16 color, uint32 mask) {
+	return (color | (color << 16)) & mask;
+}
+
+static inline uint16 joinComponents(uint32 color) {
+	return (uint16)(color | (color >> 16));
+}
+
+static inline uint32 lerpComponents(uint32 a, uint32 b, uint32 fraction, uint32 mask) {
+	return ((a * (32 - fraction) + b * fraction) >> 5) & mask;
+}
+
+static inline uint16 filterPixel(const uint16 *source, uint32 index, uint32 fractionX, uint32 fractionY, uint32 pitch, uint32 mask) {
+	// The right and bottom neighbours are only read when they have a weight,
+	// which keeps the reads inside the image on its last column and row
+	uint32 right = fractionX ? 1 : 0;
+	uint32 below = fractionY ? pitch : 0;
+
+	uint32 top = lerpComponents(spreadComponents(source[index], mask), spreadComponents(source[index + right], mask), fractionX, mask);
+	uint32 bottom = lerpComponents(spreadComponents(source[index + below], mask), spreadComponents(source[index + below + right], mask), fractionX, mask);
+
+	return joinComponents(lerpComponents(top, bottom, fractionY, mask));
+}
+
+#ifdef RENDER_TABLE_SSE2
+
+// Interpolate a color component of eight pixels. Gives the same results as
+// lerpComponents.
+static inline __m128i filterComponentSSE2(__m128i p00, __m128i p01, __m128i p10, __m128i p11,
+		__m128i fractionX, __m128i fractionY, __m128i shift, __m128i max) {
+	const __m128i one = _mm_set1_epi16(32);
+
+	__m128i c00 = _mm_and_si128(_mm_srl_epi16(p00, shift), max);
+	__m128i c01 = _mm_and_si128(_mm_srl_epi16(p01, shift), max);
+	__m128i c10 = _mm_and_si128(_mm_srl_epi16(p10, shift), max);
+	__m128i c11 = _mm_and_si128(_mm_srl_epi16(p11, shift), max);
+
+	__m128i inverseX = _mm_sub_epi16(one, fractionX);
+	__m128i top = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c00, inverseX), _mm_mullo_epi16(c01, fractionX)), 5);
+	__m128i bottom = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(c10, inverseX), _mm_mullo_epi16(c11, fractionX)), 5);
+
+	__m128i inverseY = _mm_sub_epi16(one, fractionY);
+	__m128i result = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(top, inverseY), _mm_mullo_epi16(bottom, fractionY)), 5);
+
+	return _mm_sll_epi16(result, shift);
+}
+
+#ifdef RENDER_TABLE_AVX2
+
+__attribute__((target("avx2")))
+static inline __m256i filterComponentAVX2(__m256i p00, __m256i p01, __m256i p10, __m256i p11,
+		__m256i fractionX, __m256i fractionY, __m128i shift, __m256i max) {
+	const __m256i one = _mm256_set1_epi16(32);
+
+	__m256i c00 = _mm256_and_si256(_mm256_srl_epi16(p00, shift), max);
+	__m256i c01 = _mm256_and_si256(_mm256_srl_epi16(p01, shift), max);
+	__m256i c10 = _mm256_and_si256(_mm256_srl_epi16(p10, shift), max);
+	__m256i c11 = _mm256_and_si256(_mm256_srl_epi16(p11, shift), max);
+
+	__m256i inverseX = _mm256_sub_epi16(one, fractionX);
+	__m256i top = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(c00, inverseX), _mm256_mullo_epi16(c01, fractionX)), 5);
+	__m256i bottom = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(c10, inverseX), _mm256_mullo_epi16(c11, fractionX)), 5);
+
+	__m256i inverseY = _mm256_sub_epi16(one, fractionY);
+	__m256i result = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(top, inverseY), _mm256_mullo_epi16(bottom, fractionY)), 5);
+
+	return _mm256_sll_epi16(result, shift);
+}
+
+// Gather eight pixels with their right neighbours, see mutateImageNearestAVX2
+__attribute__((target("avx2")))
+static inline __m256i gatherPairsAVX2(const uint16 *sourceBuffer, __m256i index, __m256i last, __m256i lastPixel) {
+	return _mm256_mask_i32gather_epi32(lastPixel, (const int *)sourceBuffer, index, _mm256_cmpgt_epi32(last, index), 2);
+}
+
+// Split the pixels and their neighbours of two gathers into sixteen pixels
+// each, in order
+__attribute__((target("avx2")))
+static inline void splitPairsAVX2(__m256i pairs0, __m256i pairs1, __m256i &pixels, __m256i &neighbours) {
+	// Sign extending keeps the 16 bit values intact through the saturating
+	// pack, which works within 128 bit lanes
+	pixels = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(pairs0, 16), 16), _mm256_srai_epi32(_mm256_slli_epi32(pairs1, 16), 16));
+	pixels = _mm256_permute4x64_epi64(pixels, 0xD8);
+	neighbours = _mm256_packs_epi32(_mm256_srai_epi32(pairs0, 16), _mm256_srai_epi32(pairs1, 16));
+	neighbours = _mm256_permute4x64_epi64(neighbours, 0xD8);
+}
 
-		for (int16 x = 0; x < srcBuf->w; ++x) {
-			uint32 index = sourceOffset + x;
+__attribute__((target("avx2")))
+static uint32 mutateImageBilinearAVX2(const uint16 *sourceBuffer, uint16 *destBuffer, const uint32 *sourceIndices,
+		const uint8 *sourceFractionsX, const uint8 *sourceFractionsY, uint32 size, uint32 pitch, const Graphics::PixelFormat &format) {
+	const __m256i last = _mm256_set1_epi32(size - 1);
+	const __m256i lastPixel = _mm256_set1_epi32(sourceBuffer[size - 1]);
+	const __m256i rowPitch = _mm256_set1_epi32(pitch);
+	const __m256i zero = _mm256_setzero_si256();
+	const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m256i rMax = _mm256_set1_epi16(format.rMax());
+	const __m256i gMax = _mm256_set1_epi16(format.gMax());
+	const __m256i bMax = _mm256_set1_epi16(format.bMax());
+
+	uint32 i = 0;
+	for (; i + 16 <= size; i += 16) {
+		__m256i fractionX = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(sourceFractionsX + i)));
+		__m256i fractionY = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(sourceFractionsY + i)));
+
+		// The row below is only read where it has a weight, which keeps the
+		// reads inside the image on its last row
+		__m256i index0 = _mm256_loadu_si256((const __m256i *)(sourceIndices + i));
+		__m256i index1 = _mm256_loadu_si256((const __m256i *)(sourceIndices + i + 8));
+		__m256i below0 = _mm256_add_epi32(index0, _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(sourceFractionsY + i))), zero), rowPitch));
+		__m256i below1 = _mm256_add_epi32(index1, _mm256_andnot_si256(_mm256_cmpeq_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(sourceFractionsY + i + 8))), zero), rowPitch));
+
+		__m256i p00, p01, p10, p11;
+		splitPairsAVX2(gatherPairsAVX2(sourceBuffer, index0, last, lastPixel), gatherPairsAVX2(sourceBuffer, index1, last, lastPixel), p00, p01);
+		splitPairsAVX2(gatherPairsAVX2(sourceBuffer, below0, last, lastPixel), gatherPairsAVX2(sourceBuffer, below1, last, lastPixel), p10, p11);
+
+		__m256i result = filterComponentAVX2(p00, p01, p10, p11, fractionX, fractionY, rShift, rMax);
+		result = _mm256_or_si256(result, filterComponentAVX2(p00, p01, p10, p11, fractionX, fractionY, gShift, gMax));
+		result = _mm256_or_si256(result, filterComponentAVX2(p00, p01, p10, p11, fractionX, fractionY, bShift, bMax));
+
+		_mm256_storeu_si256((__m256i *)(destBuffer + i), result);
+	}
 
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
+	return i;
+}
 
-			destBuffer[destOffset] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
-			destOffset++;
+#endif // RENDER_TABLE_AVX2
+
+#endif // RENDER_TABLE_SSE2
+
+void RenderTable::mutateImageBilinear(const uint16 *sourceBuffer, uint16 *destBuffer, const Graphics::PixelFormat &format) {
+	uint32 rMask = format.rMax() << format.rShift;
+	uint32 gMask = format.gMax() << format.gShift;
+	uint32 bMask = format.bMax() << format.bShift;
+	uint32 mask = rMask | bMask | (gMask << 16);
+
+	uint32 size = _numRows * _numColumns;
+	uint32 i = 0;
+
+#ifdef RENDER_TABLE_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(format.bShift);
+	const __m128i rMax = _mm_set1_epi16(format.rMax());
+	const __m128i gMax = _mm_set1_epi16(format.gMax());
+	const __m128i bMax = _mm_set1_epi16(format.bMax());
+
+#ifdef RENDER_TABLE_AVX2
+	if (s_useSIMD && haveAVX2())
+		i = mutateImageBilinearAVX2(sourceBuffer, destBuffer, _sourceIndices, _sourceFractionsX, _sourceFractionsY, size, _numColumns, format);
+#endif
+
+	for (; s_useSIMD && i + 8 <= size; i += 8) {
+		// Gather the four neighbours of eight pixels, reading each pixel
+		// together with its right neighbour. That neighbour has no weight
+		// when it is outside the image row, and is only skipped for the
+		// last pixel of the image.
+		uint32 topPairs[8], bottomPairs[8];
+		for (uint32 j = 0; j < 8; ++j) {
+			uint32 index = _sourceIndices[i + j];
+			uint32 below = index + (_sourceFractionsY[i + j] ? _numColumns : 0);
+
+			topPairs[j] = (index < size - 1) ? READ_UINT32(sourceBuffer + index) : sourceBuffer[index];
+			bottomPairs[j] = (below < size - 1) ? READ_UINT32(sourceBuffer + below) : sourceBuffer[below];
 		}
+
+		__m128i top0 = _mm_loadu_si128((const __m128i *)topPairs);
+		__m128i top1 = _mm_loadu_si128((const __m128i *)(topPairs + 4));
+		__m128i bottom0 = _mm_loadu_si128((const __m128i *)bottomPairs);
+		__m128i bottom1 = _mm_loadu_si128((const __m128i *)(bottomPairs + 4));
+
+		// Split the pairs. Sign extending keeps the 16 bit values intact
+		// through the saturating pack.
+		__m128i p00 = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(top0, 16), 16), _mm_srai_epi32(_mm_slli_epi32(top1, 16), 16));
+		__m128i p01 = _mm_packs_epi32(_mm_srai_epi32(top0, 16), _mm_srai_epi32(top1, 16));
+		__m128i p10 = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(bottom0, 16), 16), _mm_srai_epi32(_mm_slli_epi32(bottom1, 16), 16));
+		__m128i p11 = _mm_packs_epi32(_mm_srai_epi32(bottom0, 16), _mm_srai_epi32(bottom1, 16));
+
+		__m128i fractionX = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(_sourceFractionsX + i)), zero);
+		__m128i fractionY = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(_sourceFractionsY + i)), zero);
+
+		__m128i result = filterComponentSSE2(p00, p01, p10, p11, fractionX, fractionY, rShift, rMax);
+		result = _mm_or_si128(result, filterComponentSSE2(p00, p01, p10, p11, fractionX, fractionY, gShift, gMax));
+		result = _mm_or_si128(result, filterComponentSSE2(p00, p01, p10, p11, fractionX, fractionY, bShift, bMax));
+
+		_mm_storeu_si128((__m128i *)(destBuffer + i), result);
 	}
+#endif
+
+	for (; i < size; ++i)
+		destBuffer[i] = filterPixel(sourceBuffer, _sourceIndices[i], _sourceFractionsX[i], _sourceFractionsY[i], _numColumns, mask);
 }
 
 void RenderTable::generateRenderTable() {
@@ -156,20 +442,16 @@ void RenderTable::generatePanoramaLookupTable() {
 
 		// To get x in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _panoramaOptions.linearScale
-		int32 xInCylinderCoords = int32(floor((cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth));
+		float xInCylinderCoords = (cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth;
 
 		float cosAlpha = cos(alpha);
 
 		for (uint y = 0; y < _numRows; ++y) {
 			// To calculate y in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 yInCylinderCoords = int32(floor(halfHeight + ((float)y - halfHeight) * cosAlpha));
-
-			uint32 index = y * _numColumns + x;
+			float yInCylinderCoords = halfHeight + ((float)y - halfHeight) * cosAlpha;
 
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setSourcePoint(x, y, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
@@ -190,25 +472,49 @@ void RenderTable::generateTiltLookupTable() {
 
 		// To get y in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _tiltOptions.linearScale
-		int32 yInCylinderCoords = int32(floor((cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight));
+		float yInCylinderCoords = (cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight;
 
 		float cosAlpha = cos(alpha);
-		uint32 columnIndex = y * _numColumns;
 
 		for (uint x = 0; x < _numColumns; ++x) {
 			// To calculate x in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 xInCylinderCoords = int32(floor(halfWidth + ((float)x - halfWidth) * cosAlpha));
+			float xInCylinderCoords = halfWidth + ((float)x - halfWidth) * cosAlpha;
 
-			uint32 index = columnIndex + x;
-
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setSourcePoint(x, y, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
 
+void RenderTable::setSourcePoint(uint x, uint y, float sourceX, float sourceY) {
+	float flooredX = floor(sourceX);
+	float flooredY = floor(sourceY);
+	int32 pixelX = int32(flooredX);
+	int32 pixelY = int32(flooredY);
+
+	uint32 index = y * _numColumns + x;
+
+	// Only store the (x,y) offsets instead of the absolute positions
+	_internalBuffer[index].x = pixelX - x;
+	_internalBuffer[index].y = pixelY - y;
+
+	int32 clippedX = CLIP<int32>(pixelX, 0, _numColumns - 1);
+	int32 clippedY = CLIP<int32>(pixelY, 0, _numRows - 1);
+	_sourceIndices[index] = clippedY * _numColumns + clippedX;
+
+	// There is no neighbour to blend with past the last column and row
+	uint8 fractionX = 0;
+	if (clippedX == pixelX && clippedX < (int32)_numColumns - 1)
+		fractionX = MIN<int32>(int32((sourceX - flooredX) * 32.0f), 31);
+
+	uint8 fractionY = 0;
+	if (clippedY == pixelY && clippedY < (int32)_numRows - 1)
+		fractionY = MIN<int32>(int32((sourceY - flooredY) * 32.0f), 31);
+
+	_sourceFractionsX[index] = fractionX;
+	_sourceFractionsY[index] = fractionY;
+}
+
 void RenderTable::setPanoramaFoV(float fov) {
 	assert(fov > 0.0f);
 
@@ -40,10 +40,24 @@ public:
 		FLAT
 	};
 
+	enum WarpFilter {
+		NEAREST,
+		BILINEAR
+	};
+
 private:
 	uint _numColumns, _numRows;
 	Common::Point *_internalBuffer;
 	RenderState _renderState;
+	WarpFilter _warpFilter;
+
+	// Index of the source pixel of each destination pixel, so that warping
+	// an image is a plain lookup per pixel
+	uint32 *_sourceIndices;
+	// Position of the source point between the source pixel and its right
+	// and bottom neighbours, in 1/32 of a pixel. Used by bilinear filtering.
+	uint8 *_sourceFractionsX;
+	uint8 *_sourceFractionsY;
 
 	struct {
 		float fieldOfView;
@@ -66,12 +80,28 @@ public:
 	}
 	void setRenderState(RenderState newState);
 
+	WarpFilter getWarpFilter() const {
+		return _warpFilter;
+	}
+	void setWarpFilter(WarpFilter filter);
+
 	const Common::Point convertWarpedCoordToFlatCoord(const Common::Point &point);
 
 	void mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 destWidth, const Common::Rect &subRect);
+	// TODO: Warp the image in bands on several threads. This is deferred
+	// until engines can start worker threads; the timer thread is no
+	// substitute, since the warp is needed for the frame being drawn.
 	void mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf);
 	void generateRenderTable();
 
+	/**
+	 * Enable or disable the use of vector instructions for warping images.
+	 * They are enabled by default, and produce exactly the same images.
+	 *
+	 * @return whether vector instructions are available at all
+	 */
+	static bool setSIMD(bool enable);
+
 	void setPanoramaFoV(float fov);
 	void setPanoramaScale(float scale);
 	void setPanoramaReverse(bool reverse);
@@ -90,6 +120,10 @@ public:
 private:
 	void generatePanoramaLookupTable();
 	void generateTiltLookupTable();
+	void setSourcePoint(uint x, uint y, float sourceX, float sourceY);
+
+	void mutateImageNearest(const uint16 *sourceBuffer, uint16 *destBuffer);
+	void mutateImageBilinear(const uint16 *sourceBuffer, uint16 *destBuffer, const Graphics::PixelFormat &format);
 };
 
 } // End of namespace ZVision
@@ -228,6 +228,9 @@ void ZVision::initialize() {
 	_console = new Console(this);
 	_doubleFPS = ConfMan.getBool("doublefps");
 
+	if (ConfMan.getBool("smoothpanorama"))
+		_renderManager->getRenderTable()->setWarpFilter(RenderTable::BILINEAR);
+
 	// Initialize FPS timer callback
 	getTimerManager()->installTimerProc(&fpsTimerCallback, 1000000, this, "zvisionFPS");
 }
@@ -58,7 +58,8 @@ endif
 ifdef USE_HQ_SCALERS
 MODULE_OBJS += \
 	scaler/hq2x.o \
-	scaler/hq3x.o
+	scaler/hq3x.o \
+	scaler/hqpattern.o
 
 ifdef USE_NASM
 MODULE_OBJS += \
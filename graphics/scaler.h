@@ -58,6 +58,15 @@ DECLARE_SCALER(DotMatrix);
 #ifdef USE_HQ_SCALERS
 DECLARE_SCALER(HQ2x);
 DECLARE_SCALER(HQ3x);
+
+/**
+ * Allow or forbid the use of vector instructions (SSE2/AVX2) in HQ2x and
+ * HQ3x. They are allowed by default; forbidding them is mostly useful for
+ * comparing against the plain C++ code.
+ *
+ * @return whether vector instructions are available at all
+ */
+extern bool setHQScalerSIMD(bool enable);
 #endif
 
 #endif // #ifdef USE_SCALERS
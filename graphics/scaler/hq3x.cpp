@@ -135,14 +135,24 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 		w5 = *(p);
 		w8 = *(p + nextlineSrc);
 
-		int tmpWidth = width;
-		while (tmpWidth--) {
+#ifdef USE_HQ_SIMD_PATTERNS
+		uint8 patterns[kHQPatternChunk];
+#endif
+		for (int x = 0; x < width; ++x) {
+#ifdef USE_HQ_SIMD_PATTERNS
+			if ((x % kHQPatternChunk) == 0)
+				computeHQPatterns(p, nextlineSrc, MIN<int>(width - x, kHQPatternChunk), patterns);
+#endif
+
 			p++;
 
 			w3 = *(p - nextlineSrc);
 			w6 = *(p);
 			w9 = *(p + nextlineSrc);
 
+#ifdef USE_HQ_SIMD_PATTERNS
+			const int pattern = patterns[x % kHQPatternChunk];
+#else
 			int pattern = 0;
 			const int yuv5 = YUV(5);
 			if (w5 != w1 && diffYUV(yuv5, YUV(1))) pattern |= 0x0001;
@@ -153,6 +163,7 @@ static void HQ3x_implementation(const uint8 *srcPtr, uint32 srcPitch, uint8 *dst
 			if (w5 != w7 && diffYUV(yuv5, YUV(7))) pattern |= 0x0020;
 			if (w5 != w8 && diffYUV(yuv5, YUV(8))) pattern |= 0x0040;
 			if (w5 != w9 && diffYUV(yuv5, YUV(9))) pattern |= 0x0080;
+#endif
 
 			switch (pattern) {
 			case 0:
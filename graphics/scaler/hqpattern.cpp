@@ -0,0 +1,193 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/endian.h"
+
+#include "graphics/scaler.h"
+#include "graphics/scaler/intern.h"
+
+#ifdef USE_HQ_SIMD_PATTERNS
+#include <emmintrin.h>
+
+// The AVX2 version is compiled through a function attribute and only used
+// when the CPU reports support for it at runtime.
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define HQ_PATTERN_AVX2
+#include <immintrin.h>
+#endif
+
+extern "C" uint32 *RGBtoYUV;
+
+namespace {
+
+/** Whether the vectorized kernels may be used; see setHQScalerSIMD(). */
+bool s_useSIMD = true;
+
+/**
+ * Compute the patterns from the YUV values of the three lines around the
+ * pixels. Each line holds count + 2 values, starting with the left
+ * neighbour of the first pixel.
+ */
+void computePatternsScalar(const uint32 *top, const uint32 *mid, const uint32 *bot, int count, uint8 *patterns) {
+	for (int i = 0; i < count; ++i) {
+		// Equal neighbours are common and cheap to rule out
+		const uint32 yuv5 = mid[i + 1];
+		int pattern = 0;
+		if (yuv5 != top[i    ] && diffYUV(yuv5, top[i    ])) pattern |= 0x0001;
+		if (yuv5 != top[i + 1] && diffYUV(yuv5, top[i + 1])) pattern |= 0x0002;
+		if (yuv5 != top[i + 2] && diffYUV(yuv5, top[i + 2])) pattern |= 0x0004;
+		if (yuv5 != mid[i    ] && diffYUV(yuv5, mid[i    ])) pattern |= 0x0008;
+		if (yuv5 != mid[i + 2] && diffYUV(yuv5, mid[i + 2])) pattern |= 0x0010;
+		if (yuv5 != bot[i    ] && diffYUV(yuv5, bot[i    ])) pattern |= 0x0020;
+		if (yuv5 != bot[i + 1] && diffYUV(yuv5, bot[i + 1])) pattern |= 0x0040;
+		if (yuv5 != bot[i + 2] && diffYUV(yuv5, bot[i + 2])) pattern |= 0x0080;
+		patterns[i] = pattern;
+	}
+}
+
+/**
+ * Vectorized diffYUV: the result lanes are all ones where the YUV values
+ * differ by more than the thresholds. The thresholds are applied per byte
+ * on the absolute differences of the (unsigned) components, which is
+ * equivalent to the masked arithmetic in diffYUV.
+ */
+static inline __m128i diffYUV_SSE2(__m128i yuv5, const uint32 *other, __m128i thresholds, __m128i bit) {
+	const __m128i yuv = _mm_loadu_si128((const __m128i *)other);
+	const __m128i absDiff = _mm_or_si128(_mm_subs_epu8(yuv5, yuv), _mm_subs_epu8(yuv, yuv5));
+	const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(absDiff, thresholds), _mm_setzero_si128());
+	return _mm_andnot_si128(same, bit);
+}
+
+void computePatternsSSE2(const uint32 *top, const uint32 *mid, const uint32 *bot, int count, uint8 *patterns) {
+	// Thresholds for V, U and Y; the unused top byte never differs
+	const __m128i thresholds = _mm_set1_epi32(0xFF300706);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128i yuv5 = _mm_loadu_si128((const __m128i *)(mid + i + 1));
+
+		__m128i pattern = diffYUV_SSE2(yuv5, top + i, thresholds, _mm_set1_epi32(0x01));
+		pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv5, top + i + 1, thresholds, _mm_set1_epi32(0x02)));
+		pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv5, top + i + 2, thresholds, _mm_set1_epi32(0x04)));
+		pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv5, mid + i,     thresholds, _mm_set1_epi32(0x08)));
+		pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv5, mid + i + 2, thresholds, _mm_set1_epi32(0x10)));
+		pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv5, bot + i,     thresholds, _mm_set1_epi32(0x20)));
+		pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv5, bot + i + 1, thresholds, _mm_set1_epi32(0x40)));
+		pattern = _mm_or_si128(pattern, diffYUV_SSE2(yuv5, bot + i + 2, thresholds, _mm_set1_epi32(0x80)));
+
+		pattern = _mm_packs_epi32(pattern, pattern);
+		pattern = _mm_packus_epi16(pattern, pattern);
+		WRITE_UINT32(patterns + i, _mm_cvtsi128_si32(pattern));
+	}
+
+	computePatternsScalar(top + i, mid + i, bot + i, count - i, patterns + i);
+}
+
+#ifdef HQ_PATTERN_AVX2
+
+__attribute__((target("avx2")))
+static inline __m256i diffYUV_AVX2(__m256i yuv5, const uint32 *other, __m256i thresholds, __m256i bit) {
+	const __m256i yuv = _mm256_loadu_si256((const __m256i *)other);
+	const __m256i absDiff = _mm256_or_si256(_mm256_subs_epu8(yuv5, yuv), _mm256_subs_epu8(yuv, yuv5));
+	const __m256i same = _mm256_cmpeq_epi32(_mm256_subs_epu8(absDiff, thresholds), _mm256_setzero_si256());
+	return _mm256_andnot_si256(same, bit);
+}
+
+__attribute__((target("avx2")))
+void computePatternsAVX2(const uint32 *top, const uint32 *mid, const uint32 *bot, int count, uint8 *patterns) {
+	const __m256i thresholds = _mm256_set1_epi32(0xFF300706);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i yuv5 = _mm256_loadu_si256((const __m256i *)(mid + i + 1));
+
+		__m256i pattern = diffYUV_AVX2(yuv5, top + i, thresholds, _mm256_set1_epi32(0x01));
+		pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv5, top + i + 1, thresholds, _mm256_set1_epi32(0x02)));
+		pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv5, top + i + 2, thresholds, _mm256_set1_epi32(0x04)));
+		pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv5, mid + i,     thresholds, _mm256_set1_epi32(0x08)));
+		pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv5, mid + i + 2, thresholds, _mm256_set1_epi32(0x10)));
+		pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv5, bot + i,     thresholds, _mm256_set1_epi32(0x20)));
+		pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv5, bot + i + 1, thresholds, _mm256_set1_epi32(0x40)));
+		pattern = _mm256_or_si256(pattern, diffYUV_AVX2(yuv5, bot + i + 2, thresholds, _mm256_set1_epi32(0x80)));
+
+		__m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(pattern), _mm256_extracti128_si256(pattern, 1));
+		packed = _mm_packus_epi16(packed, packed);
+		_mm_storel_epi64((__m128i *)(patterns + i), packed);
+	}
+
+	computePatternsSSE2(top + i, mid + i, bot + i, count - i, patterns + i);
+}
+
+#endif // HQ_PATTERN_AVX2
+
+typedef void (*PatternProc)(const uint32 *top, const uint32 *mid, const uint32 *bot, int count, uint8 *patterns);
+
+/**
+ * The best vectorized kernel the CPU supports. The CPU is only checked on
+ * first use, and the result is the same for every caller.
+ */
+PatternProc getSIMDPatternProc() {
+	static PatternProc proc = nullptr;
+	if (!proc) {
+#ifdef HQ_PATTERN_AVX2
+		__builtin_cpu_init();
+		proc = __builtin_cpu_supports("avx2") ? computePatternsAVX2 : computePatternsSSE2;
+#else
+		proc = computePatternsSSE2;
+#endif
+	}
+	return proc;
+}
+
+} // End of anonymous namespace
+
+void computeHQPatterns(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns) {
+	assert(width <= kHQPatternChunk);
+
+	// Look up the YUV values of the three lines around the pixels once,
+	// instead of nine times per pixel.
+	uint32 top[kHQPatternChunk + 2], mid[kHQPatternChunk + 2], bot[kHQPatternChunk + 2];
+	const uint16 *src = p - 1;
+	for (int i = 0; i < width + 2; ++i, ++src) {
+		top[i] = RGBtoYUV[*(src - nextlineSrc)];
+		mid[i] = RGBtoYUV[*src];
+		bot[i] = RGBtoYUV[*(src + nextlineSrc)];
+	}
+
+	if (s_useSIMD)
+		getSIMDPatternProc()(top, mid, bot, width, patterns);
+	else
+		computePatternsScalar(top, mid, bot, width, patterns);
+}
+
+bool setHQScalerSIMD(bool enable) {
+	s_useSIMD = enable;
+	return true;
+}
+
+#else
+
+bool setHQScalerSIMD(bool enable) {
+	return false;
+}
+
+#endif // USE_HQ_SIMD_PATTERNS
@@ -24,6 +24,7 @@
 #define GRAPHICS_SCALER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/util.h"
 #include "graphics/colormasks.h"
 
 
@@ -218,4 +219,31 @@ static inline bool diffYUV(int yuv1, int yuv2) {
 */
 }
 
+// The C++ versions of the hq scalers compute the neighbour patterns with
+// vector instructions where those are available at compile time.
+#if defined(USE_HQ_SCALERS) && !defined(USE_NASM) && defined(__SSE2__)
+#define USE_HQ_SIMD_PATTERNS
+
+enum {
+	/** Maximal number of pixels computeHQPatterns() handles at once */
+	kHQPatternChunk = 256
+};
+
+/**
+ * Compute the neighbour patterns used by the hq scaler family for a run of
+ * pixels on one line: bit n of a pattern is set when the YUV value of the
+ * pixel differs (see diffYUV) from its neighbour n, counting row by row
+ * from the top left and skipping the pixel itself.
+ *
+ * The vector instructions can be disabled with setHQScalerSIMD().
+ *
+ * @param p           the first pixel
+ * @param nextlineSrc distance between two lines, in pixels
+ * @param width       number of pixels, at most kHQPatternChunk
+ * @param patterns    receives one pattern per pixel
+ */
+void computeHQPatterns(const uint16 *p, uint32 nextlineSrc, int width, uint8 *patterns);
+
+#endif
+
 #endif
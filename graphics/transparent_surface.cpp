@@ -64,6 +64,280 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color);
 
+// The vectorized blenders depend on the channel order of little endian
+// systems, where the alpha value is the first byte of a pixel. On 32 bit x86
+// builds without SSE2 they are compiled through a function attribute, and
+// only used when the CPU supports SSE2.
+#if defined(SCUMM_LITTLE_ENDIAN) && defined(__SSE2__)
+#define TRANSPARENT_SURFACE_SSE2
+#define TRANSPARENT_SURFACE_SSE2_TARGET
+#include <emmintrin.h>
+#elif defined(SCUMM_LITTLE_ENDIAN) && defined(__i386__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define TRANSPARENT_SURFACE_SSE2
+#define TRANSPARENT_SURFACE_SSE2_TARGET __attribute__((target("sse2")))
+#define TRANSPARENT_SURFACE_SSE2_RUNTIME_CHECK
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+/** Whether the vectorized blenders may be used; see TransparentSurface::setSIMD(). */
+bool s_useSIMD = true;
+
+#ifdef TRANSPARENT_SURFACE_SSE2
+
+/**
+ * Whether the CPU supports the vectorized blenders. The CPU is only checked
+ * on first use.
+ */
+bool haveSSE2() {
+#ifdef TRANSPARENT_SURFACE_SSE2_RUNTIME_CHECK
+	static int supported = -1;
+	if (supported < 0) {
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("sse2") ? 1 : 0;
+	}
+	return supported != 0;
+#else
+	return true;
+#endif
+}
+
+// The blenders work on two pixels at once, with every channel widened to 16
+// bits, so the alpha values are in lanes 0 and 4. They compute exactly the
+// same values as the scalar loops, including all of their truncations.
+
+TRANSPARENT_SURFACE_SSE2_TARGET static inline __m128i broadcastAlpha(__m128i pixels) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0), 0);
+}
+
+/** Take the color channels from color and the alpha channel from alpha */
+TRANSPARENT_SURFACE_SSE2_TARGET static inline __m128i mergeAlpha(__m128i color, __m128i alpha) {
+	const __m128i colorMask = _mm_set_epi16(-1, -1, -1, 0, -1, -1, -1, 0);
+	return _mm_or_si128(_mm_and_si128(colorMask, color), _mm_andnot_si128(colorMask, alpha));
+}
+
+/** Take the lanes from a where mask is set, and from b elsewhere */
+TRANSPARENT_SURFACE_SSE2_TARGET static inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/** The color modulation of the tinted blenders */
+struct TintSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET explicit TintSSE2(uint32 color) {
+		const int16 ca = (color >> kAModShift) & 0xFF;
+		const int16 cr = (color >> kRModShift) & 0xFF;
+		const int16 cg = (color >> kGModShift) & 0xFF;
+		const int16 cb = (color >> kBModShift) & 0xFF;
+		alpha = _mm_set1_epi16(ca);
+		channels = _mm_set_epi16(cr, cg, cb, 0, cr, cg, cb, 0);
+		full = _mm_cmpeq_epi16(channels, _mm_set1_epi16(255));
+	}
+
+	/** Modulated alpha of the input pixels */
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i inputAlpha(__m128i in) const {
+		return _mm_srli_epi16(_mm_mullo_epi16(broadcastAlpha(in), alpha), 8);
+	}
+
+	/**
+	 * Modulated input colors, as used by the additive and multiplicative
+	 * blenders: unmodulated channels are not multiplied at all.
+	 */
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i inputColor(__m128i in, __m128i ina) const {
+		const __m128i product = _mm_mullo_epi16(in, ina);
+		return select(full, _mm_srli_epi16(product, 8), _mm_mulhi_epu16(product, channels));
+	}
+
+	__m128i alpha;
+	__m128i channels;
+	/** Lanes of the channels which are not modulated */
+	__m128i full;
+};
+
+struct AlphaBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i a = broadcastAlpha(in);
+		const __m128i color = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(in, a), _mm_mullo_epi16(out, _mm_sub_epi16(_mm_set1_epi16(255), a))), 8);
+		// Fully transparent pixels are left alone
+		return select(_mm_cmpeq_epi16(a, _mm_setzero_si128()), out, mergeAlpha(color, _mm_set1_epi16(255)));
+	}
+};
+
+struct TintedAlphaBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET explicit TintedAlphaBlendSSE2(uint32 color) : tint(color) {}
+
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i ina = tint.inputAlpha(in);
+		const __m128i dst = _mm_srli_epi16(_mm_mullo_epi16(out, _mm_sub_epi16(_mm_set1_epi16(255), ina)), 8);
+		const __m128i src = _mm_mulhi_epu16(_mm_mullo_epi16(in, ina), tint.channels);
+		// The sum is stored in a byte without clamping
+		return mergeAlpha(_mm_and_si128(_mm_add_epi16(dst, src), _mm_set1_epi16(0xFF)), _mm_set1_epi16(255));
+	}
+
+	TintSSE2 tint;
+};
+
+struct AdditiveBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i src = _mm_srli_epi16(_mm_mullo_epi16(in, broadcastAlpha(in)), 8);
+		return mergeAlpha(_mm_min_epi16(_mm_add_epi16(src, out), _mm_set1_epi16(255)), out);
+	}
+};
+
+struct TintedAdditiveBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET explicit TintedAdditiveBlendSSE2(uint32 color) : tint(color) {}
+
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i src = tint.inputColor(in, tint.inputAlpha(in));
+		return mergeAlpha(_mm_min_epi16(_mm_add_epi16(src, out), _mm_set1_epi16(255)), out);
+	}
+
+	TintSSE2 tint;
+};
+
+struct SubtractiveBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i src = _mm_mulhi_epu16(_mm_mullo_epi16(in, out), broadcastAlpha(in));
+		return mergeAlpha(_mm_sub_epi16(out, src), out);
+	}
+};
+
+struct TintedSubtractiveBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET explicit TintedSubtractiveBlendSSE2(uint32 color) : tint(color) {}
+
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i a = broadcastAlpha(in);
+		const __m128i product = _mm_mullo_epi16(in, out);
+		const __m128i unmodulated = _mm_sub_epi16(out, _mm_mulhi_epu16(product, a));
+		// The scalar code computes in * c * out * a in an int, which wraps
+		// around for bright pixels. Storing the difference in a byte drops
+		// the wrapped bits again, so it is the difference modulo 256.
+		const __m128i src = _mm_srli_epi16(_mm_mulhi_epu16(product, _mm_mullo_epi16(tint.channels, a)), 8);
+		const __m128i modulated = _mm_and_si128(_mm_sub_epi16(out, src), _mm_set1_epi16(0xFF));
+		return mergeAlpha(select(tint.full, unmodulated, modulated), _mm_set1_epi16(255));
+	}
+
+	TintSSE2 tint;
+};
+
+struct MultiplyBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i a = broadcastAlpha(in);
+		const __m128i src = _mm_srli_epi16(_mm_mullo_epi16(in, a), 8);
+		const __m128i color = _mm_srli_epi16(_mm_mullo_epi16(src, out), 8);
+		return select(_mm_cmpeq_epi16(a, _mm_setzero_si128()), out, mergeAlpha(color, out));
+	}
+};
+
+struct TintedMultiplyBlendSSE2 {
+	TRANSPARENT_SURFACE_SSE2_TARGET explicit TintedMultiplyBlendSSE2(uint32 color) : tint(color) {}
+
+	TRANSPARENT_SURFACE_SSE2_TARGET __m128i operator()(__m128i in, __m128i out) const {
+		const __m128i src = tint.inputColor(in, tint.inputAlpha(in));
+		return mergeAlpha(_mm_srli_epi16(_mm_mullo_epi16(src, out), 8), out);
+	}
+
+	TintSSE2 tint;
+};
+
+/** Blend four pixels, given in their original byte layout */
+template<class Blender>
+TRANSPARENT_SURFACE_SSE2_TARGET static inline __m128i blendPixelsSSE2(const Blender &blender, __m128i in, __m128i out) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = blender(_mm_unpacklo_epi8(in, zero), _mm_unpacklo_epi8(out, zero));
+	const __m128i hi = blender(_mm_unpackhi_epi8(in, zero), _mm_unpackhi_epi8(out, zero));
+	return _mm_packus_epi16(lo, hi);
+}
+
+/**
+ * Vectorized counterpart of the doBlit functions, using the same arguments.
+ * inStep may only be 4 or -4.
+ */
+template<class Blender>
+TRANSPARENT_SURFACE_SSE2_TARGET void doBlitSSE2(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, const Blender &blender) {
+	for (uint32 i = 0; i < height; i++) {
+		byte *in = ino;
+		byte *out = outo;
+
+		uint32 j = 0;
+		if (inStep > 0) {
+			for (; j + 4 <= width; j += 4) {
+				const __m128i inPixels = _mm_loadu_si128((const __m128i *)in);
+				_mm_storeu_si128((__m128i *)out, blendPixelsSSE2(blender, inPixels, _mm_loadu_si128((const __m128i *)out)));
+				in += 16;
+				out += 16;
+			}
+		} else {
+			// Horizontally flipped: load the pixels in memory order and
+			// reverse them.
+			for (; j + 4 <= width; j += 4) {
+				const __m128i inPixels = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(in - 12)), _MM_SHUFFLE(0, 1, 2, 3));
+				_mm_storeu_si128((__m128i *)out, blendPixelsSSE2(blender, inPixels, _mm_loadu_si128((const __m128i *)out)));
+				in -= 16;
+				out += 16;
+			}
+		}
+
+		if (j < width) {
+			// Blend the remaining pixels through buffers
+			const uint32 count = width - j;
+			uint32 inBuf[4] = { 0, 0, 0, 0 };
+			uint32 outBuf[4] = { 0, 0, 0, 0 };
+			for (uint32 k = 0; k < count; k++) {
+				inBuf[k] = READ_UINT32(in);
+				in += inStep;
+			}
+			memcpy(outBuf, out, count * 4);
+			_mm_storeu_si128((__m128i *)outBuf, blendPixelsSSE2(blender, _mm_loadu_si128((const __m128i *)inBuf), _mm_loadu_si128((const __m128i *)outBuf)));
+			memcpy(out, outBuf, count * 4);
+		}
+
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+/**
+ * Interpolate between the channels of a and b, with weight being a 16 bit
+ * fraction. This matches the scalar (((b - a) * weight) >> 16) + a.
+ */
+TRANSPARENT_SURFACE_SSE2_TARGET static inline __m128i lerpSSE2(__m128i a, __m128i b, int weight) {
+	const __m128i diff = _mm_sub_epi16(b, a);
+	// The multiplication is signed, so large weights are negative and the
+	// result is too small by exactly diff.
+	__m128i offset = _mm_mulhi_epi16(diff, _mm_set1_epi16((int16)weight));
+	if (weight & 0x8000)
+		offset = _mm_add_epi16(offset, diff);
+	return _mm_add_epi16(a, offset);
+}
+
+/**
+ * Bilinear interpolation of a pixel from its four neighbours, interpolating
+ * both rows at once.
+ */
+TRANSPARENT_SURFACE_SSE2_TARGET static inline uint32 interpolateSSE2(uint32 c00, uint32 c01, uint32 c10, uint32 c11, int ex, int ey) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i byteMask = _mm_set1_epi16(0xFF);
+	const __m128i left = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(c00), _mm_cvtsi32_si128(c10)), zero);
+	const __m128i right = _mm_unpacklo_epi8(_mm_unpacklo_epi32(_mm_cvtsi32_si128(c01), _mm_cvtsi32_si128(c11)), zero);
+	const __m128i rows = _mm_and_si128(lerpSSE2(left, right, ex), byteMask);
+	const __m128i result = _mm_and_si128(lerpSSE2(rows, _mm_unpackhi_epi64(rows, rows), ey), byteMask);
+	return _mm_cvtsi128_si32(_mm_packus_epi16(result, zero));
+}
+
+#endif // TRANSPARENT_SURFACE_SSE2
+
+} // End of anonymous namespace
+
+bool TransparentSurface::setSIMD(bool enable) {
+	s_useSIMD = enable;
+#ifdef TRANSPARENT_SURFACE_SSE2
+	return haveSSE2();
+#else
+	return false;
+#endif
+}
+
 TransparentSurface::TransparentSurface() : Surface(), _alphaMode(ALPHA_FULL) {}
 
 TransparentSurface::TransparentSurface(const Surface &surf, bool copyData) : Surface(), _alphaMode(ALPHA_FULL) {
@@ -141,6 +415,16 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
  */
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENT_SURFACE_SSE2
+	if (s_useSIMD && haveSSE2()) {
+		if (color == 0xffffffff)
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, AlphaBlendSSE2());
+		else
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, TintedAlphaBlendSSE2(color));
+		return;
+	}
+#endif
+
 	byte *in;
 	byte *out;
 
@@ -199,6 +483,16 @@ void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * Optimized version of doBlit to be used with additive blended blitting
  */
 void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENT_SURFACE_SSE2
+	if (s_useSIMD && haveSSE2()) {
+		if (color == 0xffffffff)
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, AdditiveBlendSSE2());
+		else
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, TintedAdditiveBlendSSE2(color));
+		return;
+	}
+#endif
+
 	byte *in;
 	byte *out;
 
@@ -266,6 +560,16 @@ void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uin
  * Optimized version of doBlit to be used with subtractive blended blitting
  */
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENT_SURFACE_SSE2
+	if (s_useSIMD && haveSSE2()) {
+		if (color == 0xffffffff)
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, SubtractiveBlendSSE2());
+		else
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, TintedSubtractiveBlendSSE2(color));
+		return;
+	}
+#endif
+
 	byte *in;
 	byte *out;
 
@@ -331,6 +635,16 @@ void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height,
  * Optimized version of doBlit to be used with multiply blended blitting
  */
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+#ifdef TRANSPARENT_SURFACE_SSE2
+	if (s_useSIMD && haveSSE2()) {
+		if (color == 0xffffffff)
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, MultiplyBlendSSE2());
+		else
+			doBlitSSE2(ino, outo, width, height, pitch, inStep, inoStep, TintedMultiplyBlendSSE2(color));
+		return;
+	}
+#endif
+
 	byte *in;
 	byte *out;
 
@@ -771,6 +1085,33 @@ systems.
 
 struct tColorRGBA { byte r; byte g; byte b; byte a; };
 
+/**
+ * Bilinear interpolation of a pixel from its four neighbours.
+ * @param ex, ey	the position between the neighbours, as 16 bit fractions.
+ */
+static inline void interpolatePixel(const tColorRGBA *c00, const tColorRGBA *c01, const tColorRGBA *c10, const tColorRGBA *c11, int ex, int ey, tColorRGBA *dp) {
+#ifdef TRANSPARENT_SURFACE_SSE2
+	if (s_useSIMD && haveSSE2()) {
+		WRITE_UINT32(dp, interpolateSSE2(READ_UINT32(c00), READ_UINT32(c01), READ_UINT32(c10), READ_UINT32(c11), ex, ey));
+		return;
+	}
+#endif
+
+	int t1, t2;
+	t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
+	t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
+	dp->r = (((t2 - t1) * ey) >> 16) + t1;
+	t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
+	t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
+	dp->g = (((t2 - t1) * ey) >> 16) + t1;
+	t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
+	t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
+	dp->b = (((t2 - t1) * ey) >> 16) + t1;
+	t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
+	t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
+	dp->a = (((t2 - t1) * ey) >> 16) + t1;
+}
+
 template <TFilteringMode filteringMode>
 TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transform) const {
 
@@ -858,19 +1199,7 @@ TransparentSurface *TransparentSurface::rotoscaleT(const TransformStruct &transf
 					*/
 					int ex = (sdx & 0xffff);
 					int ey = (sdy & 0xffff);
-					int t1, t2;
-					t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-					t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-					pc->r = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-					t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-					pc->g = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-					t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-					pc->b = (((t2 - t1) * ey) >> 16) + t1;
-					t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-					t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-					pc->a = (((t2 - t1) * ey) >> 16) + t1;
+					interpolatePixel(&c00, &c01, &c10, &c11, ex, ey, pc);
 				}
 			} else {
 				if ((dx >= 0) && (dy >= 0) && (dx < srcW) && (dy < srcH)) {
@@ -997,19 +1326,7 @@ TransparentSurface *TransparentSurface::scaleT(uint16 newWidth, uint16 newHeight
 				/*
 				* Draw and interpolate colors
 				*/
-				int t1, t2;
-				t1 = ((((c01->r - c00->r) * ex) >> 16) + c00->r) & 0xff;
-				t2 = ((((c11->r - c10->r) * ex) >> 16) + c10->r) & 0xff;
-				dp->r = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->g - c00->g) * ex) >> 16) + c00->g) & 0xff;
-				t2 = ((((c11->g - c10->g) * ex) >> 16) + c10->g) & 0xff;
-				dp->g = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->b - c00->b) * ex) >> 16) + c00->b) & 0xff;
-				t2 = ((((c11->b - c10->b) * ex) >> 16) + c10->b) & 0xff;
-				dp->b = (((t2 - t1) * ey) >> 16) + t1;
-				t1 = ((((c01->a - c00->a) * ex) >> 16) + c00->a) & 0xff;
-				t2 = ((((c11->a - c10->a) * ex) >> 16) + c10->a) & 0xff;
-				dp->a = (((t2 - t1) * ey) >> 16) + t1;
+				interpolatePixel(c00, c01, c10, c11, ex, ey, dp);
 
 				/*
 				* Advance source pointer x
@@ -138,6 +138,16 @@ struct TransparentSurface : public Graphics::Surface {
 
 	void applyColorKey(uint8 r, uint8 g, uint8 b, bool overwriteAlpha = false);
 
+	/**
+	 * Enable or disable the use of vector instructions for blending in
+	 * blit() and blitClip(), and for bilinear filtering in scaleT() and
+	 * rotoscaleT(). They are enabled by default, and produce exactly the
+	 * same images.
+	 *
+	 * @return whether vector instructions are available at all
+	 */
+	static bool setSIMD(bool enable);
+
 	/**
 	 * @brief Scale function; this returns a transformed version of this surface after rotation and
 	 * scaling. Please do not use this if angle != 0, use rotoscale.
@@ -83,9 +83,40 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/util.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+// The conversion of the pixels from YUV to RGB is vectorized with SSE2 on
+// x86, and with NEON on ARM. Builds which may run on x86 CPUs without SSE2
+// compile the vector code through a function attribute, and only use it
+// when the CPU reports support for it at runtime. The same goes for the
+// SSSE3 version of the YUV410 conversion. NEON is part of the target of
+// the builds using it.
+#if defined(__SSE2__)
+#define YUV_TO_RGB_SSE2
+#define YUV_TO_RGB_SSE2_TARGET
+#include <emmintrin.h>
+#elif defined(__i386__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define YUV_TO_RGB_SSE2
+#define YUV_TO_RGB_SSE2_TARGET __attribute__((target("sse2")))
+#define YUV_TO_RGB_SSE2_RUNTIME_CHECK
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define YUV_TO_RGB_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(YUV_TO_RGB_SSE2) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define YUV_TO_RGB_SSSE3
+#define YUV_TO_RGB_SSSE3_TARGET __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#endif
+
+#if defined(YUV_TO_RGB_SSE2) || defined(YUV_TO_RGB_NEON)
+#define YUV_TO_RGB_SIMD
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -159,6 +190,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
+	_useSIMD = true;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -192,6 +224,700 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+#ifdef YUV_TO_RGB_SSE2
+
+namespace {
+
+/**
+ * Whether the CPU supports the SSE2 conversions. The CPU is only checked on
+ * first use.
+ */
+bool haveSSE2() {
+#ifdef YUV_TO_RGB_SSE2_RUNTIME_CHECK
+	static int supported = -1;
+	if (supported < 0) {
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("sse2") ? 1 : 0;
+	}
+	return supported != 0;
+#else
+	return true;
+#endif
+}
+
+#ifdef YUV_TO_RGB_SSSE3
+/** Whether the CPU supports the SSSE3 conversion, see haveSSE2() */
+bool haveSSSE3() {
+	static int supported = -1;
+	if (supported < 0) {
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("ssse3") ? 1 : 0;
+	}
+	return supported != 0;
+}
+#endif
+
+} // End of anonymous namespace
+
+#endif // YUV_TO_RGB_SSE2
+
+bool YUVToRGBManager::setSIMD(bool enable) {
+	_useSIMD = enable;
+#if defined(YUV_TO_RGB_SSE2)
+	return haveSSE2();
+#elif defined(YUV_TO_RGB_NEON)
+	return true;
+#else
+	return false;
+#endif
+}
+
+#ifdef YUV_TO_RGB_SIMD
+
+namespace {
+
+/**
+ * Check whether the vector code supports the pixel format. This is the case
+ * for all 16 bits formats, and for 32 bits formats with eight bits per
+ * channel, stored in separate bytes.
+ */
+bool isSIMDFormat(const Graphics::PixelFormat &format) {
+	if (format.bytesPerPixel == 2)
+		return true;
+
+	return format.rLoss == 0 && format.gLoss == 0 && format.bLoss == 0 &&
+	       (format.rShift & 7) == 0 && (format.gShift & 7) == 0 && (format.bShift & 7) == 0;
+}
+
+/**
+ * Convert a single pixel through the tables, for the pixels left over by
+ * the vector code.
+ */
+template<typename PixelInt>
+inline PixelInt convertPixel(const uint32 *rgbToPix, const int16 *colorTab, byte y, byte u, byte v) {
+	const uint32 *L = &rgbToPix[y];
+	return L[colorTab[0 * 256 + v]] | L[colorTab[1 * 256 + v] + colorTab[2 * 256 + u]] | L[colorTab[3 * 256 + u]];
+}
+
+/**
+ * Interpolate the chroma value of a pixel of a YUV410 image, the same way
+ * convertYUV410ToRGB() does.
+ */
+inline byte interpolate410(const byte *row, int pitch, int x, int yDiff) {
+	const int index = x >> 2;
+	const int xDiff = x & 3;
+	return (row[index] * (4 - xDiff) * (4 - yDiff) + row[index + 1] * xDiff * (4 - yDiff) +
+	        row[index + pitch] * yDiff * (4 - xDiff) + row[index + pitch + 1] * xDiff * yDiff) >> 4;
+}
+
+} // End of anonymous namespace
+
+#endif // YUV_TO_RGB_SIMD
+
+#ifdef YUV_TO_RGB_SSE2
+
+namespace {
+
+/**
+ * Multiply the signed values by the factor K / 2^S, rounding towards zero
+ * like the conversion of the doubles in the color tables does.
+ */
+template<int K, int S>
+YUV_TO_RGB_SSE2_TARGET inline __m128i mulChroma(__m128i value) {
+	const __m128i sign = _mm_srai_epi16(value, 15);
+	const __m128i magnitude = _mm_sub_epi16(_mm_xor_si128(value, sign), sign);
+	const __m128i product = _mm_mulhi_epu16(_mm_slli_epi16(magnitude, 16 - S), _mm_set1_epi16(K));
+	return _mm_sub_epi16(_mm_xor_si128(product, sign), sign);
+}
+
+/**
+ * Compute the chroma contributions to the red, green and blue values, i.e.
+ * the values of the color tables without the offsets into the rgb-to-pixel
+ * table. The factors are exact for all chroma values.
+ */
+YUV_TO_RGB_SSE2_TARGET inline void computeChroma(__m128i u, __m128i v, __m128i &r, __m128i &g, __m128i &b) {
+	const __m128i cb = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	const __m128i cr = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+	// The factors 0.419 / 0.299, 0.299 / 0.419, 0.114 / 0.331 and
+	// 0.587 / 0.331 of the color tables
+	r = mulChroma<717, 9>(cr);
+	g = _mm_sub_epi16(_mm_setzero_si128(), _mm_add_epi16(mulChroma<731, 10>(cr), mulChroma<2821, 13>(cb)));
+	b = mulChroma<29055, 14>(cb);
+}
+
+/**
+ * Clamp the channel values, and map them from the luminance scale to
+ * [0, 255], exactly like the rgb-to-pixel tables do.
+ */
+YUV_TO_RGB_SSE2_TARGET inline __m128i scaleChannel(__m128i value, YUVToRGBManager::LuminanceScale scale) {
+	if (scale == YUVToRGBManager::kScaleFull)
+		return _mm_max_epi16(_mm_min_epi16(value, _mm_set1_epi16(255)), _mm_setzero_si128());
+
+	value = _mm_max_epi16(_mm_min_epi16(value, _mm_set1_epi16(235)), _mm_set1_epi16(16));
+	// Multiply by 255 / 219, as (value * 38155) >> 15; this is exact for all
+	// values in [0, 219]
+	value = _mm_slli_epi16(_mm_sub_epi16(value, _mm_set1_epi16(16)), 1);
+	return _mm_mulhi_epu16(value, _mm_set1_epi16((int16)38155));
+}
+
+/**
+ * The shift amounts of the channels of a pixel format, as used by the
+ * vector shift instructions.
+ *
+ * 32 bits pixels are assembled from their low and high 16 bits, so the
+ * channels are only shifted as 16 bits values. Shifting those by 16 or more
+ * bits gives zero, which takes care of the channels not contributing to the
+ * low or the high bits.
+ */
+struct SIMDFormat {
+	YUV_TO_RGB_SSE2_TARGET SIMDFormat(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale_) {
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+		rHighShift = _mm_cvtsi32_si128(format.rShift >= 16 ? format.rShift - 16 : 16);
+		gHighShift = _mm_cvtsi32_si128(format.gShift >= 16 ? format.gShift - 16 : 16);
+		bHighShift = _mm_cvtsi32_si128(format.bShift >= 16 ? format.bShift - 16 : 16);
+		alpha = format.RGBToColor(0, 0, 0);
+		scale = scale_;
+	}
+
+	/** Right shifts of the channels; only used for 16 bits pixels */
+	__m128i rLoss, gLoss, bLoss;
+	/** Left shifts into the (low) 16 bits */
+	__m128i rShift, gShift, bShift;
+	/** Left shifts into the high 16 bits of 32 bits pixels */
+	__m128i rHighShift, gHighShift, bHighShift;
+	/** The alpha bits, which are set in every pixel of the tables */
+	uint32 alpha;
+	YUVToRGBManager::LuminanceScale scale;
+};
+
+YUV_TO_RGB_SSE2_TARGET inline void storePixels(uint16 *dst, __m128i r, __m128i g, __m128i b, const SIMDFormat &format) {
+	__m128i pixels = _mm_set1_epi16((int16)format.alpha);
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(r, format.rLoss), format.rShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(g, format.gLoss), format.gShift));
+	pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(b, format.bLoss), format.bShift));
+	_mm_storeu_si128((__m128i *)dst, pixels);
+}
+
+YUV_TO_RGB_SSE2_TARGET inline void storePixels(uint32 *dst, __m128i r, __m128i g, __m128i b, const SIMDFormat &format) {
+	__m128i low = _mm_set1_epi16((int16)(format.alpha & 0xFFFF));
+	low = _mm_or_si128(low, _mm_sll_epi16(r, format.rShift));
+	low = _mm_or_si128(low, _mm_sll_epi16(g, format.gShift));
+	low = _mm_or_si128(low, _mm_sll_epi16(b, format.bShift));
+
+	__m128i high = _mm_set1_epi16((int16)(format.alpha >> 16));
+	high = _mm_or_si128(high, _mm_sll_epi16(r, format.rHighShift));
+	high = _mm_or_si128(high, _mm_sll_epi16(g, format.gHighShift));
+	high = _mm_or_si128(high, _mm_sll_epi16(b, format.bHighShift));
+
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(low, high));
+	_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(low, high));
+}
+
+/**
+ * Convert eight pixels, given their luminance and chroma contributions.
+ */
+template<typename PixelInt>
+YUV_TO_RGB_SSE2_TARGET inline void convertPixels(PixelInt *dst, const byte *ySrc, __m128i r, __m128i g, __m128i b, const SIMDFormat &format) {
+	const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ySrc), _mm_setzero_si128());
+	storePixels(dst, scaleChannel(_mm_add_epi16(y, r), format.scale), scaleChannel(_mm_add_epi16(y, g), format.scale),
+	            scaleChannel(_mm_add_epi16(y, b), format.scale), format);
+}
+
+/**
+ * Load eight bytes, widened to 16 bits.
+ */
+YUV_TO_RGB_SSE2_TARGET inline __m128i loadBytes(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+template<typename PixelInt>
+YUV_TO_RGB_SSE2_TARGET void convertYUV444ToRGBSSE2(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int h = 0; h < yHeight; h++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+
+		int x = 0;
+		for (; x + 8 <= yWidth; x += 8) {
+			__m128i r, g, b;
+			computeChroma(loadBytes(uSrc + x), loadBytes(vSrc + x), r, g, b);
+			convertPixels(dst + x, ySrc + x, r, g, b, format);
+		}
+
+		for (; x < yWidth; x++)
+			dst[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[x], uSrc[x], vSrc[x]);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+YUV_TO_RGB_SSE2_TARGET void convertYUV420ToRGBSSE2(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int h = 0; h < yHeight; h += 2) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+		PixelInt *dstNext = (PixelInt *)(dstPtr + dstPitch);
+
+		// Each chroma value covers two pixels on two lines
+		int x = 0;
+		for (; x + 16 <= yWidth; x += 16) {
+			__m128i r, g, b;
+			computeChroma(loadBytes(uSrc + (x >> 1)), loadBytes(vSrc + (x >> 1)), r, g, b);
+
+			const __m128i rLow = _mm_unpacklo_epi16(r, r), gLow = _mm_unpacklo_epi16(g, g), bLow = _mm_unpacklo_epi16(b, b);
+			convertPixels(dst + x, ySrc + x, rLow, gLow, bLow, format);
+			convertPixels(dstNext + x, ySrc + yPitch + x, rLow, gLow, bLow, format);
+
+			const __m128i rHigh = _mm_unpackhi_epi16(r, r), gHigh = _mm_unpackhi_epi16(g, g), bHigh = _mm_unpackhi_epi16(b, b);
+			convertPixels(dst + x + 8, ySrc + x + 8, rHigh, gHigh, bHigh, format);
+			convertPixels(dstNext + x + 8, ySrc + yPitch + x + 8, rHigh, gHigh, bHigh, format);
+		}
+
+		for (; x < yWidth; x++) {
+			const byte u = uSrc[x >> 1], v = vSrc[x >> 1];
+			dst[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[x], u, v);
+			dstNext[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[yPitch + x], u, v);
+		}
+
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+/**
+ * Repeat each of eight column values four times, for the pixels lying in
+ * that column.
+ */
+YUV_TO_RGB_SSE2_TARGET inline void expandColumns(__m128i columns, __m128i expanded[4]) {
+	const __m128i low = _mm_unpacklo_epi16(columns, columns);
+	const __m128i high = _mm_unpackhi_epi16(columns, columns);
+	expanded[0] = _mm_unpacklo_epi32(low, low);
+	expanded[1] = _mm_unpackhi_epi32(low, low);
+	expanded[2] = _mm_unpacklo_epi32(high, high);
+	expanded[3] = _mm_unpackhi_epi32(high, high);
+}
+
+/**
+ * Interpolate the chroma values of eight pixels horizontally, between the
+ * (vertically interpolated) values of the columns they lie in and those of
+ * the columns to the right.
+ */
+YUV_TO_RGB_SSE2_TARGET inline __m128i interpolateChroma(__m128i left, __m128i right) {
+	const __m128i xDiff = _mm_set_epi16(3, 2, 1, 0, 3, 2, 1, 0);
+
+	// (left * (4 - xDiff) + right * xDiff) >> 4
+	const __m128i sum = _mm_add_epi16(_mm_slli_epi16(left, 2), _mm_mullo_epi16(_mm_sub_epi16(right, left), xDiff));
+	return _mm_srai_epi16(sum, 4);
+}
+
+/**
+ * Interpolate eight chroma columns between two chroma rows.
+ */
+YUV_TO_RGB_SSE2_TARGET inline __m128i interpolateRows(const byte *src, int pitch, __m128i topWeight, __m128i bottomWeight) {
+	return _mm_add_epi16(_mm_mullo_epi16(loadBytes(src), topWeight), _mm_mullo_epi16(loadBytes(src + pitch), bottomWeight));
+}
+
+template<typename PixelInt>
+YUV_TO_RGB_SSE2_TARGET void convertYUV410ToRGBSSE2(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const int quarterWidth = yWidth >> 2;
+
+	for (int y = 0; y < yHeight; y++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+
+		// Interpolate the chroma values the same way convertYUV410ToRGB()
+		// does: first between the two chroma rows, then between the columns.
+		const int yDiff = y & 3;
+		const byte *uRow = uSrc + (y >> 2) * uvPitch;
+		const byte *vRow = vSrc + (y >> 2) * uvPitch;
+		const __m128i topWeight = _mm_set1_epi16(4 - yDiff);
+		const __m128i bottomWeight = _mm_set1_epi16(yDiff);
+
+		// Eight chroma columns at a time, which need the values of the next
+		// column as well. The last column is left to the table code, so the
+		// vector code reads no further than it.
+		int column = 0;
+		for (; column + 8 < quarterWidth; column += 8) {
+			__m128i uLeft[4], uRight[4], vLeft[4], vRight[4];
+			expandColumns(interpolateRows(uRow + column, uvPitch, topWeight, bottomWeight), uLeft);
+			expandColumns(interpolateRows(uRow + column + 1, uvPitch, topWeight, bottomWeight), uRight);
+			expandColumns(interpolateRows(vRow + column, uvPitch, topWeight, bottomWeight), vLeft);
+			expandColumns(interpolateRows(vRow + column + 1, uvPitch, topWeight, bottomWeight), vRight);
+
+			for (int i = 0; i < 4; i++) {
+				const int x = (column + i * 2) * 4;
+				__m128i r, g, b;
+				computeChroma(interpolateChroma(uLeft[i], uRight[i]), interpolateChroma(vLeft[i], vRight[i]), r, g, b);
+				convertPixels(dst + x, ySrc + x, r, g, b, format);
+			}
+		}
+
+		for (int x = column * 4; x < yWidth; x++)
+			dst[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[x], interpolate410(uRow, uvPitch, x, yDiff), interpolate410(vRow, uvPitch, x, yDiff));
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
+#ifdef YUV_TO_RGB_SSSE3
+
+/**
+ * mulChroma() with the sign handled by SSSE3 instructions.
+ */
+template<int K, int S>
+YUV_TO_RGB_SSSE3_TARGET inline __m128i mulChromaSSSE3(__m128i value) {
+	const __m128i product = _mm_mulhi_epu16(_mm_slli_epi16(_mm_abs_epi16(value), 16 - S), _mm_set1_epi16(K));
+	return _mm_sign_epi16(product, value);
+}
+
+YUV_TO_RGB_SSSE3_TARGET inline void computeChromaSSSE3(__m128i u, __m128i v, __m128i &r, __m128i &g, __m128i &b) {
+	const __m128i cb = _mm_sub_epi16(u, _mm_set1_epi16(128));
+	const __m128i cr = _mm_sub_epi16(v, _mm_set1_epi16(128));
+
+	r = mulChromaSSSE3<717, 9>(cr);
+	g = _mm_sub_epi16(_mm_setzero_si128(), _mm_add_epi16(mulChromaSSSE3<731, 10>(cr), mulChromaSSSE3<2821, 13>(cb)));
+	b = mulChromaSSSE3<29055, 14>(cb);
+}
+
+/**
+ * Load the chroma values of eight columns, each paired with the value of
+ * the column to its right.
+ */
+YUV_TO_RGB_SSSE3_TARGET inline __m128i loadColumnPairs(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_loadl_epi64((const __m128i *)(src + 1)));
+}
+
+/**
+ * Interpolate the chroma values of eight pixels between two chroma rows of
+ * column pairs. The pairs of the two columns the pixels lie in are picked
+ * by the shuffle, and weighted horizontally by a single multiply-add.
+ */
+YUV_TO_RGB_SSSE3_TARGET inline __m128i interpolateChromaSSSE3(__m128i top, __m128i bottom, __m128i shuffle, __m128i topWeight, __m128i bottomWeight) {
+	const __m128i xWeights = _mm_setr_epi8(4, 0, 3, 1, 2, 2, 1, 3, 4, 0, 3, 1, 2, 2, 1, 3);
+	const __m128i topSum = _mm_maddubs_epi16(_mm_shuffle_epi8(top, shuffle), xWeights);
+	const __m128i bottomSum = _mm_maddubs_epi16(_mm_shuffle_epi8(bottom, shuffle), xWeights);
+	return _mm_srai_epi16(_mm_add_epi16(_mm_mullo_epi16(topSum, topWeight), _mm_mullo_epi16(bottomSum, bottomWeight)), 4);
+}
+
+template<typename PixelInt>
+YUV_TO_RGB_SSSE3_TARGET void convertYUV410ToRGBSSSE3(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const int quarterWidth = yWidth >> 2;
+
+	// The bytes of the first two column pairs, each repeated for the four
+	// pixels of its column
+	const __m128i pairShuffle = _mm_setr_epi8(0, 1, 0, 1, 0, 1, 0, 1, 2, 3, 2, 3, 2, 3, 2, 3);
+
+	for (int y = 0; y < yHeight; y++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+
+		const int yDiff = y & 3;
+		const byte *uRow = uSrc + (y >> 2) * uvPitch;
+		const byte *vRow = vSrc + (y >> 2) * uvPitch;
+		const __m128i topWeight = _mm_set1_epi16(4 - yDiff);
+		const __m128i bottomWeight = _mm_set1_epi16(yDiff);
+
+		// As in convertYUV410ToRGBSSE2(), the last column is left to the
+		// table code
+		int column = 0;
+		for (; column + 8 < quarterWidth; column += 8) {
+			const __m128i uTop = loadColumnPairs(uRow + column), uBottom = loadColumnPairs(uRow + uvPitch + column);
+			const __m128i vTop = loadColumnPairs(vRow + column), vBottom = loadColumnPairs(vRow + uvPitch + column);
+
+			for (int i = 0; i < 4; i++) {
+				const int x = (column + i * 2) * 4;
+				const __m128i shuffle = _mm_add_epi8(pairShuffle, _mm_set1_epi8(i * 4));
+				__m128i r, g, b;
+				computeChromaSSSE3(interpolateChromaSSSE3(uTop, uBottom, shuffle, topWeight, bottomWeight),
+				                   interpolateChromaSSSE3(vTop, vBottom, shuffle, topWeight, bottomWeight), r, g, b);
+				convertPixels(dst + x, ySrc + x, r, g, b, format);
+			}
+		}
+
+		for (int x = column * 4; x < yWidth; x++)
+			dst[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[x], interpolate410(uRow, uvPitch, x, yDiff), interpolate410(vRow, uvPitch, x, yDiff));
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
+#endif // YUV_TO_RGB_SSSE3
+
+} // End of anonymous namespace
+
+#endif // YUV_TO_RGB_SSE2
+
+#ifdef YUV_TO_RGB_NEON
+
+namespace {
+
+/**
+ * Multiply the signed values by the factor K / 2^S, rounding towards zero
+ * like the conversion of the doubles in the color tables does.
+ */
+template<int K, int S>
+inline int16x8_t mulChroma(int16x8_t value) {
+	const int16x8_t sign = vshrq_n_s16(value, 15);
+	const uint16x8_t magnitude = vreinterpretq_u16_s16(vabsq_s16(value));
+	const uint16x4_t low = vshrn_n_u32(vmull_u16(vget_low_u16(magnitude), vdup_n_u16(K)), S);
+	const uint16x4_t high = vshrn_n_u32(vmull_u16(vget_high_u16(magnitude), vdup_n_u16(K)), S);
+	const int16x8_t product = vreinterpretq_s16_u16(vcombine_u16(low, high));
+	return vsubq_s16(veorq_s16(product, sign), sign);
+}
+
+/**
+ * Compute the chroma contributions to the red, green and blue values, like
+ * computeChroma() of the SSE2 version.
+ */
+inline void computeChroma(int16x8_t u, int16x8_t v, int16x8_t &r, int16x8_t &g, int16x8_t &b) {
+	const int16x8_t cb = vsubq_s16(u, vdupq_n_s16(128));
+	const int16x8_t cr = vsubq_s16(v, vdupq_n_s16(128));
+
+	r = mulChroma<717, 9>(cr);
+	g = vnegq_s16(vaddq_s16(mulChroma<731, 10>(cr), mulChroma<2821, 13>(cb)));
+	b = mulChroma<29055, 14>(cb);
+}
+
+/**
+ * Clamp the channel values, and map them from the luminance scale to
+ * [0, 255], exactly like the rgb-to-pixel tables do.
+ */
+inline uint16x8_t scaleChannel(int16x8_t value, YUVToRGBManager::LuminanceScale scale) {
+	if (scale == YUVToRGBManager::kScaleFull)
+		return vreinterpretq_u16_s16(vmaxq_s16(vminq_s16(value, vdupq_n_s16(255)), vdupq_n_s16(0)));
+
+	value = vmaxq_s16(vminq_s16(value, vdupq_n_s16(235)), vdupq_n_s16(16));
+	// Multiply by 255 / 219, as (value * 38155) >> 15
+	const uint16x8_t scaled = vreinterpretq_u16_s16(vsubq_s16(value, vdupq_n_s16(16)));
+	const uint16x4_t low = vshrn_n_u32(vmull_u16(vget_low_u16(scaled), vdup_n_u16(38155)), 15);
+	const uint16x4_t high = vshrn_n_u32(vmull_u16(vget_high_u16(scaled), vdup_n_u16(38155)), 15);
+	return vcombine_u16(low, high);
+}
+
+/**
+ * The shift amounts of the channels of a pixel format. NEON shifts right
+ * by negative amounts.
+ */
+struct SIMDFormat {
+	SIMDFormat(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale_) {
+		rLoss = vdupq_n_s16(-format.rLoss);
+		gLoss = vdupq_n_s16(-format.gLoss);
+		bLoss = vdupq_n_s16(-format.bLoss);
+		rShift = vdupq_n_s16(format.rShift);
+		gShift = vdupq_n_s16(format.gShift);
+		bShift = vdupq_n_s16(format.bShift);
+		rShift32 = vdupq_n_s32(format.rShift);
+		gShift32 = vdupq_n_s32(format.gShift);
+		bShift32 = vdupq_n_s32(format.bShift);
+		alpha = format.RGBToColor(0, 0, 0);
+		scale = scale_;
+	}
+
+	/** Shifts of 16 bits pixels */
+	int16x8_t rLoss, gLoss, bLoss, rShift, gShift, bShift;
+	/** Shifts of 32 bits pixels, which have no loss */
+	int32x4_t rShift32, gShift32, bShift32;
+	/** The alpha bits, which are set in every pixel of the tables */
+	uint32 alpha;
+	YUVToRGBManager::LuminanceScale scale;
+};
+
+inline void storePixels(uint16 *dst, uint16x8_t r, uint16x8_t g, uint16x8_t b, const SIMDFormat &format) {
+	uint16x8_t pixels = vdupq_n_u16((uint16)format.alpha);
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(r, format.rLoss), format.rShift));
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(g, format.gLoss), format.gShift));
+	pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(b, format.bLoss), format.bShift));
+	vst1q_u16(dst, pixels);
+}
+
+inline void storePixels(uint32 *dst, uint16x8_t r, uint16x8_t g, uint16x8_t b, const SIMDFormat &format) {
+	const uint32x4_t alpha = vdupq_n_u32(format.alpha);
+
+	uint32x4_t low = vorrq_u32(alpha, vshlq_u32(vmovl_u16(vget_low_u16(r)), format.rShift32));
+	low = vorrq_u32(low, vshlq_u32(vmovl_u16(vget_low_u16(g)), format.gShift32));
+	low = vorrq_u32(low, vshlq_u32(vmovl_u16(vget_low_u16(b)), format.bShift32));
+
+	uint32x4_t high = vorrq_u32(alpha, vshlq_u32(vmovl_u16(vget_high_u16(r)), format.rShift32));
+	high = vorrq_u32(high, vshlq_u32(vmovl_u16(vget_high_u16(g)), format.gShift32));
+	high = vorrq_u32(high, vshlq_u32(vmovl_u16(vget_high_u16(b)), format.bShift32));
+
+	vst1q_u32(dst, low);
+	vst1q_u32(dst + 4, high);
+}
+
+/**
+ * Load eight bytes, widened to 16 bits.
+ */
+inline int16x8_t loadBytes(const byte *src) {
+	return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+}
+
+/**
+ * Convert eight pixels, given their luminance and chroma contributions.
+ */
+template<typename PixelInt>
+inline void convertPixels(PixelInt *dst, const byte *ySrc, int16x8_t r, int16x8_t g, int16x8_t b, const SIMDFormat &format) {
+	const int16x8_t y = loadBytes(ySrc);
+	storePixels(dst, scaleChannel(vaddq_s16(y, r), format.scale), scaleChannel(vaddq_s16(y, g), format.scale),
+	            scaleChannel(vaddq_s16(y, b), format.scale), format);
+}
+
+template<typename PixelInt>
+void convertYUV444ToRGBNEON(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int h = 0; h < yHeight; h++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+
+		int x = 0;
+		for (; x + 8 <= yWidth; x += 8) {
+			int16x8_t r, g, b;
+			computeChroma(loadBytes(uSrc + x), loadBytes(vSrc + x), r, g, b);
+			convertPixels(dst + x, ySrc + x, r, g, b, format);
+		}
+
+		for (; x < yWidth; x++)
+			dst[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[x], uSrc[x], vSrc[x]);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+void convertYUV420ToRGBNEON(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int h = 0; h < yHeight; h += 2) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+		PixelInt *dstNext = (PixelInt *)(dstPtr + dstPitch);
+
+		// Each chroma value covers two pixels on two lines
+		int x = 0;
+		for (; x + 16 <= yWidth; x += 16) {
+			int16x8_t r, g, b;
+			computeChroma(loadBytes(uSrc + (x >> 1)), loadBytes(vSrc + (x >> 1)), r, g, b);
+
+			const int16x8x2_t rPairs = vzipq_s16(r, r), gPairs = vzipq_s16(g, g), bPairs = vzipq_s16(b, b);
+			convertPixels(dst + x, ySrc + x, rPairs.val[0], gPairs.val[0], bPairs.val[0], format);
+			convertPixels(dstNext + x, ySrc + yPitch + x, rPairs.val[0], gPairs.val[0], bPairs.val[0], format);
+			convertPixels(dst + x + 8, ySrc + x + 8, rPairs.val[1], gPairs.val[1], bPairs.val[1], format);
+			convertPixels(dstNext + x + 8, ySrc + yPitch + x + 8, rPairs.val[1], gPairs.val[1], bPairs.val[1], format);
+		}
+
+		for (; x < yWidth; x++) {
+			const byte u = uSrc[x >> 1], v = vSrc[x >> 1];
+			dst[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[x], u, v);
+			dstNext[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[yPitch + x], u, v);
+		}
+
+		dstPtr += dstPitch << 1;
+		ySrc += yPitch << 1;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+/**
+ * Repeat each of eight column values four times, for the pixels lying in
+ * that column.
+ */
+inline void expandColumns(int16x8_t columns, int16x8_t expanded[4]) {
+	const int16x8x2_t pairs = vzipq_s16(columns, columns);
+	const int32x4x2_t low = vzipq_s32(vreinterpretq_s32_s16(pairs.val[0]), vreinterpretq_s32_s16(pairs.val[0]));
+	const int32x4x2_t high = vzipq_s32(vreinterpretq_s32_s16(pairs.val[1]), vreinterpretq_s32_s16(pairs.val[1]));
+	expanded[0] = vreinterpretq_s16_s32(low.val[0]);
+	expanded[1] = vreinterpretq_s16_s32(low.val[1]);
+	expanded[2] = vreinterpretq_s16_s32(high.val[0]);
+	expanded[3] = vreinterpretq_s16_s32(high.val[1]);
+}
+
+/**
+ * Interpolate the chroma values of eight pixels horizontally, between the
+ * (vertically interpolated) values of the columns they lie in and those of
+ * the columns to the right.
+ */
+inline int16x8_t interpolateChroma(int16x8_t left, int16x8_t right) {
+	static const int16 xDiffs[8] = { 0, 1, 2, 3, 0, 1, 2, 3 };
+
+	// (left * (4 - xDiff) + right * xDiff) >> 4
+	return vshrq_n_s16(vmlaq_s16(vshlq_n_s16(left, 2), vsubq_s16(right, left), vld1q_s16(xDiffs)), 4);
+}
+
+/**
+ * Interpolate eight chroma columns between two chroma rows.
+ */
+inline int16x8_t interpolateRows(const byte *src, int pitch, int16x8_t topWeight, int16x8_t bottomWeight) {
+	return vmlaq_s16(vmulq_s16(loadBytes(src), topWeight), loadBytes(src + pitch), bottomWeight);
+}
+
+template<typename PixelInt>
+void convertYUV410ToRGBNEON(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const SIMDFormat format(lookup->getFormat(), lookup->getScale());
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const int quarterWidth = yWidth >> 2;
+
+	for (int y = 0; y < yHeight; y++) {
+		PixelInt *dst = (PixelInt *)dstPtr;
+
+		const int yDiff = y & 3;
+		const byte *uRow = uSrc + (y >> 2) * uvPitch;
+		const byte *vRow = vSrc + (y >> 2) * uvPitch;
+		const int16x8_t topWeight = vdupq_n_s16(4 - yDiff);
+		const int16x8_t bottomWeight = vdupq_n_s16(yDiff);
+
+		// The last column is left to the table code, see
+		// convertYUV410ToRGBSSE2()
+		int column = 0;
+		for (; column + 8 < quarterWidth; column += 8) {
+			int16x8_t uLeft[4], uRight[4], vLeft[4], vRight[4];
+			expandColumns(interpolateRows(uRow + column, uvPitch, topWeight, bottomWeight), uLeft);
+			expandColumns(interpolateRows(uRow + column + 1, uvPitch, topWeight, bottomWeight), uRight);
+			expandColumns(interpolateRows(vRow + column, uvPitch, topWeight, bottomWeight), vLeft);
+			expandColumns(interpolateRows(vRow + column + 1, uvPitch, topWeight, bottomWeight), vRight);
+
+			for (int i = 0; i < 4; i++) {
+				const int x = (column + i * 2) * 4;
+				int16x8_t r, g, b;
+				computeChroma(interpolateChroma(uLeft[i], uRight[i]), interpolateChroma(vLeft[i], vRight[i]), r, g, b);
+				convertPixels(dst + x, ySrc + x, r, g, b, format);
+			}
+		}
+
+		for (int x = column * 4; x < yWidth; x++)
+			dst[x] = convertPixel<PixelInt>(rgbToPix, colorTab, ySrc[x], interpolate410(uRow, uvPitch, x, yDiff), interpolate410(vRow, uvPitch, x, yDiff));
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
+} // End of anonymous namespace
+
+#endif // YUV_TO_RGB_NEON
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -235,6 +961,24 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#if defined(YUV_TO_RGB_SSE2)
+	if (_useSIMD && haveSSE2() && isSIMDFormat(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV444ToRGBSSE2<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV444ToRGBSSE2<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#elif defined(YUV_TO_RGB_NEON)
+	if (_useSIMD && isSIMDFormat(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV444ToRGBNEON<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV444ToRGBNEON<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -291,6 +1035,24 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#if defined(YUV_TO_RGB_SSE2)
+	if (_useSIMD && haveSSE2() && isSIMDFormat(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV420ToRGBSSE2<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV420ToRGBSSE2<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#elif defined(YUV_TO_RGB_NEON)
+	if (_useSIMD && isSIMDFormat(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV420ToRGBNEON<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV420ToRGBNEON<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -376,6 +1138,33 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#if defined(YUV_TO_RGB_SSE2)
+	if (_useSIMD && haveSSE2() && isSIMDFormat(dst->format)) {
+#ifdef YUV_TO_RGB_SSSE3
+		if (haveSSSE3()) {
+			if (dst->format.bytesPerPixel == 2)
+				convertYUV410ToRGBSSSE3<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+			else
+				convertYUV410ToRGBSSSE3<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+			return;
+		}
+#endif
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV410ToRGBSSE2<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV410ToRGBSSE2<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#elif defined(YUV_TO_RGB_NEON)
+	if (_useSIMD && isSIMDFormat(dst->format)) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV410ToRGBNEON<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV410ToRGBNEON<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
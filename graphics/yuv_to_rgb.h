@@ -105,6 +105,14 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Enable or disable the use of vector instructions for the conversions.
+	 * They are enabled by default, and produce exactly the same images.
+	 *
+	 * @return whether vector instructions are available at all
+	 */
+	bool setSIMD(bool enable);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -114,6 +122,7 @@ private:
 
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+	bool _useSIMD;
 };
 
 } // End of namespace Graphics
@@ -20,6 +20,7 @@
  *
  */
 
+#include "engines/filepropertiescache.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -259,6 +260,8 @@ void MassAddDialog::handleTickle() {
 	Common::String buf;
 
 	if (_scanStack.empty()) {
+		FilePropsCache.flush(true);
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -731,7 +731,7 @@ enum {
 
 SaveLoadChooserGrid::SaveLoadChooserGrid(const Common::String &title, bool saveMode)
 	: SaveLoadChooserDialog("SaveLoadChooser", saveMode), _lines(0), _columns(0), _entriesPerPage(0),
-	_curPage(0), _newSaveContainer(0), _nextFreeSaveSlot(0), _buttons() {
+	_curPage(0), _newSaveContainer(0), _nextFreeSaveSlot(0), _buttons(), _nextMetaInfoEntry(0) {
 	_backgroundType = ThemeEngine::kDialogBackgroundSpecial;
 
 	new StaticTextWidget(this, "SaveLoadChooser.Title", title);
@@ -814,6 +814,7 @@ void SaveLoadChooserGrid::handleMouseWheel(int x, int y, int direction) {
 
 void SaveLoadChooserGrid::updateSaveList() {
 	SaveLoadChooserDialog::updateSaveList();
+	_metaInfos.clear();
 	updateSaves();
 	g_gui.scheduleTopDialogRedraw();
 }
@@ -822,6 +823,7 @@ void SaveLoadChooserGrid::open() {
 	SaveLoadChooserDialog::open();
 
 	listSaves();
+	_metaInfos.clear();
 	_resultString.clear();
 
 	// Load information to restore the last page the user had open.
@@ -997,6 +999,38 @@ void SaveLoadChooserGrid::close() {
 
 	SaveLoadChooserDialog::close();
 	hideButtons();
+	_metaInfos.clear();
+}
+
+void SaveLoadChooserGrid::handleTickle() {
+	// Load the meta information of the visible slots a few at a time, so
+	// the dialog stays responsive with slow to parse savefiles.
+	const uint32 start = g_system->getMillis();
+	bool updated = false;
+	while (_nextMetaInfoEntry < _entriesPerPage && g_system->getMillis() - start < kMetaInfoTimeSlice) {
+		const uint curNum = _nextMetaInfoEntry++;
+		const uint i = _curPage * _entriesPerPage + curNum;
+		if (i >= _saveList.size()) {
+			_nextMetaInfoEntry = _entriesPerPage;
+			break;
+		}
+
+		const int saveSlot = _saveList[i].getSaveSlot();
+		if (_saveList[i].getLocked() || _metaInfos.contains(saveSlot))
+			continue;
+
+		SaveStateDescriptor &desc = _metaInfos[saveSlot];
+		desc = _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot);
+		// Failed queries return a descriptor without slot
+		desc.setSaveSlot(saveSlot);
+		updateSlotButton(_buttons[curNum], desc);
+		updated = true;
+	}
+
+	if (updated)
+		g_gui.scheduleTopDialogRedraw();
+
+	SaveLoadChooserDialog::handleTickle();
 }
 
 int SaveLoadChooserGrid::runIntern() {
@@ -1056,62 +1090,68 @@ void SaveLoadChooserGrid::hideButtons() {
 	}
 }
 
-void SaveLoadChooserGrid::updateSaves() {
-	hideButtons();
+void SaveLoadChooserGrid::updateSlotButton(SlotButton &curButton, const SaveStateDescriptor &desc) {
+	const Graphics::Surface *thumbnail = desc.getThumbnail();
+	if (thumbnail) {
+		curButton.button->setGfx(desc.getThumbnail());
+	} else {
+		curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	}
+	curButton.description->setLabel(Common::String::format("%d. %s", desc.getSaveSlot(), desc.getDescription().c_str()));
 
-	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
-		const uint saveSlot = _saveList[i].getSaveSlot();
+	Common::String tooltip(_("Name: "));
+	tooltip += desc.getDescription();
 
-		SaveStateDescriptor desc =  (_saveList[i].getLocked() ? _saveList[i] : _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot));
-		SlotButton &curButton = _buttons[curNum];
-		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
-			curButton.button->setGfx(desc.getThumbnail());
-		} else {
-			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	if (_saveDateSupport) {
+		const Common::String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty()) {
+			tooltip += "\n";
+			tooltip +=  _("Date: ") + saveDate;
 		}
-		curButton.description->setLabel(Common::String::format("%d. %s", saveSlot, desc.getDescription().c_str()));
-
-		Common::String tooltip(_("Name: "));
-		tooltip += desc.getDescription();
-
-		if (_saveDateSupport) {
-			const Common::String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty()) {
-				tooltip += "\n";
-				tooltip +=  _("Date: ") + saveDate;
-			}
 
-			const Common::String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Time: ") + saveTime;
-			}
+		const Common::String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Time: ") + saveTime;
 		}
+	}
 
-		if (_playTimeSupport) {
-			const Common::String &playTime = desc.getPlayTime();
-			if (!playTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Playtime: ") + playTime;
-			}
+	if (_playTimeSupport) {
+		const Common::String &playTime = desc.getPlayTime();
+		if (!playTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Playtime: ") + playTime;
 		}
+	}
 
-		curButton.button->setTooltip(tooltip);
+	curButton.button->setTooltip(tooltip);
 
-		// In save mode we disable the button, when it's write protected.
-		// TODO: Maybe we should not display it at all then?
-		if (_saveMode && desc.getWriteProtectedFlag()) {
-			curButton.button->setEnabled(false);
-		} else {
-			curButton.button->setEnabled(true);
-		}
+	// In save mode we disable the button, when it's write protected.
+	// TODO: Maybe we should not display it at all then?
+	if (_saveMode && desc.getWriteProtectedFlag()) {
+		curButton.button->setEnabled(false);
+	} else {
+		curButton.button->setEnabled(true);
+	}
+
+	//that would make it look "disabled" if slot is locked
+	curButton.button->setEnabled(!desc.getLocked());
+	curButton.description->setEnabled(!desc.getLocked());
+}
+
+void SaveLoadChooserGrid::updateSaves() {
+	hideButtons();
+
+	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
+		SlotButton &curButton = _buttons[curNum];
+		curButton.setVisible(true);
 
-		//that would make it look "disabled" if slot is locked
-		curButton.button->setEnabled(!desc.getLocked());
-		curButton.description->setEnabled(!desc.getLocked());
+		// Until handleTickle() loaded the meta information, show what
+		// listing the saves told us.
+		MetaInfoMap::const_iterator metaInfo = _metaInfos.find(_saveList[i].getSaveSlot());
+		updateSlotButton(curButton, metaInfo != _metaInfos.end() ? metaInfo->_value : _saveList[i]);
 	}
+	_nextMetaInfoEntry = 0;
 
 	const uint numPages = (_entriesPerPage != 0 && !_saveList.empty()) ? ((_saveList.size() + _entriesPerPage - 1) / _entriesPerPage) : 1;
 	_pageDisplay->setLabel(Common::String::format("%u/%u", _curPage + 1, numPages));
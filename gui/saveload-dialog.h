@@ -28,6 +28,8 @@
 
 #include "engines/metaengine.h"
 
+#include "common/hashmap.h"
+
 namespace GUI {
 
 #if defined(USE_CLOUD) && defined(USE_LIBCURL)
@@ -203,6 +205,8 @@ public:
 	virtual SaveLoadChooserType getType() const { return kSaveLoadDialogGrid; }
 
 	virtual void close();
+
+	virtual void handleTickle();
 protected:
 	virtual void handleCommand(CommandSender *sender, uint32 cmd, uint32 data);
 	virtual void handleMouseWheel(int x, int y, int direction);
@@ -210,6 +214,11 @@ protected:
 private:
 	virtual int runIntern();
 
+	enum {
+		/** Milliseconds spent loading meta information per tickle */
+		kMetaInfoTimeSlice = 20
+	};
+
 	uint _columns, _lines;
 	uint _entriesPerPage;
 	uint _curPage;
@@ -243,6 +252,17 @@ private:
 	void destroyButtons();
 	void hideButtons();
 	void updateSaves();
+	void updateSlotButton(SlotButton &curButton, const SaveStateDescriptor &desc);
+
+	/**
+	 * Meta information (including the thumbnails) of the slots shown so
+	 * far. It is loaded for the visible slots only, from handleTickle(),
+	 * so opening the dialog and switching pages does not wait for it.
+	 */
+	typedef Common::HashMap<int, SaveStateDescriptor> MetaInfoMap;
+	MetaInfoMap _metaInfos;
+	/** Index on the current page of the next slot to load meta information for */
+	uint _nextMetaInfoEntry;
 };
 
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
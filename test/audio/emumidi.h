@@ -0,0 +1,287 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/emumidi.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+/**
+ * Test suite for the render-ahead of MidiDriver_Emulated.
+ *
+ * The timer proc rendering the blocks is run by hand, through a stand-in
+ * for the backend.
+ */
+class MidiDriverEmulatedTestSuite : public CxxTest::TestSuite {
+	/** Runs the installed timer proc only when asked to. */
+	class ManualTimerManager : public Common::TimerManager {
+	public:
+		ManualTimerManager() : _proc(nullptr), _refCon(nullptr) {}
+
+		virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id) {
+			_proc = proc;
+			_refCon = refCon;
+			return true;
+		}
+
+		virtual void removeTimerProc(TimerProc proc) {
+			if (_proc == proc)
+				_proc = nullptr;
+		}
+
+		bool isInstalled() const { return _proc != nullptr; }
+
+		void run() {
+			if (_proc)
+				_proc(_refCon);
+		}
+
+	private:
+		TimerProc _proc;
+		void *_refCon;
+	};
+
+	/** The parts of a backend used by MidiDriver_Emulated. */
+	class TestSystem : public OSystem {
+	public:
+		TestSystem() : _timer(new ManualTimerManager()) {
+			_timerManager = _timer;
+		}
+
+		ManualTimerManager *_timer;
+
+		virtual uint32 getMillis(bool skipRecord = false) { return 0; }
+		virtual MutexRef createMutex() { return (MutexRef)this; }
+		virtual void lockMutex(MutexRef mutex) {}
+		virtual void unlockMutex(MutexRef mutex) {}
+		virtual void deleteMutex(MutexRef mutex) {}
+
+		virtual const GraphicsMode *getSupportedGraphicsModes() const { return nullptr; }
+		virtual int getDefaultGraphicsMode() const { return 0; }
+		virtual bool setGraphicsMode(int mode) { return false; }
+		virtual int getGraphicsMode() const { return 0; }
+		virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+		virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format = nullptr) {}
+		virtual int16 getHeight() { return 0; }
+		virtual int16 getWidth() { return 0; }
+		virtual PaletteManager *getPaletteManager() { return nullptr; }
+		virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+		virtual Graphics::Surface *lockScreen() { return nullptr; }
+		virtual void unlockScreen() {}
+		virtual void fillScreen(uint32 col) {}
+		virtual void updateScreen() {}
+		virtual void setShakePos(int shakeOffset) {}
+		virtual void showOverlay() {}
+		virtual void hideOverlay() {}
+		virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(); }
+		virtual void clearOverlay() {}
+		virtual void grabOverlay(void *buf, int pitch) {}
+		virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+		virtual int16 getOverlayHeight() { return 0; }
+		virtual int16 getOverlayWidth() { return 0; }
+		virtual bool showMouse(bool visible) { return false; }
+		virtual void warpMouse(int x, int y) {}
+		virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = nullptr) {}
+		virtual void delayMillis(uint msecs) {}
+		virtual void getTimeAndDate(TimeDate &t) const {}
+		virtual Audio::Mixer *getMixer() { return nullptr; }
+		virtual void quit() {}
+		virtual void displayMessageOnOSD(const char *msg) {}
+		virtual void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+		virtual void logMessage(LogMessageType::Type type, const char *message) {}
+	};
+
+	/**
+	 * A synthesizer whose samples are the value of the last event played.
+	 * When used as its own player, it sends the number of each tick as an
+	 * event, and every fifth tick as a sysEx.
+	 */
+	class TestDriver : public MidiDriver_Emulated {
+	public:
+		TestDriver() : MidiDriver_Emulated(nullptr), _ticks(0), _value(0) {}
+
+		/** The number of times the timer callback was called */
+		int _ticks;
+
+		void enableRenderAhead(uint32 milliseconds) { setRenderAhead(milliseconds); }
+		void setPlayer() { setTimerCallback(this, &timerProc); }
+
+		virtual int open() { return MidiDriver_Emulated::open(); }
+		virtual void close() { setRenderAhead(0); }
+
+		virtual void send(uint32 b) {
+			if (!queueEvent(b))
+				playEvent(b);
+		}
+
+		virtual void sysEx(const byte *msg, uint16 length) {
+			if (!queueSysEx(msg, length))
+				playSysEx(msg, length);
+		}
+
+		virtual MidiChannel *allocateChannel() { return nullptr; }
+		virtual MidiChannel *getPercussionChannel() { return nullptr; }
+
+		virtual bool isStereo() const { return false; }
+		virtual int getRate() const { return 25600; }
+
+	protected:
+		virtual void generateSamples(int16 *buf, int len) {
+			for (int i = 0; i < len; i++)
+				buf[i] = _value;
+		}
+
+		virtual void playEvent(uint32 b) { _value = (int16)(b & 0x7FFF); }
+		virtual void playSysEx(const byte *msg, uint16 length) { _value = (int16)(-(msg[0] | (msg[length - 1] << 8))); }
+
+	private:
+		int16 _value;
+
+		static void timerProc(void *param) {
+			TestDriver *driver = (TestDriver *)param;
+			driver->_ticks++;
+			if (driver->_ticks % 5) {
+				driver->send(driver->_ticks);
+			} else {
+				const byte msg[3] = { (byte)driver->_ticks, 0x10, (byte)(driver->_ticks >> 8) };
+				driver->sysEx(msg, 3);
+			}
+		}
+	};
+
+	/**
+	 * Frames by which events are delayed with 50ms of render-ahead at
+	 * 25600Hz: five blocks of 256 frames, and the block being played.
+	 */
+	static const int kLatency = 6 * 256;
+	static const int kLength = 20000;
+
+	/**
+	 * Play the same music with and without render-ahead, and check that
+	 * it is delayed by exactly the latency. The timer proc is run every
+	 * given number of chunks read by the mixer, or never when it is 0.
+	 */
+	void checkDelayed(int timerRuns) {
+		TestDriver plain, ahead;
+		plain.open();
+		plain.setPlayer();
+		ahead.open();
+		ahead.setPlayer();
+		ahead.enableRenderAhead(50);
+
+		int16 *plainSamples = new int16[kLength];
+		int16 *aheadSamples = new int16[kLength];
+
+		// Chunks of different sizes, as the mixer reads them
+		static const int chunks[] = { 1, 300, 512, 7, 1024, 64 };
+		int pos = 0;
+		for (int i = 0; pos < kLength; i++) {
+			const int len = MIN<int>(chunks[i % ARRAYSIZE(chunks)], kLength - pos);
+			plain.readBuffer(plainSamples + pos, len);
+			ahead.readBuffer(aheadSamples + pos, len);
+			pos += len;
+
+			// The timer callback is called as the samples are played
+			TS_ASSERT_EQUALS(ahead._ticks, plain._ticks);
+
+			if (timerRuns && i % timerRuns == 0) {
+				for (int j = 0; j < 3; j++)
+					_system->_timer->run();
+			}
+		}
+
+		for (int i = 0; i < kLength; i++) {
+			if (aheadSamples[i] != (i < kLatency ? 0 : plainSamples[i - kLatency])) {
+				TS_FAIL(Common::String::format("Sample %d differs", i).c_str());
+				break;
+			}
+		}
+
+		ahead.close();
+		delete[] plainSamples;
+		delete[] aheadSamples;
+	}
+
+	OSystem *_oldSystem;
+	TestSystem *_system;
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new TestSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = _oldSystem;
+		delete _system;
+	}
+
+	void test_render_ahead() {
+		checkDelayed(1);
+	}
+
+	void test_timer_slow() {
+		// Blocks are rendered, but not enough to keep up with the mixer
+		checkDelayed(4);
+	}
+
+	void test_timer_behind() {
+		// Without the timer proc running, the mixer renders everything
+		checkDelayed(0);
+	}
+
+	void test_direct_events() {
+		// Events sent outside of the timer callback are played the latency
+		// after the frame the mixer is at
+		TestDriver driver;
+		driver.open();
+		driver.enableRenderAhead(50);
+
+		int16 samples[4000];
+		driver.readBuffer(samples, 1000);
+		driver.send(0x1234);
+		_system->_timer->run();
+		driver.readBuffer(samples + 1000, 3000);
+		for (int i = 0; i < 4000; i++) {
+			if (samples[i] != (i < 1000 + kLatency ? 0 : 0x1234)) {
+				TS_FAIL(Common::String::format("Sample %d differs", i).c_str());
+				break;
+			}
+		}
+
+		driver.close();
+	}
+
+	void test_queue_full() {
+		// When the queue is full, the events are played right away, in order
+		TestDriver driver;
+		driver.open();
+		driver.enableRenderAhead(50);
+
+		for (int i = 1; i <= 2000; i++)
+			driver.send(i);
+
+		int16 samples[2000];
+		driver.readBuffer(samples, 2000);
+		TS_ASSERT_EQUALS(samples[0], 1025);
+		TS_ASSERT_EQUALS(samples[kLatency - 1], 1025);
+		TS_ASSERT_EQUALS(samples[kLatency], 2000);
+
+		driver.close();
+	}
+
+	void test_disable() {
+		TestDriver driver;
+		driver.open();
+		driver.enableRenderAhead(50);
+		TS_ASSERT(_system->_timer->isInstalled());
+
+		driver.close();
+		TS_ASSERT(!_system->_timer->isInstalled());
+
+		// Without render-ahead, events are played right away
+		int16 samples[10];
+		driver.send(0x42);
+		driver.readBuffer(samples, 10);
+		TS_ASSERT_EQUALS(samples[0], 0x42);
+	}
+};
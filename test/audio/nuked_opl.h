@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/random.h"
+#include "common/util.h"
+
+#include "audio/softsynth/opl/nuked.h"
+
+class NukedOPLTestSuite : public CxxTest::TestSuite {
+#ifndef DISABLE_NUKED_OPL
+	/**
+	 * Write random registers. Besides notes and instruments, this toggles
+	 * the rhythm mode, vibrato and tremolo depth and the 4 operator
+	 * channels.
+	 */
+	static void writeRandomRegisters(Common::XorShiftRandom &rnd, OPL::NUKED::opl3_chip *chip, bool opl3) {
+		static const uint8 registers[] = { 0x20, 0x40, 0x60, 0x80, 0xE0 };
+
+		for (int i = 0; i < 8; ++i) {
+			const uint16 high = (opl3 && (rnd.next() & 1)) ? 0x100 : 0;
+			const uint8 channel = rnd.next() % 9;
+			const uint8 op = (channel / 3) * 8 + (channel % 3) + (rnd.next() & 1) * 3;
+
+			switch (rnd.next() % 4) {
+			case 0:
+				OPL3_WriteReg(chip, high | registers[rnd.next() % ARRAYSIZE(registers)] | op, rnd.next() & 0xFF);
+				break;
+			case 1:
+				OPL3_WriteReg(chip, high | 0xC0 | channel, rnd.next() & 0xFF);
+				break;
+			default:
+				OPL3_WriteReg(chip, high | 0xA0 | channel, rnd.next() & 0xFF);
+				OPL3_WriteReg(chip, high | 0xB0 | channel, rnd.next() & 0x3F);
+				break;
+			}
+		}
+
+		if ((rnd.next() & 15) == 0)
+			OPL3_WriteReg(chip, 0xBD, rnd.next() & 0xFF);
+		if (opl3 && (rnd.next() & 31) == 0)
+			OPL3_WriteReg(chip, 0x104, rnd.next() & 0x3F);
+	}
+
+	/**
+	 * Render the same random register writes with and without vector
+	 * instructions, and compare the samples. Every other block switches
+	 * between the two, to check that the generator state survives that.
+	 */
+	void checkGenerate(bool opl3, bool switching) {
+		const int blocks = 200;
+		const int blockSamples = 300;
+
+		OPL::NUKED::opl3_chip *chips = new OPL::NUKED::opl3_chip[2];
+		int16 *samples = new int16[2 * 2 * blockSamples];
+
+		for (int i = 0; i < 2; ++i) {
+			OPL3_Reset(&chips[i], 49716);
+			if (opl3)
+				OPL3_WriteReg(&chips[i], 0x105, 0x01);
+		}
+
+		Common::XorShiftRandom rnd(0x6C078965);
+		for (int block = 0; block < blocks; ++block) {
+			const Common::XorShiftRandom blockRnd = rnd;
+			for (int i = 0; i < 2; ++i) {
+				rnd = blockRnd;
+				writeRandomRegisters(rnd, &chips[i], opl3);
+
+				OPL::NUKED::OPL::setSIMD(switching ? ((block ^ i) & 1) : i);
+				for (int j = 0; j < blockSamples; ++j)
+					OPL3_Generate(&chips[i], samples + (i * blockSamples + j) * 2);
+			}
+
+			TS_ASSERT_SAME_DATA(samples, samples + 2 * blockSamples, 2 * blockSamples * sizeof(int16));
+		}
+
+		delete[] samples;
+		delete[] chips;
+	}
+#else
+	void checkGenerate(bool opl3, bool switching) {
+	}
+#endif // !DISABLE_NUKED_OPL
+
+public:
+	void tearDown() {
+#ifndef DISABLE_NUKED_OPL
+		OPL::NUKED::OPL::setSIMD(true);
+#endif
+	}
+
+	void test_generate_opl2() {
+		checkGenerate(false, false);
+	}
+
+	void test_generate_opl3() {
+		checkGenerate(true, false);
+	}
+
+	void test_generate_switching() {
+		checkGenerate(true, true);
+	}
+};
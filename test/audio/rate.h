@@ -0,0 +1,129 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	/**
+	 * Straightforward per-sample implementation of the mixing done by the
+	 * rate converters, used as reference for the optimized code paths.
+	 */
+	static int referenceFlow(const int16 *in, int inFrames, bool isStereo, bool reverseStereo,
+	                         int inRate, int outRate, int16 *out, int outFrames, int volL, int volR) {
+		const bool interpolate = (inRate != outRate) && ((inRate % outRate) != 0 || inRate >= 65536);
+		const int step = isStereo ? 2 : 1;
+		int produced = 0;
+
+		if (!interpolate) {
+			// The copy converter starts with the first, the simple one with
+			// the second input frame.
+			const int inc = inRate / outRate;
+			for (int i = (inc == 1) ? 0 : 1; i < inFrames && produced < outFrames; i += inc, ++produced) {
+				const int16 out0 = in[i * step];
+				const int16 out1 = in[i * step + step - 1];
+				Audio::clampedAdd(out[produced * 2 + (reverseStereo ? 1 : 0)], (out0 * volL) / Audio::Mixer::kMaxMixerVolume);
+				Audio::clampedAdd(out[produced * 2 + (reverseStereo ? 0 : 1)], (out1 * volR) / Audio::Mixer::kMaxMixerVolume);
+			}
+			return produced;
+		}
+
+		const int fracOne = 1 << 15;
+		const int inc = (int)(((uint32)inRate << 15) / outRate);
+		int pos = fracOne;
+		int idx = 0;
+		int last0 = 0, last1 = 0, cur0 = 0, cur1 = 0;
+
+		while (produced < outFrames) {
+			while (pos >= fracOne) {
+				if (idx >= inFrames)
+					return produced;
+				last0 = cur0;
+				last1 = cur1;
+				cur0 = in[idx * step];
+				cur1 = in[idx * step + step - 1];
+				++idx;
+				pos -= fracOne;
+			}
+
+			while (pos < fracOne && produced < outFrames) {
+				const int16 out0 = (int16)(last0 + (((cur0 - last0) * pos + fracOne / 2) >> 15));
+				const int16 out1 = (int16)(last1 + (((cur1 - last1) * pos + fracOne / 2) >> 15));
+				Audio::clampedAdd(out[produced * 2 + (reverseStereo ? 1 : 0)], (out0 * volL) / Audio::Mixer::kMaxMixerVolume);
+				Audio::clampedAdd(out[produced * 2 + (reverseStereo ? 0 : 1)], (out1 * volR) / Audio::Mixer::kMaxMixerVolume);
+				++produced;
+				pos += inc;
+			}
+		}
+
+		return produced;
+	}
+
+	void compareWithReference(int inRate, int outRate, bool isStereo, bool reverseStereo, int volL, int volR) {
+		int16 *sine = 0;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, &sine, false, isStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, reverseStereo);
+
+		// Request a bit more than the stream holds so that the end of the
+		// input is hit as well. Prefill the output to exercise the clamping.
+		const int outFrames = outRate + 100;
+		int16 *expected = new int16[outFrames * 2];
+		int16 *actual = new int16[outFrames * 2];
+		for (int i = 0; i < outFrames * 2; ++i)
+			expected[i] = actual[i] = (int16)((i % 7) * 9000 - 27000);
+
+		const int expectedFrames = referenceFlow(sine, inRate, isStereo, reverseStereo, inRate, outRate, expected, outFrames, volL, volR);
+
+		// Feed the converter in odd sized chunks to test state carried over
+		// between calls.
+		int actualFrames = 0;
+		while (actualFrames < outFrames) {
+			const int chunk = MIN(outFrames - actualFrames, 333);
+			const int res = converter->flow(*s, actual + actualFrames * 2, chunk, volL, volR);
+			actualFrames += res;
+			if (res < chunk)
+				break;
+		}
+
+		TS_ASSERT_EQUALS(actualFrames, expectedFrames);
+		TS_ASSERT_EQUALS(memcmp(expected, actual, outFrames * 2 * sizeof(int16)), 0);
+
+		delete[] expected;
+		delete[] actual;
+		delete[] sine;
+		delete converter;
+		delete s;
+	}
+
+	void compareAllChannelLayouts(int inRate, int outRate) {
+		compareWithReference(inRate, outRate, false, false, 256, 256);
+		compareWithReference(inRate, outRate, false, false, 77, 200);
+		compareWithReference(inRate, outRate, true, false, 256, 256);
+		compareWithReference(inRate, outRate, true, false, 13, 255);
+		compareWithReference(inRate, outRate, true, true, 256, 256);
+		compareWithReference(inRate, outRate, true, true, 129, 3);
+	}
+
+public:
+	void test_copy_converter() {
+		compareAllChannelLayouts(22050, 22050);
+	}
+
+	void test_simple_converter() {
+		compareAllChannelLayouts(44100, 22050);
+	}
+
+	void test_linear_converter_upsample() {
+		compareAllChannelLayouts(11025, 44100);
+		compareAllChannelLayouts(22050, 48000);
+	}
+
+	void test_linear_converter_downsample() {
+		compareAllChannelLayouts(48000, 44100);
+		compareAllChannelLayouts(96000, 22050);
+	}
+};
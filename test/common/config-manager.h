@@ -0,0 +1,31 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/config-manager.h"
+
+class ConfigManagerTestSuite : public CxxTest::TestSuite {
+public:
+	void test_domain_references() {
+		// Callers keep the references returned by ConfMan.get() while
+		// they add more entries, so these must stay valid.
+		Common::ConfigManager::Domain domain;
+		domain.setVal("path", "/games/monkey");
+		const Common::String &path = domain.getVal("path");
+		const Common::String *const address = &path;
+
+		for (int i = 0; i < 1000; ++i)
+			domain.setVal(Common::String::format("key%d", i), "value");
+
+		TS_ASSERT_EQUALS(&domain.getVal("path"), address);
+		TS_ASSERT_EQUALS(path, "/games/monkey");
+	}
+
+	void test_domain_copy_entry() {
+		// The value is read from the map while inserting into it
+		Common::ConfigManager::Domain domain;
+		domain.setVal("key0", "first");
+		for (int i = 1; i < 1000; ++i)
+			domain.setVal(Common::String::format("key%d", i), domain.getVal(Common::String::format("key%d", i - 1)));
+
+		TS_ASSERT_EQUALS(domain.getVal("key999"), "first");
+	}
+};
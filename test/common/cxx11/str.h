@@ -0,0 +1,35 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/str.h"
+
+// Only built with C++11, see test/module.mk
+class StringMoveTestSuite : public CxxTest::TestSuite {
+public:
+	void test_move() {
+		// using internal storage
+		Common::String foo1("foo");
+		Common::String foo2(static_cast<Common::String &&>(foo1));
+		TS_ASSERT_EQUALS(foo2, "foo");
+		TS_ASSERT(foo1.empty());
+
+		// using external storage, shared with another string
+		Common::String foo3("fooasdkadklasdjklasdjlkasjdlkasjdklasjdlkjasdasd");
+		Common::String foo4(foo3);
+		Common::String foo5(static_cast<Common::String &&>(foo4));
+		TS_ASSERT(foo4.empty());
+		TS_ASSERT(foo5.c_str() == foo3.c_str());
+		foo5 += 'X';
+		TS_ASSERT_EQUALS(foo3, "fooasdkadklasdjklasdjlkasjdlkasjdklasjdlkjasdasd");
+		TS_ASSERT_EQUALS(foo5, "fooasdkadklasdjklasdjlkasjdlkasjdklasjdlkjasdasd""X");
+
+		foo1 = static_cast<Common::String &&>(foo5);
+		TS_ASSERT(foo5.empty());
+		TS_ASSERT_EQUALS(foo1, "fooasdkadklasdjklasdjlkasjdlkasjdklasjdlkjasdasd""X");
+		foo1 = static_cast<Common::String &&>(foo2);
+		TS_ASSERT_EQUALS(foo1, "foo");
+
+		// Moved-from strings can be used again
+		foo2 = "bar";
+		TS_ASSERT_EQUALS(foo2, "bar");
+	}
+};
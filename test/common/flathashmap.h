@@ -0,0 +1,182 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flathashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		FlatStringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT(!container2.contains("foo"));
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		FlatStringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("FOO"));
+		TS_ASSERT(container2.contains("quux"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(container.find(1));
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(container.find(1));
+		container.erase(2);
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(4));
+		TS_ASSERT(container.empty());
+		TS_ASSERT_EQUALS(container.find(4), container.end());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+
+		// We take a const ref now to ensure that the map
+		// is not modified by getVal.
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getVal(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(1), -1);
+		TS_ASSERT_EQUALS(containerRef.getVal(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getVal(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(17, -10), -10);
+		TS_ASSERT_EQUALS(containerRef.size(), 3u);
+	}
+
+	void test_hash_map_copy() {
+		FlatStringMap map1, container2;
+		map1["foo"] = "bar";
+		map1["quux"] = "blub";
+		map1.erase("quux");
+		container2 = map1;
+		TS_ASSERT_EQUALS(container2["foo"], "bar");
+		TS_ASSERT(!container2.contains("quux"));
+
+		FlatStringMap container3(container2);
+		container2["foo"] = "changed";
+		TS_ASSERT_EQUALS(container3["foo"], "bar");
+		TS_ASSERT_EQUALS(container3.size(), 1u);
+	}
+
+	void test_collision() {
+		// Keys with the same slot for small tables
+		Common::FlatHashMap<int, int> h;
+		h[5] = 1;
+		h[32+5] = 2;
+		h[64+5] = 3;
+		h[128+5] = 4;
+		h.erase(32+5);
+		TS_ASSERT(h.contains(5));
+		TS_ASSERT(h.contains(64+5));
+		TS_ASSERT(h.contains(128+5));
+		h.erase(5);
+		TS_ASSERT_EQUALS(h[64+5], 3);
+		TS_ASSERT_EQUALS(h[128+5], 4);
+		h[32+5] = 5;
+		h[5] = 6;
+		TS_ASSERT_EQUALS(h[5], 6);
+		TS_ASSERT_EQUALS(h[32+5], 5);
+		TS_ASSERT_EQUALS(h.size(), 4u);
+		h.erase(5);
+		h.erase(64+5);
+		h.erase(128+5);
+		h.erase(32+5);
+		TS_ASSERT(h.empty());
+	}
+
+	void test_erase_while_iterating() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; ++i)
+			container[i] = i * 2;
+
+		int visited = 0;
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			TS_ASSERT_EQUALS(i->_value, i->_key * 2);
+			++visited;
+			if (i->_key % 3)
+				container.erase(i);
+		}
+		TS_ASSERT_EQUALS(visited, 100);
+		TS_ASSERT_EQUALS(container.size(), 34u);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		for (j = container.begin(); j != container.end(); ++j) {
+			TS_ASSERT_EQUALS(j->_key % 3, 0);
+			++found;
+		}
+		TS_ASSERT_EQUALS(found, 34);
+	}
+
+	void test_against_hashmap() {
+		// Run a long sequence of random operations on both maps
+		Common::HashMap<int, int> reference;
+		Common::FlatHashMap<int, int> container;
+		uint32 seed = 1;
+		for (int i = 0; i < 20000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const int key = (seed >> 16) % 500;
+			switch ((seed >> 8) % 3) {
+			case 0:
+				reference.erase(key);
+				container.erase(key);
+				break;
+			default:
+				reference[key] = i;
+				container[key] = i;
+				break;
+			}
+			TS_ASSERT_EQUALS(container.size(), reference.size());
+		}
+
+		for (int key = 0; key < 500; ++key) {
+			TS_ASSERT_EQUALS(container.contains(key), reference.contains(key));
+			TS_ASSERT_EQUALS(container.getVal(key, -1), reference.getVal(key, -1));
+		}
+	}
+};
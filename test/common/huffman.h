@@ -2,6 +2,7 @@
 #include "common/huffman.h"
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/random.h"
 
 /**
 * A test suite for the Huffman decoder in common/huffman.h
@@ -141,4 +142,146 @@ class HuffmanTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[5]);
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[6]);
 	}
-};
+
+	void test_long_codes_msb() {
+		LongCodeSet set(true);
+		Common::Huffman h(0, set.count, set.codes, set.lengths, set.symbols);
+
+		Common::Array<byte> data;
+		Common::Array<uint32> expected;
+		set.encode(data, expected);
+
+		Common::MemoryReadStream ms32(data.begin(), data.size());
+		Common::BitStream32BEMSB bs32(ms32);
+		Common::MemoryReadStream ms8(data.begin(), data.size());
+		Common::BitStream8MSB bs8(ms8);
+		Common::MemoryReadStream msPlain(data.begin(), data.size());
+		Common::BitStream8MSB bsPlain(msPlain);
+
+		checkDecode(set, h, expected, bs32, bs8, bsPlain);
+	}
+
+	void test_long_codes_lsb() {
+		LongCodeSet set(false);
+		Common::Huffman h(0, set.count, set.codes, set.lengths, set.symbols);
+
+		Common::Array<byte> data;
+		Common::Array<uint32> expected;
+		set.encode(data, expected);
+
+		Common::MemoryReadStream ms32(data.begin(), data.size());
+		Common::BitStream32LELSB bs32(ms32);
+		Common::MemoryReadStream ms8(data.begin(), data.size());
+		Common::BitStream8LSB bs8(ms8);
+		Common::MemoryReadStream msPlain(data.begin(), data.size());
+		Common::BitStream8LSB bsPlain(msPlain);
+
+		checkDecode(set, h, expected, bs32, bs8, bsPlain);
+	}
+
+private:
+	/**
+	 * A canonical code of 406 symbols with lengths of up to 20 bits, so the
+	 * decoder needs several levels of lookup tables. The codes are bit
+	 * reversed for LSB first streams, to keep them prefix free.
+	 */
+	struct LongCodeSet {
+		enum { kMaxCount = 406, kSymbolCount = 20000 };
+
+		uint32 count;
+		uint32 codes[kMaxCount];
+		uint8 lengths[kMaxCount];
+		uint32 symbols[kMaxCount];
+		bool msbFirst;
+		uint32 bitCount;
+
+		LongCodeSet(bool msb) : count(0), msbFirst(msb), bitCount(0) {
+			static const uint16 lengthCounts[][2] = { { 2, 2 }, { 4, 4 }, { 7, 16 }, { 10, 64 }, { 14, 256 }, { 20, 64 } };
+
+			uint32 code = 0;
+			uint8 lastLength = lengthCounts[0][0];
+			for (int i = 0; i < ARRAYSIZE(lengthCounts); i++) {
+				code <<= lengthCounts[i][0] - lastLength;
+				lastLength = lengthCounts[i][0];
+
+				for (int j = 0; j < lengthCounts[i][1]; j++, code++) {
+					lengths[count] = lastLength;
+					codes[count] = msb ? code : reverse(code, lastLength);
+					symbols[count] = count * 3 + 1;
+					count++;
+				}
+			}
+		}
+
+		static uint32 reverse(uint32 code, uint8 length) {
+			uint32 result = 0;
+			for (uint8 i = 0; i < length; i++)
+				result |= ((code >> i) & 1) << (length - 1 - i);
+			return result;
+		}
+
+		/** Encode pseudo random symbols, favouring the short codes. */
+		void encode(Common::Array<byte> &data, Common::Array<uint32> &expected) {
+			Common::XorShiftRandom rnd(0x13579BDF);
+			for (int i = 0; i < kSymbolCount; i++) {
+				const uint32 r = rnd.next();
+				const uint32 index = (r & 1) ? (r >> 1) % 6 : (r >> 1) % count;
+
+				expected.push_back(symbols[index]);
+				for (uint8 j = 0; j < lengths[index]; j++) {
+					const uint32 bit = msbFirst ? (codes[index] >> (lengths[index] - 1 - j)) & 1 : (codes[index] >> j) & 1;
+					if ((bitCount & 7) == 0)
+						data.push_back(0);
+					if (bit)
+						data.back() |= msbFirst ? (0x80 >> (bitCount & 7)) : (1 << (bitCount & 7));
+					bitCount++;
+				}
+			}
+
+			// Whole 32 bit values only
+			while (data.size() & 3)
+				data.push_back(0);
+		}
+
+		/**
+		 * Decode a symbol one bit at a time, comparing against all codes of
+		 * the length read so far, like Common::Huffman did before it had
+		 * lookup tables.
+		 */
+		template<class BITSTREAM>
+		uint32 decodePlain(BITSTREAM &bits) const {
+			uint32 code = 0;
+			for (uint8 length = 1; length <= 32; length++) {
+				bits.addBit(code, length - 1);
+				for (uint32 i = 0; i < count; i++)
+					if (lengths[i] == length && codes[i] == code)
+						return symbols[i];
+			}
+			return 0xFFFFFFFF;
+		}
+	};
+
+	/**
+	 * Decode all symbols with the lookup tables from 32 bit and 8 bit
+	 * streams, and bit by bit, checking that all of them agree.
+	 */
+	template<class BITSTREAM32, class BITSTREAM8>
+	static void checkDecode(const LongCodeSet &set, const Common::Huffman &h, const Common::Array<uint32> &expected,
+	                        BITSTREAM32 &bs32, BITSTREAM8 &bs8, BITSTREAM8 &bsPlain) {
+		// Stop at the first mismatch, instead of failing thousands of times
+		for (uint i = 0; i < expected.size(); i++) {
+			const uint32 plain = set.decodePlain(bsPlain);
+			if (plain != expected[i]) {
+				TS_FAIL("Wrong symbol decoded bit by bit");
+				break;
+			}
+			if (h.getSymbol(bs32) != plain || h.getSymbol(bs8) != plain) {
+				TS_FAIL("Lookup tables decoded a different symbol");
+				break;
+			}
+		}
+		TS_ASSERT_EQUALS(bs32.pos(), set.bitCount);
+		TS_ASSERT_EQUALS(bs8.pos(), set.bitCount);
+		TS_ASSERT_EQUALS(bsPlain.pos(), set.bitCount);
+	}
+};
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/spscqueue.h"
+
+class SPSCQueueTestSuite : public CxxTest::TestSuite {
+public:
+	void test_empty_full() {
+		Common::SPSCQueue<int, 4> queue;
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.full());
+		TS_ASSERT_EQUALS(queue.size(), 0u);
+
+		TS_ASSERT(queue.push(1));
+		TS_ASSERT(queue.push(2));
+		TS_ASSERT(queue.push(3));
+		TS_ASSERT(!queue.empty());
+		TS_ASSERT(!queue.full());
+
+		TS_ASSERT(queue.push(4));
+		TS_ASSERT(queue.full());
+		TS_ASSERT_EQUALS(queue.size(), 4u);
+
+		// Pushing into a full queue fails and leaves it intact
+		TS_ASSERT(!queue.push(5));
+		TS_ASSERT_EQUALS(queue.size(), 4u);
+	}
+
+	void test_push_pop() {
+		Common::SPSCQueue<int, 4> queue;
+		int value = 0;
+
+		TS_ASSERT(!queue.pop(value));
+
+		queue.push(42);
+		queue.push(-23);
+
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, 42);
+		TS_ASSERT(queue.pop(value));
+		TS_ASSERT_EQUALS(value, -23);
+
+		TS_ASSERT(!queue.pop(value));
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_peek() {
+		Common::SPSCQueue<int, 4> queue;
+		int value = 0;
+
+		TS_ASSERT(!queue.peek(value));
+
+		queue.push(7);
+		queue.push(8);
+
+		// Peeking does not remove the element
+		TS_ASSERT(queue.peek(value));
+		TS_ASSERT_EQUALS(value, 7);
+		TS_ASSERT(queue.peek(value));
+		TS_ASSERT_EQUALS(value, 7);
+		TS_ASSERT_EQUALS(queue.size(), 2u);
+
+		queue.pop(value);
+		TS_ASSERT(queue.peek(value));
+		TS_ASSERT_EQUALS(value, 8);
+	}
+
+	void test_wrap_around() {
+		Common::SPSCQueue<int, 4> queue;
+		int value = 0;
+
+		// Cycle through the storage several times, keeping up to three
+		// elements queued.
+		int next = 0, expected = 0;
+		for (int round = 0; round < 10; ++round) {
+			while (queue.size() < 3)
+				TS_ASSERT(queue.push(next++));
+
+			TS_ASSERT(queue.pop(value));
+			TS_ASSERT_EQUALS(value, expected++);
+			TS_ASSERT(queue.pop(value));
+			TS_ASSERT_EQUALS(value, expected++);
+		}
+
+		while (queue.pop(value))
+			TS_ASSERT_EQUALS(value, expected++);
+		TS_ASSERT_EQUALS(expected, next);
+	}
+};
@@ -152,23 +152,23 @@ class StringTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(foo2, "3456789012");
 
 		// "foo3" and "foo4" will be using allocated storage from construction on.
-		Common::String foo3("12345678901234567890123456789012");
+		Common::String foo3("123456789012345678901234567890123456789012345678");
 		foo3 += foo3.c_str();
-		TS_ASSERT_EQUALS(foo3, "12345678901234567890123456789012""12345678901234567890123456789012");
+		TS_ASSERT_EQUALS(foo3, "123456789012345678901234567890123456789012345678""123456789012345678901234567890123456789012345678");
 
-		Common::String foo4("12345678901234567890123456789012");
+		Common::String foo4("123456789012345678901234567890123456789012345678");
 		foo4 += foo4;
-		TS_ASSERT_EQUALS(foo4, "12345678901234567890123456789012""12345678901234567890123456789012");
+		TS_ASSERT_EQUALS(foo4, "123456789012345678901234567890123456789012345678""123456789012345678901234567890123456789012345678");
 
 		// Based on our current Common::String implementation "foo5" and "foo6" will first use the internal storage,
 		// and on "operator +=" they will change to allocated memory.
-		Common::String foo5("123456789012");
+		Common::String foo5("12345678901234567890");
 		foo5 += foo5.c_str();
-		TS_ASSERT_EQUALS(foo5, "123456789012""123456789012");
+		TS_ASSERT_EQUALS(foo5, "12345678901234567890""12345678901234567890");
 
-		Common::String foo6("123456789012");
+		Common::String foo6("12345678901234567890");
 		foo6 += foo6;
-		TS_ASSERT_EQUALS(foo6, "123456789012""123456789012");
+		TS_ASSERT_EQUALS(foo6, "12345678901234567890""12345678901234567890");
 
 		// "foo7" and "foo8" will purely operate on internal storage.
 		Common::String foo7("1234");
@@ -192,6 +192,13 @@ class StringTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(foo10, "1234");
 	}
 
+	void test_concat_temporary() {
+		Common::String foo("foo");
+		Common::String bar = foo + "0123456789abcdefghijk" + foo + '!' + Common::String("0123456789abcdefghijk");
+		TS_ASSERT_EQUALS(bar, "foo0123456789abcdefghijkfoo!0123456789abcdefghijk");
+		TS_ASSERT_EQUALS(foo, "foo");
+	}
+
 	void test_hasPrefix() {
 		Common::String str("this/is/a/test, haha");
 		TS_ASSERT_EQUALS(str.hasPrefix(""), true);
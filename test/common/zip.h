@@ -0,0 +1,254 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+
+#include "backends/fs/abstract-fs.h"
+
+class ZipArchiveTestSuite : public CxxTest::TestSuite {
+	static uint32 crc32(const char *data) {
+		uint32 crc = 0xFFFFFFFF;
+		for (; *data; ++data) {
+			crc ^= (byte)*data;
+			for (int i = 0; i < 8; ++i)
+				crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320 : 0);
+		}
+		return ~crc;
+	}
+
+	// Write a ZIP archive with uncompressed files
+	static Common::SeekableReadStream *createArchive(const char *const *names, const char *const *contents, int count) {
+		Common::MemoryWriteStreamDynamic zip(DisposeAfterUse::NO);
+		uint32 offsets[8];
+
+		for (int i = 0; i < count; ++i) {
+			offsets[i] = zip.pos();
+			zip.writeUint32LE(0x04034b50);
+			zip.writeUint16LE(10);                  // version needed
+			zip.writeUint16LE(0);                   // flags
+			zip.writeUint16LE(0);                   // stored
+			zip.writeUint32LE(0);                   // date/time
+			zip.writeUint32LE(crc32(contents[i]));
+			zip.writeUint32LE(strlen(contents[i])); // compressed size
+			zip.writeUint32LE(strlen(contents[i])); // uncompressed size
+			zip.writeUint16LE(strlen(names[i]));
+			zip.writeUint16LE(2);                   // extra field length
+			zip.write(names[i], strlen(names[i]));
+			zip.writeUint16LE(0);                   // extra field
+			zip.write(contents[i], strlen(contents[i]));
+		}
+
+		const uint32 centralDirOffset = zip.pos();
+		for (int i = 0; i < count; ++i) {
+			zip.writeUint32LE(0x02014b50);
+			zip.writeUint16LE(10);                  // version made by
+			zip.writeUint16LE(10);                  // version needed
+			zip.writeUint16LE(0);                   // flags
+			zip.writeUint16LE(0);                   // stored
+			zip.writeUint32LE(0);                   // date/time
+			zip.writeUint32LE(crc32(contents[i]));
+			zip.writeUint32LE(strlen(contents[i])); // compressed size
+			zip.writeUint32LE(strlen(contents[i])); // uncompressed size
+			zip.writeUint16LE(strlen(names[i]));
+			zip.writeUint16LE(0);                   // extra field length
+			zip.writeUint16LE(0);                   // comment length
+			zip.writeUint16LE(0);                   // disk number
+			zip.writeUint16LE(0);                   // internal attributes
+			zip.writeUint32LE(0);                   // external attributes
+			zip.writeUint32LE(offsets[i]);
+			zip.write(names[i], strlen(names[i]));
+		}
+		const uint32 centralDirSize = zip.pos() - centralDirOffset;
+
+		zip.writeUint32LE(0x06054b50);
+		zip.writeUint16LE(0);                       // disk number
+		zip.writeUint16LE(0);                       // disk with central dir
+		zip.writeUint16LE(count);
+		zip.writeUint16LE(count);
+		zip.writeUint32LE(centralDirSize);
+		zip.writeUint32LE(centralDirOffset);
+		zip.writeUint16LE(0);                       // comment length
+
+		return new Common::MemoryReadStream(zip.getData(), zip.size(), DisposeAfterUse::YES);
+	}
+
+	static Common::String readAll(Common::SeekableReadStream *stream) {
+		Common::String result;
+		while (true) {
+			const byte b = stream->readByte();
+			if (stream->eos())
+				break;
+			result += (char)b;
+		}
+		return result;
+	}
+
+	/** Stream of a MemoryFSNode, counting the open ones */
+	class CountedStream : public Common::MemoryReadStream {
+		int &_openCount;
+
+	public:
+		CountedStream(const byte *data, uint32 size, int &openCount) : Common::MemoryReadStream(data, size), _openCount(openCount) {
+			++_openCount;
+		}
+
+		~CountedStream() {
+			--_openCount;
+		}
+	};
+
+	/** A file in memory, standing in for a file on disk */
+	class MemoryFSNode : public AbstractFSNode {
+		byte *_data;
+		uint32 _size;
+		int &_openCount;
+
+	public:
+		MemoryFSNode(Common::SeekableReadStream *file, int &openCount) : _openCount(openCount) {
+			_size = file->size();
+			_data = new byte[_size];
+			file->read(_data, _size);
+			delete file;
+		}
+
+		~MemoryFSNode() {
+			delete[] _data;
+		}
+
+		virtual bool exists() const { return true; }
+		virtual bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const { return false; }
+		virtual Common::String getName() const { return "test.zip"; }
+		virtual Common::String getPath() const { return "test.zip"; }
+		virtual bool isDirectory() const { return false; }
+		virtual bool isReadable() const { return true; }
+		virtual bool isWritable() const { return false; }
+		virtual Common::WriteStream *createWriteStream() { return nullptr; }
+		virtual bool create(bool isDirectoryFlag) { return false; }
+
+		virtual Common::SeekableReadStream *createReadStream() {
+			return new CountedStream(_data, _size, _openCount);
+		}
+
+	protected:
+		virtual AbstractFSNode *getChild(const Common::String &name) const { return nullptr; }
+		virtual AbstractFSNode *getParent() const { return nullptr; }
+	};
+
+public:
+	void test_lookup() {
+		const char *names[] = { "readme.txt", "Data/Level1.DAT" };
+		const char *contents[] = { "Hello", "level data" };
+		Common::Archive *archive = Common::makeZipArchive(createArchive(names, contents, 2));
+		TS_ASSERT(archive);
+
+		TS_ASSERT(archive->hasFile("readme.txt"));
+		TS_ASSERT(archive->hasFile("README.TXT"));
+		TS_ASSERT(archive->hasFile("data/level1.dat"));
+		TS_ASSERT(!archive->hasFile("level1.dat"));
+		TS_ASSERT(!archive->hasFile("missing"));
+		TS_ASSERT(!archive->createReadStreamForMember("missing"));
+
+		Common::ArchiveMemberList members;
+		TS_ASSERT_EQUALS(archive->listMembers(members), 2);
+
+		delete archive;
+	}
+
+	void test_stored_files() {
+		const char *names[] = { "a.txt", "b.txt", "empty" };
+		const char *contents[] = { "first file", "the second file", "" };
+		Common::Archive *archive = Common::makeZipArchive(createArchive(names, contents, 3));
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *a = archive->createReadStreamForMember("A.TXT");
+		Common::SeekableReadStream *b = archive->createReadStreamForMember("b.txt");
+		Common::SeekableReadStream *empty = archive->createReadStreamForMember("empty");
+		TS_ASSERT(a && b && empty);
+		TS_ASSERT_EQUALS(a->size(), 10);
+		TS_ASSERT_EQUALS(b->size(), 15);
+		TS_ASSERT_EQUALS(empty->size(), 0);
+
+		// Interleaved reads and seeks must not affect each other
+		char buffer[4];
+		TS_ASSERT_EQUALS(a->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "firs");
+		TS_ASSERT_EQUALS(b->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "the ");
+		a->seek(-4, SEEK_END);
+		TS_ASSERT_EQUALS(a->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "file");
+		TS_ASSERT_EQUALS(b->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "seco");
+
+		// The streams remain usable after the archive is gone
+		delete archive;
+		b->seek(0);
+		TS_ASSERT_EQUALS(readAll(b), "the second file");
+		a->seek(0);
+		TS_ASSERT_EQUALS(readAll(a), "first file");
+		TS_ASSERT_EQUALS(readAll(empty), "");
+
+		delete a;
+		delete b;
+		delete empty;
+	}
+
+	void test_stored_files_from_node() {
+		const char *names[] = { "a.txt", "b.txt" };
+		const char *contents[] = { "first file", "the second file" };
+		int openCount = 0;
+		const Common::FSNode node = AbstractFSNode::makeFSNode(new MemoryFSNode(createArchive(names, contents, 2), openCount));
+
+		// Archives opened from a file reopen it for each stored file
+		Common::Archive *archive = Common::makeZipArchive(node);
+		TS_ASSERT(archive);
+		TS_ASSERT_EQUALS(openCount, 1);
+
+		const int count = 40;
+		Common::SeekableReadStream *streams[count];
+		for (int i = 0; i < count; ++i) {
+			streams[i] = archive->createReadStreamForMember((i & 1) ? "b.txt" : "a.txt");
+			TS_ASSERT(streams[i]);
+		}
+
+		// Only some of them got a handle of their own, the others are
+		// copies in memory
+		TS_ASSERT_LESS_THAN(2, openCount);
+		TS_ASSERT_LESS_THAN(openCount, count + 1);
+
+		// Interleaved reads and seeks must not affect each other
+		char buffer[4];
+		TS_ASSERT_EQUALS(streams[0]->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "firs");
+		TS_ASSERT_EQUALS(streams[1]->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "the ");
+		streams[0]->seek(-4, SEEK_END);
+		TS_ASSERT_EQUALS(streams[0]->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "file");
+		TS_ASSERT_EQUALS(streams[1]->read(buffer, 4), 4u);
+		TS_ASSERT_EQUALS(Common::String(buffer, 4), "seco");
+
+		// The streams remain usable after the archive is gone
+		delete archive;
+		for (int i = 0; i < count; ++i) {
+			streams[i]->seek(0);
+			TS_ASSERT_EQUALS(readAll(streams[i]), (i & 1) ? "the second file" : "first file");
+		}
+
+		for (int i = 0; i < count; ++i)
+			delete streams[i];
+		TS_ASSERT_EQUALS(openCount, 0);
+
+		// Closed handles are available to new streams again
+		archive = Common::makeZipArchive(node);
+		TS_ASSERT(archive);
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("a.txt");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(openCount, 2);
+		TS_ASSERT_EQUALS(readAll(stream), "first file");
+		delete stream;
+		delete archive;
+	}
+};
@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "engines/filepropertiescache.h"
+
+/**
+ * Test suite for the entries of the FilePropertiesCache in
+ * engines/filepropertiescache.h, and their storage.
+ */
+class FilePropertiesCacheTestSuite : public CxxTest::TestSuite {
+	static FileProperties makeProperties(int32 size, const char *md5) {
+		FileProperties props;
+		props.size = size;
+		props.md5 = md5;
+		return props;
+	}
+
+public:
+	void test_lookup() {
+		FilePropertiesCache cache;
+		FileProperties props;
+
+		TS_ASSERT(!cache.lookup("5000:/games/monkey/000.lfl", 1234, 99, props));
+
+		cache.store("5000:/games/monkey/000.lfl", 1234, 99, makeProperties(1234, "0123456789abcdef0123456789abcdef"));
+		TS_ASSERT(cache.lookup("5000:/games/monkey/000.lfl", 1234, 99, props));
+		TS_ASSERT_EQUALS(props.size, 1234);
+		TS_ASSERT_EQUALS(props.md5, "0123456789abcdef0123456789abcdef");
+
+		// Another checksum length is another entry
+		TS_ASSERT(!cache.lookup("0:/games/monkey/000.lfl", 1234, 99, props));
+	}
+
+	void test_invalidation() {
+		FilePropertiesCache cache;
+		FileProperties props;
+
+		cache.store("5000:/games/sq3/resource.map", 3000, 100, makeProperties(3000, "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"));
+
+		// The file was replaced or changed
+		TS_ASSERT(!cache.lookup("5000:/games/sq3/resource.map", 3000, 101, props));
+		TS_ASSERT(!cache.lookup("5000:/games/sq3/resource.map", 3001, 100, props));
+
+		cache.store("5000:/games/sq3/resource.map", 3001, 101, makeProperties(3001, "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb"));
+		TS_ASSERT(!cache.lookup("5000:/games/sq3/resource.map", 3000, 100, props));
+		TS_ASSERT(cache.lookup("5000:/games/sq3/resource.map", 3001, 101, props));
+		TS_ASSERT_EQUALS(props.size, 3001);
+		TS_ASSERT_EQUALS(props.md5, "bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbb");
+		TS_ASSERT_EQUALS(cache.size(), 1U);
+	}
+
+	void test_load_store() {
+		FilePropertiesCache cache;
+		cache.store("5000:/games/a", 10, 1, makeProperties(10, "11111111111111111111111111111111"));
+		cache.store("5000:/games/b", 20, 2, makeProperties(20, "22222222222222222222222222222222"));
+		cache.store("0:/games/c", 30, 3, makeProperties(30, "33333333333333333333333333333333"));
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		cache.saveTo(out);
+
+		// Entries already in memory are newer than the ones on disk
+		FilePropertiesCache loaded;
+		loaded.store("5000:/games/b", 21, 5, makeProperties(21, "44444444444444444444444444444444"));
+
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(loaded.loadFrom(in));
+		TS_ASSERT_EQUALS(loaded.size(), 3U);
+
+		FileProperties props;
+		TS_ASSERT(loaded.lookup("5000:/games/a", 10, 1, props));
+		TS_ASSERT_EQUALS(props.size, 10);
+		TS_ASSERT_EQUALS(props.md5, "11111111111111111111111111111111");
+		TS_ASSERT(loaded.lookup("0:/games/c", 30, 3, props));
+		TS_ASSERT_EQUALS(props.md5, "33333333333333333333333333333333");
+		TS_ASSERT(!loaded.lookup("5000:/games/b", 20, 2, props));
+		TS_ASSERT(loaded.lookup("5000:/games/b", 21, 5, props));
+		TS_ASSERT_EQUALS(props.md5, "44444444444444444444444444444444");
+	}
+
+	void test_load_invalid() {
+		static const byte data[] = { 'F', 'P', 'C', 'H', 0, 0, 0, 1, 0, 0, 0, 0 };
+		Common::MemoryReadStream in(data, sizeof(data));
+
+		FilePropertiesCache cache;
+		TS_ASSERT(!cache.loadFrom(in));
+		TS_ASSERT_EQUALS(cache.size(), 0U);
+	}
+
+	void test_prune() {
+		FilePropertiesCache cache;
+		FileProperties props;
+		const FileProperties stored = makeProperties(1, "00000000000000000000000000000000");
+
+		// Fill the cache until the least recently used entries are dropped,
+		// keeping the first one in use
+		uint count = 0;
+		uint size = 0;
+		while (cache.size() > size || count < 2) {
+			size = cache.size();
+			cache.store(Common::String::format("0:/games/%u", count), count, 0, stored);
+			count++;
+			TS_ASSERT(cache.lookup("0:/games/0", 0, 0, props));
+			if (count > 1000000) {
+				TS_FAIL("The cache is not pruned");
+				return;
+			}
+		}
+
+		TS_ASSERT_LESS_THAN(cache.size(), size);
+		TS_ASSERT(cache.lookup("0:/games/0", 0, 0, props));
+		TS_ASSERT(!cache.lookup("0:/games/1", 1, 0, props));
+		TS_ASSERT(cache.lookup(Common::String::format("0:/games/%u", count - 1), count - 1, 0, props));
+		TS_ASSERT(cache.lookup(Common::String::format("0:/games/%u", count - 2), count - 2, 0, props));
+	}
+};
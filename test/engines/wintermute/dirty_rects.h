@@ -0,0 +1,175 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/random.h"
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+#include "engines/wintermute/base/gfx/osystem/render_ticket.h"
+#include "engines/wintermute/base/gfx/osystem/render_ticket_grid.h"
+
+/**
+ * Test suite for the dirty rect handling of the OSystem renderer in
+ * engines/wintermute/base/gfx/osystem.
+ */
+class DirtyRectsTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 640;
+	static const int kHeight = 480;
+
+	static bool isCovered(const Common::Array<Common::Rect> &rects, int x, int y) {
+		for (uint i = 0; i < rects.size(); i++) {
+			if (rects[i].contains(x, y)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+public:
+	void test_empty() {
+		Wintermute::DirtyRectContainer container;
+		container.setSize(kWidth, kHeight);
+
+		TS_ASSERT(container.isEmpty());
+		TS_ASSERT(container.getOptimized().empty());
+	}
+
+	void test_clipping() {
+		Wintermute::DirtyRectContainer container;
+		container.setSize(kWidth, kHeight);
+		const Common::Rect screen(kWidth, kHeight);
+
+		container.addDirtyRect(Common::Rect(kWidth, 0, kWidth + 50, 50), screen);
+		TS_ASSERT(container.isEmpty());
+
+		container.addDirtyRect(Common::Rect(-20, -20, 10, 10), Common::Rect(5, 5, 100, 100));
+		const Common::Array<Common::Rect> &rects = container.getOptimized();
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(5, 5, 10, 10));
+	}
+
+	void test_separate_rects() {
+		// Two small sprites at opposite ends of the screen must not cause
+		// everything between them to be redrawn
+		Wintermute::DirtyRectContainer container;
+		container.setSize(kWidth, kHeight);
+		const Common::Rect screen(kWidth, kHeight);
+
+		const Common::Rect topLeft(10, 12, 30, 40);
+		const Common::Rect bottomRight(590, 400, 630, 470);
+		container.addDirtyRect(topLeft, screen);
+		container.addDirtyRect(bottomRight, screen);
+
+		const Common::Array<Common::Rect> &rects = container.getOptimized();
+		TS_ASSERT_EQUALS(rects.size(), 2U);
+		TS_ASSERT_EQUALS(rects[0], topLeft);
+		TS_ASSERT_EQUALS(rects[1], bottomRight);
+	}
+
+	void test_merge_across_tiles() {
+		Wintermute::DirtyRectContainer container;
+		container.setSize(kWidth, kHeight);
+
+		const Common::Rect rect(16, 40, 300, 200);
+		container.addDirtyRect(rect, Common::Rect(kWidth, kHeight));
+
+		const Common::Array<Common::Rect> &rects = container.getOptimized();
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT_EQUALS(rects[0], rect);
+	}
+
+	void test_random_rects() {
+		// Whatever is merged, the result has to cover every dirty pixel
+		// exactly once, and nothing outside of the dirty rects' bounds
+		Common::XorShiftRandom rnd(0x1234567);
+		for (int round = 0; round < 50; round++) {
+			Wintermute::DirtyRectContainer container;
+			container.setSize(kWidth, kHeight);
+
+			Common::Array<Common::Rect> dirty;
+			const int count = 1 + rnd.next() % 8;
+			for (int i = 0; i < count; i++) {
+				const int x = rnd.next() % kWidth;
+				const int y = rnd.next() % kHeight;
+				const Common::Rect rect(x, y, MIN<int>(x + 1 + rnd.next() % 100, kWidth), MIN<int>(y + 1 + rnd.next() % 100, kHeight));
+				container.addDirtyRect(rect, Common::Rect(kWidth, kHeight));
+				dirty.push_back(rect);
+			}
+
+			Common::Rect bounds(dirty[0]);
+			for (uint i = 1; i < dirty.size(); i++) {
+				bounds.extend(dirty[i]);
+			}
+
+			const Common::Array<Common::Rect> &rects = container.getOptimized();
+			for (uint i = 0; i < rects.size(); i++) {
+				TS_ASSERT(bounds.contains(rects[i]));
+				for (uint j = i + 1; j < rects.size(); j++) {
+					TS_ASSERT(!rects[i].intersects(rects[j]));
+				}
+			}
+			for (int y = 0; y < kHeight; y++) {
+				for (int x = 0; x < kWidth; x++) {
+					if (isCovered(dirty, x, y) && !isCovered(rects, x, y)) {
+						TS_FAIL("Dirty pixel not covered");
+						return;
+					}
+				}
+			}
+		}
+	}
+
+	void test_many_rects() {
+		// Too many small rects fall back to their bounding rect
+		Wintermute::DirtyRectContainer container;
+		container.setSize(kWidth, kHeight);
+
+		for (int y = 0; y < kHeight; y += 32) {
+			for (int x = 0; x < kWidth; x += 32) {
+				container.addDirtyRect(Common::Rect(x, y, x + 2, y + 2), Common::Rect(kWidth, kHeight));
+			}
+		}
+
+		const Common::Array<Common::Rect> &rects = container.getOptimized();
+		TS_ASSERT_EQUALS(rects.size(), 1U);
+		TS_ASSERT_EQUALS(rects[0], Common::Rect(0, 0, kWidth - 30, kHeight - 30));
+	}
+
+	void test_ticket_grid() {
+		// Only the tickets touching a dirty rect are drawn, in queue order
+		Wintermute::RenderTicket tickets[4];
+		tickets[0]._dstRect = Common::Rect(kWidth, kHeight); // background
+		tickets[1]._dstRect = Common::Rect(10, 10, 50, 50);
+		tickets[2]._dstRect = Common::Rect(500, 300, 600, 400);
+		tickets[3]._dstRect = Common::Rect(40, 40, 520, 320);
+
+		Common::Array<Wintermute::RenderTicket *> drawList;
+		for (int i = 0; i < ARRAYSIZE(tickets); i++) {
+			drawList.push_back(&tickets[i]);
+		}
+
+		Wintermute::RenderTicketGrid grid;
+		grid.setSize(kWidth, kHeight);
+		grid.build(drawList);
+
+		Common::Array<uint> result;
+		grid.query(Common::Rect(0, 0, 20, 20), result);
+		TS_ASSERT_EQUALS(result.size(), 2U);
+		TS_ASSERT_EQUALS(result[0], 0U);
+		TS_ASSERT_EQUALS(result[1], 1U);
+
+		grid.query(Common::Rect(510, 310, 530, 330), result);
+		TS_ASSERT_EQUALS(result.size(), 3U);
+		TS_ASSERT_EQUALS(result[0], 0U);
+		TS_ASSERT_EQUALS(result[1], 2U);
+		TS_ASSERT_EQUALS(result[2], 3U);
+
+		// Tickets spanning several cells are only returned once, and ones
+		// sharing a cell without touching the rect not at all
+		grid.query(Common::Rect(60, 60, 400, 250), result);
+		TS_ASSERT_EQUALS(result.size(), 2U);
+		TS_ASSERT_EQUALS(result[0], 0U);
+		TS_ASSERT_EQUALS(result[1], 3U);
+
+		grid.query(Common::Rect(600, 440, 620, 460), result);
+		TS_ASSERT_EQUALS(result.size(), 1U);
+		TS_ASSERT_EQUALS(result[0], 0U);
+	}
+};
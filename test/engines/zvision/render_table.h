@@ -0,0 +1,79 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/random.h"
+#include "common/util.h"
+#include "graphics/surface.h"
+#include "engines/zvision/graphics/render_table.h"
+
+/**
+ * Test suite for the panorama and tilt warping of the ZVision engine.
+ */
+class RenderTableTestSuite : public CxxTest::TestSuite {
+	/**
+	 * Warp a random image with and without vector instructions, and
+	 * compare the results.
+	 */
+	void checkWarp(ZVision::RenderTable::RenderState state, ZVision::RenderTable::WarpFilter filter, const Graphics::PixelFormat &format, int width, int height) {
+		ZVision::RenderTable table(width, height);
+		table.setRenderState(state);
+		table.setPanoramaFoV(27.0f);
+		table.setPanoramaScale(0.55f);
+		table.setTiltFoV(21.0f);
+		table.setTiltScale(0.65f);
+		table.generateRenderTable();
+		table.setWarpFilter(filter);
+
+		Graphics::Surface source;
+		source.create(width, height, format);
+		Common::XorShiftRandom rnd(0x3C6EF372 + width);
+		uint16 *pixels = (uint16 *)source.getPixels();
+		for (int i = 0; i < width * height; ++i)
+			pixels[i] = rnd.next();
+
+		Graphics::Surface plain, vectorized;
+		plain.create(width, height, format);
+		vectorized.create(width, height, format);
+
+		ZVision::RenderTable::setSIMD(false);
+		table.mutateImage(&plain, &source);
+		ZVision::RenderTable::setSIMD(true);
+		table.mutateImage(&vectorized, &source);
+
+		TS_ASSERT_SAME_DATA(plain.getPixels(), vectorized.getPixels(), plain.pitch * plain.h);
+
+		source.free();
+		plain.free();
+		vectorized.free();
+	}
+
+	void checkFilter(ZVision::RenderTable::WarpFilter filter) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0)
+		};
+		// Sizes which leave pixels over for the eight and sixteen pixel
+		// loops, and a single row and column, for which bilinear filtering
+		// falls back to the nearest pixel
+		static const int sizes[][2] = { { 64, 48 }, { 61, 29 }, { 37, 13 }, { 40, 1 }, { 1, 40 } };
+
+		for (int f = 0; f < ARRAYSIZE(formats); ++f) {
+			for (int s = 0; s < ARRAYSIZE(sizes); ++s) {
+				checkWarp(ZVision::RenderTable::PANORAMA, filter, formats[f], sizes[s][0], sizes[s][1]);
+				checkWarp(ZVision::RenderTable::TILT, filter, formats[f], sizes[s][0], sizes[s][1]);
+			}
+		}
+	}
+
+public:
+	void tearDown() {
+		ZVision::RenderTable::setSIMD(true);
+	}
+
+	void test_nearest() {
+		checkFilter(ZVision::RenderTable::NEAREST);
+	}
+
+	void test_bilinear() {
+		checkFilter(ZVision::RenderTable::BILINEAR);
+	}
+};
@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/random.h"
+
+#include "graphics/transparent_surface.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite {
+	Common::XorShiftRandom _rnd;
+
+	void fill(Graphics::Surface &surface) {
+		const uint32 alphaMask = 0xFF << surface.format.aShift;
+		uint32 *pixels = (uint32 *)surface.getPixels();
+		for (int i = 0; i < surface.w * surface.h; ++i) {
+			uint32 pixel = _rnd.next();
+			// Fully transparent and fully opaque pixels take extra paths
+			switch (_rnd.next() % 4) {
+			case 0:
+				pixel &= ~alphaMask;
+				break;
+			case 1:
+				pixel |= alphaMask;
+				break;
+			default:
+				break;
+			}
+			pixels[i] = pixel;
+		}
+	}
+
+	/**
+	 * Blit a random sprite with and without vector instructions, and
+	 * compare the results.
+	 */
+	void checkBlit(int width, Graphics::TSpriteBlendMode blendMode, uint color) {
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		const int height = 5;
+
+		Graphics::TransparentSurface sprite;
+		sprite.create(width, height, format);
+		fill(sprite);
+
+		Graphics::Surface background;
+		background.create(width + 3, height + 2, format);
+		fill(background);
+
+		for (int flipping = Graphics::FLIP_NONE; flipping <= Graphics::FLIP_HV; ++flipping) {
+			Graphics::Surface plain, vectorized;
+			plain.copyFrom(background);
+			vectorized.copyFrom(background);
+
+			Graphics::TransparentSurface::setSIMD(false);
+			sprite.blit(plain, 1, 1, flipping, nullptr, color, -1, -1, blendMode);
+			Graphics::TransparentSurface::setSIMD(true);
+			sprite.blit(vectorized, 1, 1, flipping, nullptr, color, -1, -1, blendMode);
+
+			TS_ASSERT_SAME_DATA(plain.getPixels(), vectorized.getPixels(), plain.pitch * plain.h);
+
+			plain.free();
+			vectorized.free();
+		}
+
+		sprite.free();
+		background.free();
+	}
+
+	void checkBlendMode(Graphics::TSpriteBlendMode blendMode) {
+		// Untinted, tinted, and tinted with some unmodulated channels; the
+		// blenders take the colors as 0xAARRGGBB.
+		static const uint colors[] = { 0xFFFFFFFF, 0x8040C811, 0xFFFAFBFC, 0xC8FF50FF };
+
+		// Widths which are not a multiple of four exercise the remaining
+		// pixels of the vectorized loops.
+		for (int width = 1; width <= 9; ++width) {
+			for (int i = 0; i < ARRAYSIZE(colors); ++i)
+				checkBlit(width, blendMode, colors[i]);
+		}
+	}
+
+	/**
+	 * Compare two transformed surfaces, and free them.
+	 */
+	void checkSame(Graphics::TransparentSurface *plain, Graphics::TransparentSurface *vectorized) {
+		TS_ASSERT_EQUALS(plain->w, vectorized->w);
+		TS_ASSERT_EQUALS(plain->h, vectorized->h);
+		if (plain->w == vectorized->w && plain->h == vectorized->h)
+			TS_ASSERT_SAME_DATA(plain->getPixels(), vectorized->getPixels(), plain->pitch * plain->h);
+
+		plain->free();
+		delete plain;
+		vectorized->free();
+		delete vectorized;
+	}
+
+public:
+	TransparentSurfaceTestSuite() : _rnd(0x2545F491) {}
+
+	void setUp() {
+		_rnd = Common::XorShiftRandom(0x2545F491);
+	}
+
+	void tearDown() {
+		Graphics::TransparentSurface::setSIMD(true);
+	}
+
+	void test_alpha_blend() {
+		checkBlendMode(Graphics::BLEND_NORMAL);
+	}
+
+	void test_additive_blend() {
+		checkBlendMode(Graphics::BLEND_ADDITIVE);
+	}
+
+	void test_subtractive_blend() {
+		checkBlendMode(Graphics::BLEND_SUBTRACTIVE);
+	}
+
+	void test_multiply_blend() {
+		checkBlendMode(Graphics::BLEND_MULTIPLY);
+	}
+
+	void test_bilinear_scale() {
+		Graphics::TransparentSurface sprite;
+		sprite.create(23, 17, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(sprite);
+
+		// Enlarge and shrink
+		static const int sizes[][2] = { { 61, 40 }, { 9, 7 }, { 23, 50 } };
+		for (int i = 0; i < ARRAYSIZE(sizes); ++i) {
+			Graphics::TransparentSurface::setSIMD(false);
+			Graphics::TransparentSurface *plain = sprite.scaleT<Graphics::FILTER_BILINEAR>(sizes[i][0], sizes[i][1]);
+			Graphics::TransparentSurface::setSIMD(true);
+			Graphics::TransparentSurface *vectorized = sprite.scaleT<Graphics::FILTER_BILINEAR>(sizes[i][0], sizes[i][1]);
+			checkSame(plain, vectorized);
+		}
+
+		sprite.free();
+	}
+
+	void test_bilinear_rotoscale() {
+		Graphics::TransparentSurface sprite;
+		sprite.create(23, 17, Graphics::TransparentSurface::getSupportedPixelFormat());
+		fill(sprite);
+
+		static const int angles[] = { 30, 90, 211 };
+		for (int i = 0; i < ARRAYSIZE(angles); ++i) {
+			const Graphics::TransformStruct transform(150, 70, angles[i], 11, 8);
+
+			Graphics::TransparentSurface::setSIMD(false);
+			Graphics::TransparentSurface *plain = sprite.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
+			Graphics::TransparentSurface::setSIMD(true);
+			Graphics::TransparentSurface *vectorized = sprite.rotoscaleT<Graphics::FILTER_BILINEAR>(transform);
+			checkSame(plain, vectorized);
+		}
+
+		sprite.free();
+	}
+};
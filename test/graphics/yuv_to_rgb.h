@@ -0,0 +1,102 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/random.h"
+#include "common/util.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+	enum Subsampling {
+		k444,
+		k420,
+		k410
+	};
+
+	static void convert(Graphics::Surface &dst, Subsampling subsampling, Graphics::YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int width, int height, int uvPitch) {
+		switch (subsampling) {
+		case k444:
+			YUVToRGBMan.convert444(&dst, scale, ySrc, uSrc, vSrc, width, height, width, uvPitch);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(&dst, scale, ySrc, uSrc, vSrc, width, height, width, uvPitch);
+			break;
+		case k410:
+			YUVToRGBMan.convert410(&dst, scale, ySrc, uSrc, vSrc, width, height, width, uvPitch);
+			break;
+		}
+	}
+
+	/**
+	 * Convert a random image with and without vector instructions, and
+	 * compare the results.
+	 */
+	void checkConvert(Subsampling subsampling, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		const int shift = subsampling == k444 ? 0 : (subsampling == k420 ? 1 : 2);
+		// The chroma planes have an extra row and column, which YUV410
+		// images need for the interpolation
+		const int uvPitch = (width >> shift) + 1;
+		const int uvHeight = (height >> shift) + 1;
+
+		Common::XorShiftRandom rnd(0x2468ACE1 + width);
+		byte *ySrc = new byte[width * height];
+		byte *uSrc = new byte[uvPitch * uvHeight];
+		byte *vSrc = new byte[uvPitch * uvHeight];
+		for (int i = 0; i < width * height; ++i)
+			ySrc[i] = rnd.next() >> 24;
+		for (int i = 0; i < uvPitch * uvHeight; ++i) {
+			uSrc[i] = rnd.next() >> 24;
+			vSrc[i] = rnd.next() >> 24;
+		}
+
+		Graphics::Surface plain, vectorized;
+		plain.create(width, height, format);
+		vectorized.create(width, height, format);
+
+		YUVToRGBMan.setSIMD(false);
+		convert(plain, subsampling, scale, ySrc, uSrc, vSrc, width, height, uvPitch);
+		YUVToRGBMan.setSIMD(true);
+		convert(vectorized, subsampling, scale, ySrc, uSrc, vSrc, width, height, uvPitch);
+
+		TS_ASSERT_SAME_DATA(plain.getPixels(), vectorized.getPixels(), plain.pitch * plain.h);
+
+		plain.free();
+		vectorized.free();
+		delete[] ySrc;
+		delete[] uSrc;
+		delete[] vSrc;
+	}
+
+	void checkSubsampling(Subsampling subsampling, int widthStep) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+		const int height = subsampling == k444 ? 3 : 8;
+
+		// Widths which are not a multiple of the vector width exercise the
+		// pixels left over by the vectorized loops.
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			for (int width = widthStep; width <= 72; width += widthStep) {
+				checkConvert(subsampling, formats[i], Graphics::YUVToRGBManager::kScaleFull, width, height);
+				checkConvert(subsampling, formats[i], Graphics::YUVToRGBManager::kScaleITU, width, height);
+			}
+		}
+
+		YUVToRGBMan.setSIMD(true);
+	}
+
+public:
+	void test_convert444() {
+		checkSubsampling(k444, 1);
+	}
+
+	void test_convert420() {
+		checkSubsampling(k420, 2);
+	}
+
+	void test_convert410() {
+		checkSubsampling(k410, 4);
+	}
+};
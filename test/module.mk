@@ -5,14 +5,25 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h \
+	$(srcdir)/test/engines/*.h
+TEST_LIBS    := engines/libengines.a video/libvideo.a audio/libaudio.a graphics/libgraphics.a common/libcommon.a
+
+# Tests of features which only exist when building as C++11
+ifdef USE_CXX11
+	TESTS += $(srcdir)/test/common/cxx11/*.h
+endif
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
 endif
 
+ifeq ($(ENABLE_ZVISION), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/zvision/*.h
+	TEST_LIBS += engines/zvision/libzvision.a
+endif
+
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
@@ -0,0 +1,127 @@
+#include <cxxtest/TestSuite.h>
+
+class BinkDecoderTestSuite;
+
+#include "common/random.h"
+#include "common/util.h"
+
+#include "video/bink_decoder.h"
+
+class BinkDecoderTestSuite : public CxxTest::TestSuite {
+#ifdef USE_BINK
+	typedef Video::BinkDecoder::BinkVideoTrack BinkVideoTrack;
+
+	/**
+	 * Fill a block with random coefficients. Many blocks of real videos
+	 * only have a few coefficients, and columns with only the DC
+	 * coefficient take a shortcut in the plain IDCT.
+	 */
+	static void fillBlock(Common::XorShiftRandom &rnd, int16 *block) {
+		const uint32 kind = rnd.next() % 4;
+		for (int i = 0; i < 64; ++i) {
+			const int16 value = (int16)((int)(rnd.next() % 4096) - 2048);
+			switch (kind) {
+			case 0:
+				// Only the first row
+				block[i] = (i < 8) ? value : 0;
+				break;
+			case 1:
+				// A few coefficients
+				block[i] = (rnd.next() % 8 == 0) ? value : 0;
+				break;
+			default:
+				block[i] = value;
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Run one of the IDCTs on random blocks with and without vector
+	 * instructions, and compare the results.
+	 *
+	 * @param mode 0 for IDCT(), 1 for IDCTPut(), 2 for IDCTAdd()
+	 */
+	void checkIDCT(int mode) {
+		Common::XorShiftRandom rnd(0x5DEECE66);
+
+		// A pitch wider than the block, with pixels around it which must
+		// stay untouched
+		const int pitch = 12;
+		byte plainDest[pitch * 10], simdDest[pitch * 10];
+
+		for (int n = 0; n < 1000; ++n) {
+			int16 block[64], plainBlock[64], simdBlock[64];
+			fillBlock(rnd, block);
+			memcpy(plainBlock, block, sizeof(block));
+			memcpy(simdBlock, block, sizeof(block));
+
+			for (int i = 0; i < ARRAYSIZE(plainDest); ++i)
+				plainDest[i] = simdDest[i] = rnd.next();
+
+			BinkVideoTrack::DecodeContext plainCtx, simdCtx;
+			plainCtx.dest = plainDest + pitch + 2;
+			plainCtx.pitch = pitch;
+			simdCtx.dest = simdDest + pitch + 2;
+			simdCtx.pitch = pitch;
+
+			Video::BinkDecoder::setSIMD(false);
+			switch (mode) {
+			case 0:
+				BinkVideoTrack::IDCT(plainBlock);
+				break;
+			case 1:
+				BinkVideoTrack::IDCTPut(plainCtx, plainBlock);
+				break;
+			default:
+				BinkVideoTrack::IDCTAdd(plainCtx, plainBlock);
+				break;
+			}
+
+			Video::BinkDecoder::setSIMD(true);
+			switch (mode) {
+			case 0:
+				BinkVideoTrack::IDCT(simdBlock);
+				break;
+			case 1:
+				BinkVideoTrack::IDCTPut(simdCtx, simdBlock);
+				break;
+			default:
+				BinkVideoTrack::IDCTAdd(simdCtx, simdBlock);
+				break;
+			}
+
+			if (mode == 0) {
+				TS_ASSERT_SAME_DATA(plainBlock, simdBlock, sizeof(plainBlock));
+			} else {
+				TS_ASSERT_SAME_DATA(plainDest, simdDest, sizeof(plainDest));
+			}
+		}
+	}
+#endif
+
+public:
+	void tearDown() {
+#ifdef USE_BINK
+		Video::BinkDecoder::setSIMD(true);
+#endif
+	}
+
+	void test_idct() {
+#ifdef USE_BINK
+		checkIDCT(0);
+#endif
+	}
+
+	void test_idct_put() {
+#ifdef USE_BINK
+		checkIDCT(1);
+#endif
+	}
+
+	void test_idct_add() {
+#ifdef USE_BINK
+		checkIDCT(2);
+#endif
+	}
+};
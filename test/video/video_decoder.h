@@ -0,0 +1,286 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "common/timer.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+/**
+ * Test suite for the frame-ahead decoding of Video::VideoDecoder.
+ *
+ * The timer proc decoding the frames is run by hand, through a stand-in
+ * for the backend.
+ */
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+	/** Runs the installed timer proc only when asked to. */
+	class ManualTimerManager : public Common::TimerManager {
+	public:
+		ManualTimerManager() : _proc(nullptr), _refCon(nullptr) {}
+
+		virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id) {
+			_proc = proc;
+			_refCon = refCon;
+			return true;
+		}
+
+		virtual void removeTimerProc(TimerProc proc) {
+			if (_proc == proc)
+				_proc = nullptr;
+		}
+
+		bool isInstalled() const { return _proc != nullptr; }
+
+		void run() {
+			if (_proc)
+				_proc(_refCon);
+		}
+
+	private:
+		TimerProc _proc;
+		void *_refCon;
+	};
+
+	/** The parts of a backend used by VideoDecoder, with a clock set by hand. */
+	class TestSystem : public OSystem {
+	public:
+		TestSystem() : _millis(1000), _timer(new ManualTimerManager()) {
+			_timerManager = _timer;
+		}
+
+		uint32 _millis;
+		ManualTimerManager *_timer;
+
+		virtual uint32 getMillis(bool skipRecord = false) { return _millis; }
+		virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+		virtual MutexRef createMutex() { return (MutexRef)this; }
+		virtual void lockMutex(MutexRef mutex) {}
+		virtual void unlockMutex(MutexRef mutex) {}
+		virtual void deleteMutex(MutexRef mutex) {}
+
+		virtual const GraphicsMode *getSupportedGraphicsModes() const { return nullptr; }
+		virtual int getDefaultGraphicsMode() const { return 0; }
+		virtual bool setGraphicsMode(int mode) { return false; }
+		virtual int getGraphicsMode() const { return 0; }
+		virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+		virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format = nullptr) {}
+		virtual int16 getHeight() { return 0; }
+		virtual int16 getWidth() { return 0; }
+		virtual PaletteManager *getPaletteManager() { return nullptr; }
+		virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+		virtual Graphics::Surface *lockScreen() { return nullptr; }
+		virtual void unlockScreen() {}
+		virtual void fillScreen(uint32 col) {}
+		virtual void updateScreen() {}
+		virtual void setShakePos(int shakeOffset) {}
+		virtual void showOverlay() {}
+		virtual void hideOverlay() {}
+		virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(); }
+		virtual void clearOverlay() {}
+		virtual void grabOverlay(void *buf, int pitch) {}
+		virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+		virtual int16 getOverlayHeight() { return 0; }
+		virtual int16 getOverlayWidth() { return 0; }
+		virtual bool showMouse(bool visible) { return false; }
+		virtual void warpMouse(int x, int y) {}
+		virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = nullptr) {}
+		virtual void delayMillis(uint msecs) { _millis += msecs; }
+		virtual void getTimeAndDate(TimeDate &t) const {}
+		virtual Audio::Mixer *getMixer() { return nullptr; }
+		virtual void quit() {}
+		virtual void displayMessageOnOSD(const char *msg) {}
+		virtual void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+		virtual void logMessage(LogMessageType::Type type, const char *message) {}
+	};
+
+	class TestVideoDecoder : public Video::VideoDecoder {
+	public:
+		TestVideoDecoder(int frameCount) : _decoded(0) {
+			addTrack(new TestVideoTrack(frameCount, _decoded));
+		}
+
+		virtual bool loadStream(Common::SeekableReadStream *stream) { return false; }
+
+		/** The number of frames the track decoded so far */
+		int _decoded;
+
+	private:
+		/** Ten frames per second, each filled with its frame number. */
+		class TestVideoTrack : public FixedRateVideoTrack {
+		public:
+			TestVideoTrack(int frameCount, int &decoded) : _frameCount(frameCount), _curFrame(-1), _decoded(decoded) {
+				_surface.create(4, 2, Graphics::PixelFormat::createFormatCLUT8());
+			}
+
+			virtual ~TestVideoTrack() {
+				_surface.free();
+			}
+
+			virtual uint16 getWidth() const { return _surface.w; }
+			virtual uint16 getHeight() const { return _surface.h; }
+			virtual Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+			virtual int getCurFrame() const { return _curFrame; }
+			virtual int getFrameCount() const { return _frameCount; }
+			virtual bool isRewindable() const { return true; }
+
+			virtual bool rewind() {
+				_curFrame = -1;
+				return true;
+			}
+
+			virtual const Graphics::Surface *decodeNextFrame() {
+				_curFrame++;
+				_decoded++;
+				memset(_surface.getPixels(), _curFrame, _surface.w * _surface.h);
+				return &_surface;
+			}
+
+		protected:
+			virtual Common::Rational getFrameRate() const { return 10; }
+
+		private:
+			Graphics::Surface _surface;
+			int _frameCount;
+			int _curFrame;
+			int &_decoded;
+		};
+	};
+
+	/** Check the frame number of a decoded frame, and its pixels. */
+	static bool isFrame(const Graphics::Surface *surface, int frame) {
+		if (!surface)
+			return false;
+		const byte *pixels = (const byte *)surface->getPixels();
+		for (int i = 0; i < surface->w * surface->h; i++) {
+			if (pixels[i] != frame)
+				return false;
+		}
+		return true;
+	}
+
+	OSystem *_oldSystem;
+	TestSystem *_system;
+
+public:
+	void setUp() {
+		_oldSystem = g_system;
+		_system = new TestSystem();
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = _oldSystem;
+		delete _system;
+	}
+
+	void test_decode_ahead() {
+		TestVideoDecoder decoder(10);
+		TS_ASSERT(decoder.setFrameAhead(3));
+		TS_ASSERT(_system->_timer->isInstalled());
+		decoder.start();
+
+		// Nothing is decoded before the caller got the first frame
+		_system->_timer->run();
+		TS_ASSERT_EQUALS(decoder._decoded, 0);
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 0));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 0);
+
+		// Up to three frames are queued, one per run of the timer proc
+		_system->_timer->run();
+		TS_ASSERT_EQUALS(decoder._decoded, 2);
+		for (int i = 0; i < 5; i++)
+			_system->_timer->run();
+		TS_ASSERT_EQUALS(decoder._decoded, 4);
+
+		// They are shown in order, at their time, freeing their slots
+		TS_ASSERT_EQUALS(decoder.getTimeToNextFrame(), 100U);
+		_system->_millis += 100;
+		TS_ASSERT(decoder.needsUpdate());
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 1));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 1);
+		TS_ASSERT_EQUALS(decoder._decoded, 4);
+
+		_system->_timer->run();
+		TS_ASSERT_EQUALS(decoder._decoded, 5);
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 2));
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 3));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 3);
+	}
+
+	void test_timer_behind() {
+		// Without the timer proc running, the frames are decoded on demand
+		TestVideoDecoder decoder(5);
+		TS_ASSERT(decoder.setFrameAhead(2));
+		decoder.start();
+
+		for (int i = 0; i < 5; i++) {
+			TS_ASSERT(!decoder.endOfVideo());
+			TS_ASSERT(isFrame(decoder.decodeNextFrame(), i));
+			TS_ASSERT_EQUALS(decoder.getCurFrame(), i);
+			TS_ASSERT_EQUALS(decoder._decoded, i + 1);
+		}
+
+		TS_ASSERT(!decoder.decodeNextFrame());
+		TS_ASSERT(decoder.endOfVideo());
+	}
+
+	void test_end_of_video() {
+		// The video only ends once the queued frames were shown
+		TestVideoDecoder decoder(3);
+		TS_ASSERT(decoder.setFrameAhead(4));
+		decoder.start();
+
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 0));
+		for (int i = 0; i < 4; i++)
+			_system->_timer->run();
+		TS_ASSERT_EQUALS(decoder._decoded, 3);
+		TS_ASSERT(!decoder.endOfVideo());
+
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 1));
+		TS_ASSERT(!decoder.endOfVideo());
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 2));
+		TS_ASSERT(decoder.endOfVideo());
+	}
+
+	void test_rewind() {
+		// Rewinding drops the queued frames
+		TestVideoDecoder decoder(10);
+		TS_ASSERT(decoder.setFrameAhead(3));
+		decoder.start();
+
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 0));
+		for (int i = 0; i < 3; i++)
+			_system->_timer->run();
+		TS_ASSERT_EQUALS(decoder._decoded, 4);
+
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), -1);
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 0));
+		_system->_timer->run();
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 1));
+	}
+
+	void test_disable() {
+		TestVideoDecoder decoder(10);
+		TS_ASSERT(decoder.setFrameAhead(3));
+		decoder.start();
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 0));
+
+		// Without a way back, the queued frames are lost
+		_system->_timer->run();
+		TS_ASSERT(decoder.setFrameAhead(0));
+		TS_ASSERT(!_system->_timer->isInstalled());
+		TS_ASSERT(isFrame(decoder.decodeNextFrame(), 2));
+
+		// Closing the video stops decoding ahead as well
+		TS_ASSERT(decoder.setFrameAhead(2));
+		TS_ASSERT(_system->_timer->isInstalled());
+		decoder.close();
+		TS_ASSERT(!_system->_timer->isInstalled());
+	}
+
+	void test_reverse() {
+		TestVideoDecoder decoder(10);
+		TS_ASSERT(decoder.setFrameAhead(3));
+		TS_ASSERT(!decoder.setReverse(true));
+	}
+};
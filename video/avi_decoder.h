@@ -102,6 +102,8 @@ protected:
 	bool seekIntern(const Audio::Timestamp &time);
 	bool supportsAudioTrackSwitching() const { return true; }
 	AudioTrack *getAudioTrack(int index);
+	// decodeNextFrame() seeks the tracks when playing in reverse
+	bool supportsFrameAhead() const { return false; }
 
 	/**
 	 * Define a track to be used by this class.
@@ -46,6 +46,14 @@
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
 
+// The IDCT needs 32 bits multiplications to give exactly the same results as
+// the plain version, so the vectorized version needs SSE4.1. It is compiled
+// through a function attribute and only used when the CPU supports it.
+#if defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define BINK_IDCT_SSE41
+#include <smmintrin.h>
+#endif
+
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
 static const uint32 kBIKhID = MKTAG('B', 'I', 'K', 'h');
@@ -1323,7 +1331,200 @@ static inline void IDCTCol(int16 *dest, const int16 *src) {
 	}
 }
 
+#ifdef BINK_IDCT_SSE41
+
+namespace {
+
+/**
+ * Apply IDCT_TRANSFORM to four columns (or rows) at once. Each of the
+ * vectors holds one of the eight input or output values for all of them.
+ */
+__attribute__((target("sse4.1")))
+inline void transformSSE41(const __m128i *s, __m128i *d) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(A1), _mm_sub_epi32(s[2], s[6])), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(A3), _mm_add_epi32(a5, a7)), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(A4), a5), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(A1), _mm_sub_epi32(a6, a4)), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_mullo_epi32(_mm_set1_epi32(A2), a7), 11), b3), b1);
+
+	const __m128i a0a2 = _mm_add_epi32(a0, a2);
+	const __m128i a0s2 = _mm_sub_epi32(a0, a2);
+	const __m128i a1a3 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i a1s3 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	d[0] = _mm_add_epi32(a0a2, b0);
+	d[1] = _mm_add_epi32(a1a3, b2);
+	d[2] = _mm_add_epi32(a1s3, b3);
+	d[3] = _mm_sub_epi32(a0s2, b4);
+	d[4] = _mm_add_epi32(a0s2, b4);
+	d[5] = _mm_sub_epi32(a1s3, b3);
+	d[6] = _mm_sub_epi32(a1a3, b2);
+	d[7] = _mm_sub_epi32(a0a2, b0);
+}
+
+/**
+ * Pack two vectors of 32 bits values into one of 16 bits values, dropping
+ * the upper bits like a conversion to int16 does.
+ */
+__attribute__((target("sse4.1")))
+inline __m128i packTruncateSSE41(__m128i low, __m128i high) {
+	low = _mm_srai_epi32(_mm_slli_epi32(low, 16), 16);
+	high = _mm_srai_epi32(_mm_slli_epi32(high, 16), 16);
+	return _mm_packs_epi32(low, high);
+}
+
+__attribute__((target("sse4.1")))
+inline void transposeSSE41(__m128i *rows) {
+	const __m128i t0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+	const __m128i t1 = _mm_unpackhi_epi16(rows[0], rows[1]);
+	const __m128i t2 = _mm_unpacklo_epi16(rows[2], rows[3]);
+	const __m128i t3 = _mm_unpackhi_epi16(rows[2], rows[3]);
+	const __m128i t4 = _mm_unpacklo_epi16(rows[4], rows[5]);
+	const __m128i t5 = _mm_unpackhi_epi16(rows[4], rows[5]);
+	const __m128i t6 = _mm_unpacklo_epi16(rows[6], rows[7]);
+	const __m128i t7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+
+	const __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+	const __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+	const __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+	const __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+	const __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+	const __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+	const __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+	const __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+	rows[0] = _mm_unpacklo_epi64(u0, u4);
+	rows[1] = _mm_unpackhi_epi64(u0, u4);
+	rows[2] = _mm_unpacklo_epi64(u1, u5);
+	rows[3] = _mm_unpackhi_epi64(u1, u5);
+	rows[4] = _mm_unpacklo_epi64(u2, u6);
+	rows[5] = _mm_unpackhi_epi64(u2, u6);
+	rows[6] = _mm_unpacklo_epi64(u3, u7);
+	rows[7] = _mm_unpackhi_epi64(u3, u7);
+}
+
+/**
+ * Run IDCT_COL on all columns and IDCT_ROW on all rows of the block, in
+ * the same precision as the plain version.
+ *
+ * @param rows receives the rows of the result, truncated to 16 bits
+ */
+__attribute__((target("sse4.1")))
+void idctSSE41(const int16 *block, __m128i *rows) {
+	__m128i temp[8];
+	for (int i = 0; i < 8; i++)
+		temp[i] = _mm_loadu_si128((const __m128i *)(block + i * 8));
+
+	// Columns, on the left and right half of the block
+	__m128i s[8], left[8], right[8];
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_cvtepi16_epi32(temp[i]);
+	transformSSE41(s, left);
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_cvtepi16_epi32(_mm_srli_si128(temp[i], 8));
+	transformSSE41(s, right);
+
+	// The plain version keeps the intermediate values as int16
+	for (int i = 0; i < 8; i++)
+		temp[i] = packTruncateSSE41(left[i], right[i]);
+
+	// Rows, on the top and bottom half of the block. After transposing,
+	// each vector holds the same column of all rows.
+	transposeSSE41(temp);
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_cvtepi16_epi32(temp[i]);
+	transformSSE41(s, left);
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_cvtepi16_epi32(_mm_srli_si128(temp[i], 8));
+	transformSSE41(s, right);
+
+	// MUNGE_ROW
+	const __m128i bias = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++)
+		rows[i] = packTruncateSSE41(_mm_srai_epi32(_mm_add_epi32(left[i], bias), 8), _mm_srai_epi32(_mm_add_epi32(right[i], bias), 8));
+	transposeSSE41(rows);
+}
+
+__attribute__((target("sse4.1")))
+void idctSSE41(int16 *block) {
+	__m128i rows[8];
+	idctSSE41(block, rows);
+	for (int i = 0; i < 8; i++)
+		_mm_storeu_si128((__m128i *)(block + i * 8), rows[i]);
+}
+
+__attribute__((target("sse4.1")))
+void idctPutSSE41(byte *dest, uint32 pitch, const int16 *block) {
+	__m128i rows[8];
+	idctSSE41(block, rows);
+
+	// Only the lowest eight bits are stored, as in the plain version
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	for (int i = 0; i < 8; i++, dest += pitch)
+		_mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(_mm_and_si128(rows[i], mask), _mm_setzero_si128()));
+}
+
+__attribute__((target("sse4.1")))
+void idctAddSSE41(byte *dest, uint32 pitch, const int16 *block) {
+	__m128i rows[8];
+	idctSSE41(block, rows);
+
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)dest), _mm_setzero_si128());
+		const __m128i sum = _mm_and_si128(_mm_add_epi16(pixels, rows[i]), mask);
+		_mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(sum, _mm_setzero_si128()));
+	}
+}
+
+/**
+ * Whether the CPU supports the vectorized IDCT. The CPU is only checked on
+ * first use.
+ */
+bool haveSSE41() {
+	static int supported = -1;
+	if (supported < 0) {
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("sse4.1") ? 1 : 0;
+	}
+	return supported != 0;
+}
+
+} // End of anonymous namespace
+
+#endif // BINK_IDCT_SSE41
+
+namespace {
+
+/** Whether the vectorized IDCT may be used; see BinkDecoder::setSIMD(). */
+bool s_useSIMD = true;
+
+} // End of anonymous namespace
+
+bool BinkDecoder::setSIMD(bool enable) {
+	s_useSIMD = enable;
+#ifdef BINK_IDCT_SSE41
+	return haveSSE41();
+#else
+	return false;
+#endif
+}
+
 void BinkDecoder::BinkVideoTrack::IDCT(int16 *block) {
+#ifdef BINK_IDCT_SSE41
+	if (s_useSIMD && haveSSE41()) {
+		idctSSE41(block);
+		return;
+	}
+#endif
+
 	int i;
 	int16 temp[64];
 
@@ -1335,6 +1536,13 @@ void BinkDecoder::BinkVideoTrack::IDCT(int16 *block) {
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16 *block) {
+#ifdef BINK_IDCT_SSE41
+	if (s_useSIMD && haveSSE41()) {
+		idctAddSSE41(ctx.dest, ctx.pitch, block);
+		return;
+	}
+#endif
+
 	int i, j;
 
 	IDCT(block);
@@ -1345,6 +1553,13 @@ void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int16 *block) {
 }
 
 void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int16 *block) {
+#ifdef BINK_IDCT_SSE41
+	if (s_useSIMD && haveSSE41()) {
+		idctPutSSE41(ctx.dest, ctx.pitch, block);
+		return;
+	}
+#endif
+
 	int i;
 	int16 temp[64];
 	for (i = 0; i < 8; i++)
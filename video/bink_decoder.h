@@ -65,6 +65,10 @@ namespace Video {
  *  - scumm (he)
  */
 class BinkDecoder : public VideoDecoder {
+#ifdef CXXTEST_RUNNING
+	friend class ::BinkDecoderTestSuite;
+#endif
+
 public:
 	BinkDecoder();
 	~BinkDecoder();
@@ -72,6 +76,14 @@ public:
 	bool loadStream(Common::SeekableReadStream *stream);
 	void close();
 
+	/**
+	 * Enable or disable the use of vector instructions for the IDCT. They
+	 * are enabled by default, and produce exactly the same images.
+	 *
+	 * @return whether vector instructions are available at all
+	 */
+	static bool setSIMD(bool enable);
+
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
@@ -318,9 +330,13 @@ private:
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
 
 		// Bink video IDCT
-		void IDCT(int16 *block);
-		void IDCTPut(DecodeContext &ctx, int16 *block);
-		void IDCTAdd(DecodeContext &ctx, int16 *block);
+		static void IDCT(int16 *block);
+		static void IDCTPut(DecodeContext &ctx, int16 *block);
+		static void IDCTAdd(DecodeContext &ctx, int16 *block);
+
+#ifdef CXXTEST_RUNNING
+		friend class ::BinkDecoderTestSuite;
+#endif
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -72,6 +72,9 @@ public:
 	Audio::Timestamp getDuration() const { return Audio::Timestamp(0, _duration, _timeScale); }
 
 protected:
+	// decodeNextFrame() updates the audio buffers
+	bool supportsFrameAhead() const { return false; }
+
 	Common::QuickTimeParser::SampleDesc *readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize);
 
 private:
@@ -27,12 +27,31 @@
 
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
+#include "common/timer.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+/** A frame decoded ahead of time, see setFrameAhead() */
+struct VideoDecoder::AheadFrame {
+	Graphics::Surface surface;
+	/** Whether the decoder returned a frame */
+	bool hasSurface;
+	/** The time this frame is to be shown at */
+	uint32 startTime;
+	/** The frame number getCurFrame() returns after showing this frame */
+	int curFrame;
+	bool hasPalette;
+	byte palette[256 * 3];
+};
+
+/** The decoders with frame-ahead decoding enabled */
+static Common::Array<VideoDecoder *> s_frameAheadDecoders;
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -49,6 +68,11 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_frameAhead = 0;
+	_aheadFrames = 0;
+	_aheadShown = -1;
+	_aheadCurFrame = -1;
+	_aheadEnd = false;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -57,7 +81,13 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	disableFrameAhead();
+}
+
 void VideoDecoder::close() {
+	disableFrameAhead();
+
 	if (isPlaying())
 		stop();
 
@@ -110,6 +140,8 @@ void VideoDecoder::pauseVideo(bool pause) {
 		return;
 	}
 
+	Common::StackLock lock(_aheadMutex);
+
 	if (_pauseLevel == 1 && pause) {
 		_pauseStartTime = g_system->getMillis(); // Store the starting time from pausing to keep it for later
 
@@ -183,8 +215,26 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
+
+	if (_frameAhead)
+		return nextAheadFrame();
+
 	_canSetDither = false;
 
+	const byte *palette;
+	const Graphics::Surface *frame = decodeFrameIntern(palette);
+
+	if (palette) {
+		_palette = palette;
+		_dirtyPalette = true;
+	}
+
+	return frame;
+}
+
+const Graphics::Surface *VideoDecoder::decodeFrameIntern(const byte *&palette) {
+	palette = 0;
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -194,10 +244,8 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
 
-	if (_nextVideoTrack->hasDirtyPalette()) {
-		_palette = _nextVideoTrack->getPalette();
-		_dirtyPalette = true;
-	}
+	if (_nextVideoTrack->hasDirtyPalette())
+		palette = _nextVideoTrack->getPalette();
 
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
@@ -205,11 +253,205 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool VideoDecoder::setFrameAhead(uint frames) {
+	frames = MIN<uint>(frames, kMaxFrameAhead);
+	if (frames == _frameAhead)
+		return true;
+
+	if (_frameAhead) {
+		// The tracks are ahead of the shown frame. Go back to the first
+		// queued frame if possible, it is dropped otherwise.
+		const int slot = peekAheadFrame();
+		const uint32 nextFrameTime = slot >= 0 ? _aheadFrames[slot].startTime : 0;
+
+		disableFrameAhead();
+
+		if (slot >= 0 && isSeekable()) {
+			const bool needsUpdate = _needsUpdate;
+			seek(Audio::Timestamp(nextFrameTime, 1000));
+			_needsUpdate = needsUpdate;
+		}
+	}
+
+	if (!frames)
+		return true;
+
+	if (!isVideoLoaded() || !supportsFrameAhead())
+		return false;
+
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed())
+			return false;
+
+	// Allocate one surface more than the number of queued frames, for the
+	// frame shown by the caller.
+	_aheadFrames = new AheadFrame[frames + 1];
+	for (uint i = 0; i <= frames; i++) {
+		_aheadFrames[i].surface.create(getWidth(), getHeight(), getPixelFormat());
+		_aheadFree.push(i);
+	}
+
+	_frameAhead = frames;
+	_aheadShown = -1;
+	_aheadCurFrame = getTrackCurFrame();
+	_aheadEnd = false;
+
+	registerFrameAhead(this, true);
+	return true;
+}
+
+void VideoDecoder::disableFrameAhead() {
+	if (!_frameAhead)
+		return;
+
+	// Once unregistered, the timer thread does not touch us anymore
+	registerFrameAhead(this, false);
+
+	for (uint i = 0; i <= _frameAhead; i++)
+		_aheadFrames[i].surface.free();
+	delete[] _aheadFrames;
+	_aheadFrames = 0;
+	_frameAhead = 0;
+
+	uint slot;
+	while (_aheadQueue.pop(slot))
+		;
+	while (_aheadFree.pop(slot))
+		;
+}
+
+void VideoDecoder::frameAheadProc(void *refCon) {
+	// The timer manager does not allow installing the same callback more
+	// than once, so this one serves all decoders.
+	for (uint i = 0; i < s_frameAheadDecoders.size(); i++) {
+		VideoDecoder *decoder = s_frameAheadDecoders[i];
+		Common::StackLock lock(decoder->_aheadMutex);
+
+		// The first frame is decoded by the caller, giving it a chance to
+		// set the dithering palette before.
+		if (!decoder->_canSetDither && decoder->isPlaying())
+			decoder->decodeAheadFrame();
+	}
+}
+
+void VideoDecoder::registerFrameAhead(VideoDecoder *decoder, bool enable) {
+	// Removing the timer proc waits for it to finish, after which the list
+	// can be changed safely.
+	Common::TimerManager *timerManager = g_system->getTimerManager();
+	timerManager->removeTimerProc(&frameAheadProc);
+
+	if (enable) {
+		s_frameAheadDecoders.push_back(decoder);
+	} else {
+		for (uint i = 0; i < s_frameAheadDecoders.size(); i++) {
+			if (s_frameAheadDecoders[i] == decoder) {
+				s_frameAheadDecoders.remove_at(i);
+				break;
+			}
+		}
+	}
+
+	if (!s_frameAheadDecoders.empty())
+		timerManager->installTimerProc(&frameAheadProc, kFrameAheadInterval, 0, "videoFrameAhead");
+}
+
+bool VideoDecoder::decodeAheadFrame() {
+	if (_aheadEnd)
+		return false;
+
+	if (!hasVideoFramesLeft()) {
+		_aheadEnd = true;
+		return false;
+	}
+
+	uint slot;
+	if (!_aheadFree.pop(slot))
+		return false;
+
+	AheadFrame &ahead = _aheadFrames[slot];
+	ahead.startTime = _nextVideoTrack ? _nextVideoTrack->getNextFrameStartTime() : 0;
+
+	const byte *palette;
+	const Graphics::Surface *frame = decodeFrameIntern(palette);
+
+	ahead.hasSurface = frame != 0;
+	if (frame) {
+		if (ahead.surface.w != frame->w || ahead.surface.h != frame->h || ahead.surface.format != frame->format) {
+			ahead.surface.free();
+			ahead.surface.create(frame->w, frame->h, frame->format);
+		}
+		ahead.surface.copyRectToSurface(*frame, 0, 0, Common::Rect(frame->w, frame->h));
+	}
+
+	ahead.hasPalette = palette != 0;
+	if (palette)
+		memcpy(ahead.palette, palette, sizeof(ahead.palette));
+
+	ahead.curFrame = getTrackCurFrame();
+
+	_aheadQueue.push(slot);
+	return true;
+}
+
+int VideoDecoder::peekAheadFrame() const {
+	uint slot;
+	if (!_aheadQueue.peek(slot))
+		return -1;
+
+	// Frames queued before an end time was set are dropped
+	if (_endTimeSet && isPlaying() && _aheadFrames[slot].startTime >= (uint)_endTime.msecs())
+		return -1;
+
+	return slot;
+}
+
+void VideoDecoder::flushFrameAhead() {
+	uint slot;
+	while (_aheadQueue.pop(slot))
+		_aheadFree.push(slot);
+
+	_aheadCurFrame = getTrackCurFrame();
+	_aheadEnd = false;
+}
+
+const Graphics::Surface *VideoDecoder::nextAheadFrame() {
+	if (peekAheadFrame() < 0) {
+		// The timer thread fell behind, or did not start yet
+		Common::StackLock lock(_aheadMutex);
+		_canSetDither = false;
+		decodeAheadFrame();
+	}
+
+	if (peekAheadFrame() < 0)
+		return 0;
+
+	uint slot;
+	_aheadQueue.pop(slot);
+	if (_aheadShown >= 0)
+		_aheadFree.push(_aheadShown);
+	_aheadShown = slot;
+
+	const AheadFrame &ahead = _aheadFrames[slot];
+	_aheadCurFrame = ahead.curFrame;
+
+	if (ahead.hasPalette) {
+		memcpy(_aheadPalette, ahead.palette, sizeof(_aheadPalette));
+		_palette = _aheadPalette;
+		_dirtyPalette = true;
+	}
+
+	return ahead.hasSurface ? &ahead.surface : 0;
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames decoded ahead are in the forward direction
+	if (reverse && _frameAhead)
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -230,6 +472,13 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	if (_frameAhead)
+		return _aheadCurFrame;
+
+	return getTrackCurFrame();
+}
+
+int VideoDecoder::getTrackCurFrame() const {
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -271,13 +520,31 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
+	uint32 nextFrameStartTime;
+	bool reversed;
+
+	if (_frameAhead) {
+		// Without a queued frame, the next one is late already
+		const int slot = peekAheadFrame();
+		if (slot < 0)
+			return 0;
+
+		nextFrameStartTime = _aheadFrames[slot].startTime;
+		reversed = false;
+	} else {
+		if (!_nextVideoTrack)
+			return 0;
+
+		nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+		reversed = _nextVideoTrack->isReversed();
+	}
+
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (reversed) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -296,6 +563,13 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
+		// The video tracks are ahead of what was shown
+		if (_frameAhead && track->getTrackType() == Track::kTrackTypeVideo) {
+			if (hasFramesLeft())
+				return false;
+			continue;
+		}
+
 		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
 		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
@@ -320,6 +594,8 @@ bool VideoDecoder::rewind() {
 	if (!isRewindable())
 		return false;
 
+	Common::StackLock lock(_aheadMutex);
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -328,6 +604,9 @@ bool VideoDecoder::rewind() {
 		if (!(*it)->rewind())
 			return false;
 
+	if (_frameAhead)
+		flushFrameAhead();
+
 	// Now that we've rewound, start all tracks again
 	if (isPlaying())
 		startAudio();
@@ -354,6 +633,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (!isSeekable())
 		return false;
 
+	Common::StackLock lock(_aheadMutex);
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -367,6 +648,9 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 		if (!(*it)->seek(time))
 			return false;
 
+	if (_frameAhead)
+		flushFrameAhead();
+
 	_lastTimeChange = time;
 
 	// Now that we've seeked, start all tracks again
@@ -439,6 +723,7 @@ void VideoDecoder::stop() {
 	_pauseLevel = 0;
 
 	// Reset the pause state of the tracks too
+	Common::StackLock lock(_aheadMutex);
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		(*it)->pause(false);
 }
@@ -761,10 +1046,12 @@ bool VideoDecoder::addStreamFileTrack(const Common::String &baseName) {
 
 	bool result = track->loadFromFile(baseName);
 
-	if (result)
+	if (result) {
+		Common::StackLock lock(_aheadMutex);
 		addTrack(track, true);
-	else
+	} else {
 		delete track;
+	}
 
 	return result;
 }
@@ -912,6 +1199,18 @@ void VideoDecoder::startAudioLimit(const Audio::Timestamp &limit) {
 }
 
 bool VideoDecoder::hasFramesLeft() const {
+	if (_frameAhead) {
+		// Check for the end before the queue: the timer thread queues the
+		// last frame before setting it.
+		const bool end = _aheadEnd;
+		Common::memoryBarrier();
+		return peekAheadFrame() >= 0 || !end;
+	}
+
+	return hasVideoFramesLeft();
+}
+
+bool VideoDecoder::hasVideoFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
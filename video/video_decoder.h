@@ -26,7 +26,9 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/mutex.h"
 #include "common/rational.h"
+#include "common/spscqueue.h"
 #include "common/str.h"
 #include "graphics/pixelformat.h"
 
@@ -52,7 +54,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -355,6 +357,31 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Decode frames ahead of time while the video is playing, keeping up to
+	 * the given number of decoded frames queued. Frames which take long to
+	 * decode then no longer delay their presentation.
+	 *
+	 * The frames are decoded from the timer thread, which is a separate
+	 * thread on most backends, and copied into surfaces allocated when
+	 * enabling this. The first frame is always decoded by decodeNextFrame()
+	 * itself. Seeking and rewinding drop the queued frames.
+	 *
+	 * While a frame is decoded, the other timer procs, like those of the
+	 * music drivers, have to wait. Engines should therefore leave this
+	 * disabled unless the user asks for it with "video_frame_ahead".
+	 *
+	 * Apart from the VideoDecoder functions, callers must not access the
+	 * decoder (e.g. format specific state like dirty rectangles) while this
+	 * is enabled. Reverse playback is not possible either.
+	 *
+	 * @note Closing the video disables this again.
+	 * @param frames	the number of frames to decode ahead, 0 to disable
+	 * @return true on success, false if the video is not loaded, is playing
+	 *         in reverse, or the decoder does not support this
+	 */
+	bool setFrameAhead(uint frames);
+
 	/**
 	 * Set the default high color format for videos that convert from YUV.
 	 *
@@ -817,6 +844,14 @@ protected:
 	 */
 	void resetPauseStartTime();
 
+	/**
+	 * Whether frames can be decoded ahead of time, see setFrameAhead().
+	 *
+	 * Subclasses overriding decodeNextFrame() to access their tracks after
+	 * calling this class' version must return false here.
+	 */
+	virtual bool supportsFrameAhead() const { return true; }
+
 	/**
 	 * Decode enough data for the next frame and enough audio to last that long.
 	 *
@@ -954,7 +989,47 @@ private:
 	void startAudio();
 	void startAudioLimit(const Audio::Timestamp &limit);
 	bool hasFramesLeft() const;
+	bool hasVideoFramesLeft() const;
 	bool hasAudio() const;
+	int getTrackCurFrame() const;
+	const Graphics::Surface *decodeFrameIntern(const byte *&palette);
+
+	// Frame-ahead decoding, see setFrameAhead()
+	enum {
+		kMaxFrameAhead = 8,
+		/** Microseconds between two attempts to decode a frame ahead */
+		kFrameAheadInterval = 4000
+	};
+
+	struct AheadFrame;
+
+	/** Free the queued frames, without repositioning the tracks */
+	void disableFrameAhead();
+	static void frameAheadProc(void *refCon);
+	static void registerFrameAhead(VideoDecoder *decoder, bool enable);
+
+	/** Decode the next frame into a free slot; _aheadMutex must be locked */
+	bool decodeAheadFrame();
+	/** Get the slot of the next queued frame, or -1 */
+	int peekAheadFrame() const;
+	/** Drop the queued frames after the tracks were repositioned */
+	void flushFrameAhead();
+	const Graphics::Surface *nextAheadFrame();
+
+	uint _frameAhead;
+	AheadFrame *_aheadFrames;
+	/** Slots with decoded frames, in presentation order */
+	Common::SPSCQueue<uint, 16> _aheadQueue;
+	/** Slots which are neither queued nor shown */
+	Common::SPSCQueue<uint, 16> _aheadFree;
+	/** Slot of the frame last returned by decodeNextFrame(), or -1 */
+	int _aheadShown;
+	int _aheadCurFrame;
+	/** Set once the tracks have no more frames to decode */
+	volatile bool _aheadEnd;
+	byte _aheadPalette[256 * 3];
+	/** Held while the tracks are accessed with frame-ahead decoding enabled */
+	Common::Mutex _aheadMutex;
 
 	int32 _startTime;
 	uint32 _pauseLevel;